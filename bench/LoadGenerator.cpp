@@ -0,0 +1,258 @@
+#include "LoadGenerator.h"
+#include "FormDefinition.h" // For currentSelectedForm
+#include "Entry.h"          // For EntryManager
+#include "EntryReader.h"    // For PartitionedEntryReader
+#include "MappedEntrySource.h" // For MappedEntrySource
+#include "SchemaMigration.h" // For SchemaMigration
+#include "BlockCompression.h" // For setCompressionEnabled
+#include "SaveAsCSV.h"
+#include "SaveAsJSON.h"
+#include "SaveAsSQL.h"
+#include "SaveAsColumnar.h"
+#include "SaveAsArrow.h"
+#include <iostream>
+#include <iomanip> // For std::setw, std::setprecision
+#include <random>
+#include <chrono>
+#include <algorithm> // For std::sort
+#include <cmath> // For std::ceil
+#include <sstream>
+#include <cstdlib> // For std::atoi
+#include <cstdio> // For std::fflush
+#include <fcntl.h> // For open
+#include <unistd.h> // For dup, dup2, close
+
+namespace {
+
+enum Operation { Add, Edit, Delete, View, Export, OperationCount };
+
+const char* const kOperationNames[OperationCount] = {"add", "edit", "delete", "view", "export"};
+
+// Discards everything printed while in scope. Views write their table straight to file
+// descriptor 1, so that is pointed at /dev/null as well as std::cout's buffer.
+class StdoutSilencer {
+private:
+    struct NullBuffer : public std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    } buffer;
+    std::streambuf* previous;
+    int savedFd;
+
+public:
+    StdoutSilencer() : previous(std::cout.rdbuf(&buffer)), savedFd(-1) {
+        std::fflush(stdout);
+        int nullFd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+        if (nullFd >= 0) {
+            savedFd = ::dup(STDOUT_FILENO);
+            ::dup2(nullFd, STDOUT_FILENO);
+            ::close(nullFd);
+        }
+    }
+
+    ~StdoutSilencer() {
+        std::fflush(stdout);
+        if (savedFd >= 0) {
+            ::dup2(savedFd, STDOUT_FILENO);
+            ::close(savedFd);
+        }
+        std::cout.rdbuf(previous);
+    }
+};
+
+using ExportFunction = void (*)(const std::string&, const std::shared_ptr<FormDefinition>&, EntrySource&);
+
+ExportFunction exporterFor(const std::string& format) {
+    if (format == "json") return static_cast<ExportFunction>(&saveAsJSON);
+    if (format == "sql") return static_cast<ExportFunction>(&saveAsSQL);
+    if (format == "cols") return static_cast<ExportFunction>(&saveAsColumnar);
+    if (format == "arrow") return static_cast<ExportFunction>(&saveAsArrow);
+    return static_cast<ExportFunction>(&saveAsCSV);
+}
+
+// Exports the way Save As does: from the mapped partition files when possible
+void runExport(ExportFunction exporter, const std::string& path, const std::shared_ptr<FormDefinition>& formDef) {
+    MappedEntrySource mapped(formDef->name, *formDef);
+    if (mapped.isUsable()) {
+        exporter(path, formDef, mapped);
+    } else {
+        PartitionedEntryReader reader(formDef->name, std::make_shared<SchemaMigration>(*formDef));
+        exporter(path, formDef, reader);
+    }
+}
+
+} // namespace
+
+bool WorkloadSpec::parseMix(const std::string& mix) {
+    std::stringstream ss(mix);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        std::string name = item.substr(0, eq);
+        int weight = std::atoi(item.c_str() + eq + 1);
+        if (name == "add") addWeight = weight;
+        else if (name == "edit") editWeight = weight;
+        else if (name == "delete") deleteWeight = weight;
+        else if (name == "view") viewWeight = weight;
+        else if (name == "export") exportWeight = weight;
+        else return false;
+    }
+    return true;
+}
+
+size_t WorkloadReport::totalOperations() const {
+    size_t total = 0;
+    for (const auto& operation : operations) {
+        total += operation.count;
+    }
+    return total;
+}
+
+double percentileOf(const std::vector<double>& sorted, double percent) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = (size_t)std::ceil(percent / 100.0 * sorted.size());
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+WorkloadReport runWorkload(const WorkloadSpec& spec) {
+    using Clock = std::chrono::steady_clock;
+    bool previousCompression = isCompressionEnabled();
+    setCompressionEnabled(spec.compression);
+
+    WorkloadReport report;
+    report.storageMode = spec.compression ? "lz4" : "plain";
+    std::string formName = "loadgen_" + report.storageMode;
+    auto formDef = makeSyntheticForm(formName, spec.form);
+    auto setupStart = Clock::now();
+    writeSyntheticForm(*formDef, spec.initialRows, spec.form);
+    EntryManager manager(formName, formDef);
+    std::atomic_store(&currentSelectedForm, formDef); // viewEntries renders the selected form
+    report.setupSeconds = std::chrono::duration<double>(Clock::now() - setupStart).count();
+
+    std::mt19937_64 rng(spec.seed);
+    std::discrete_distribution<int> pickOperation({(double)spec.addWeight, (double)spec.editWeight, (double)spec.deleteWeight,
+                                                   (double)spec.viewWeight, (double)spec.exportWeight});
+    std::uniform_int_distribution<int> percent(1, 100);
+    std::uniform_int_distribution<size_t> pickField(0, formDef->fields.empty() ? 0 : formDef->fields.size() - 1);
+    ExportFunction exporter = exporterFor(spec.exportFormat);
+    std::string exportPath = "Forms/" + formName + "_entries." + spec.exportFormat;
+
+    std::vector<double> latencies[OperationCount];
+    size_t rows = manager.getEntries()->size();
+    size_t generatedRows = spec.initialRows; // Next row index handed to the generator
+    auto phaseStart = Clock::now();
+    for (size_t i = 0; i < spec.operations; ++i) {
+        Operation operation = (Operation)pickOperation(rng);
+        if (rows == 0 && operation != Export) {
+            operation = Add; // Nothing to edit, delete or view yet
+        }
+
+        // Inputs are drawn before the clock starts so only the operation itself is timed
+        int key = rows > 0 ? std::uniform_int_distribution<int>(1, (int)rows)(rng) : 0;
+        std::map<std::string, FieldValue> data;
+        if (operation == Add || operation == Edit) {
+            data = makeSyntheticRows(*formDef, 1, spec.form, generatedRows++).front();
+            if (operation == Edit && !formDef->fields.empty()) {
+                const std::string& field = formDef->fields[pickField(rng)]->name;
+                data = {{field, data[field]}};
+            }
+        }
+        bool sorted = percent(rng) <= spec.sortedViewPercent;
+        std::string sortField = sorted && !formDef->fields.empty() ? formDef->fields[pickField(rng)]->name : "";
+        int pages = (int)((rows + spec.entriesPerPage - 1) / spec.entriesPerPage);
+        int page = pages > 0 ? std::uniform_int_distribution<int>(1, pages)(rng) : 1;
+
+        auto start = Clock::now();
+        switch (operation) {
+            case Add:
+                manager.insertEntry(data);
+                ++rows;
+                break;
+            case Edit:
+                manager.updateEntry(key, data);
+                break;
+            case Delete:
+                if (manager.removeEntry(key)) {
+                    --rows;
+                }
+                break;
+            case View: {
+                StdoutSilencer silencer;
+                manager.viewEntries(page, spec.entriesPerPage, sortField);
+                break;
+            }
+            case Export: {
+                StdoutSilencer silencer;
+                runExport(exporter, exportPath, formDef);
+                break;
+            }
+            case OperationCount:
+                break;
+        }
+        latencies[operation].push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    report.elapsedSeconds = std::chrono::duration<double>(Clock::now() - phaseStart).count();
+    report.finalRows = manager.getEntries()->size();
+
+    for (int operation = 0; operation < OperationCount; ++operation) {
+        std::vector<double>& samples = latencies[operation];
+        if (samples.empty()) {
+            continue;
+        }
+        std::sort(samples.begin(), samples.end());
+        OperationReport result;
+        result.name = kOperationNames[operation];
+        result.count = samples.size();
+        double totalMicros = 0;
+        for (double sample : samples) {
+            totalMicros += sample;
+        }
+        result.totalSeconds = totalMicros / 1e6;
+        result.meanMicros = totalMicros / samples.size();
+        result.p50Micros = percentileOf(samples, 50);
+        result.p90Micros = percentileOf(samples, 90);
+        result.p99Micros = percentileOf(samples, 99);
+        result.p999Micros = percentileOf(samples, 99.9);
+        result.maxMicros = samples.back();
+        report.operations.push_back(result);
+    }
+
+    setCompressionEnabled(previousCompression);
+    return report;
+}
+
+void printReport(std::ostream& out, const WorkloadReport& report) {
+    std::ios savedFormat(nullptr);
+    savedFormat.copyfmt(out);
+    out << "--- Storage mode: " << report.storageMode << " ---\n";
+    out << std::fixed << std::setprecision(1);
+    out << "Setup " << report.setupSeconds * 1000 << " ms, " << report.totalOperations() << " operations in "
+        << report.elapsedSeconds * 1000 << " ms (" << (report.elapsedSeconds > 0 ? report.totalOperations() / report.elapsedSeconds : 0)
+        << " ops/s), " << report.finalRows << " rows at the end\n";
+    out << std::left << std::setw(8) << "op" << std::right << std::setw(8) << "count" << std::setw(12) << "ops/s"
+        << std::setw(11) << "mean us" << std::setw(11) << "p50 us" << std::setw(11) << "p90 us" << std::setw(11) << "p99 us"
+        << std::setw(11) << "p99.9 us" << std::setw(11) << "max us" << "\n";
+    for (const auto& operation : report.operations) {
+        out << std::left << std::setw(8) << operation.name << std::right << std::setw(8) << operation.count
+            << std::setw(12) << operation.opsPerSecond() << std::setw(11) << operation.meanMicros
+            << std::setw(11) << operation.p50Micros << std::setw(11) << operation.p90Micros << std::setw(11) << operation.p99Micros
+            << std::setw(11) << operation.p999Micros << std::setw(11) << operation.maxMicros << "\n";
+    }
+    out.copyfmt(savedFormat);
+}
+
+void writeReportCsv(std::ostream& out, const WorkloadReport& report, bool header) {
+    if (header) {
+        out << "mode,operation,count,ops_per_s,mean_us,p50_us,p90_us,p99_us,p999_us,max_us\n";
+    }
+    for (const auto& operation : report.operations) {
+        out << report.storageMode << "," << operation.name << "," << operation.count << "," << operation.opsPerSecond() << ","
+            << operation.meanMicros << "," << operation.p50Micros << "," << operation.p90Micros << ","
+            << operation.p99Micros << "," << operation.p999Micros << "," << operation.maxMicros << "\n";
+    }
+}
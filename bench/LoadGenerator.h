@@ -0,0 +1,70 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <iosfwd> // For std::ostream
+#include <cstdint>
+#include "SyntheticData.h" // For SyntheticFormSpec
+
+// End-to-end workload: a synthetic form is created with 'initialRows' rows, then 'operations'
+// operations are drawn from the weighted mix and run one after another through EntryManager,
+// persisting as the app does. The same spec always produces the same operation sequence.
+struct WorkloadSpec {
+    SyntheticFormSpec form;
+    size_t initialRows = 10000;
+    size_t operations = 10000;
+
+    // Relative weights of the operation kinds
+    int addWeight = 40;
+    int editWeight = 30;
+    int deleteWeight = 5;
+    int viewWeight = 20;
+    int exportWeight = 5;
+
+    int entriesPerPage = 20; // Rows rendered by a view
+    int sortedViewPercent = 50; // Views that sort by a random field instead of by key
+    std::string exportFormat = "csv"; // csv, json, sql, cols or arrow
+    bool compression = false; // Storage mode: LZ4 compressed partitions and exports
+    uint64_t seed = 42; // Operation sequence; the form's own seed is form.seed
+
+    // Parses "add=40,edit=30,delete=5,view=20,export=5"; returns false on an unknown operation
+    bool parseMix(const std::string& mix);
+};
+
+struct OperationReport {
+    std::string name;
+    size_t count = 0;
+    double totalSeconds = 0; // Time spent in this operation only
+    double meanMicros = 0;
+    double p50Micros = 0;
+    double p90Micros = 0;
+    double p99Micros = 0;
+    double p999Micros = 0;
+    double maxMicros = 0;
+
+    double opsPerSecond() const { return totalSeconds > 0 ? count / totalSeconds : 0; }
+};
+
+struct WorkloadReport {
+    std::string storageMode;
+    size_t finalRows = 0;
+    double setupSeconds = 0; // Generating and persisting the initial rows
+    double elapsedSeconds = 0; // Wall time of the operation phase
+    std::vector<OperationReport> operations; // In mix order; kinds that never ran are omitted
+
+    size_t totalOperations() const;
+};
+
+// Runs the workload in the current directory, which must contain a Forms/ folder
+WorkloadReport runWorkload(const WorkloadSpec& spec);
+
+// Nearest-rank percentile of sorted latencies, 'percent' in [0, 100]
+double percentileOf(const std::vector<double>& sorted, double percent);
+
+void printReport(std::ostream& out, const WorkloadReport& report);
+
+// One line per operation: mode,operation,count,ops_per_s,mean_us,p50_us,p90_us,p99_us,p999_us,max_us
+void writeReportCsv(std::ostream& out, const WorkloadReport& report, bool header);
+
+#endif // LOAD_GENERATOR_H
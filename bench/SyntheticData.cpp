@@ -0,0 +1,126 @@
+#include "SyntheticData.h"
+#include "Entry.h" // For EntryManager
+#include <fstream>
+#include <random>
+#include <filesystem> // For std::filesystem::remove_all
+#include <algorithm> // For std::min, std::max
+#include <sstream>
+#include <cstdlib> // For std::atoi
+
+namespace {
+
+const size_t kImportChunkRows = 1000000; // Bounds generator memory for the 10M row sets
+const int64_t kTimestampRangeStart = 1577836800000LL; // 2020-01-01T00:00:00Z
+const int64_t kTimestampRangeMillis = 5LL * 365 * 24 * 3600 * 1000;
+
+std::string randomText(std::mt19937_64& rng, size_t minLength, size_t maxLength) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz      ";
+    std::uniform_int_distribution<size_t> lengthDist(minLength, std::max(minLength, maxLength));
+    std::uniform_int_distribution<size_t> charDist(0, sizeof(alphabet) - 2);
+    std::string text(lengthDist(rng), ' ');
+    for (char& c : text) {
+        c = alphabet[charDist(rng)];
+    }
+    return text;
+}
+
+} // namespace
+
+bool parseFieldMix(const std::string& mix, SyntheticFormSpec& spec) {
+    std::stringstream ss(mix);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            return false;
+        }
+        std::string kind = item.substr(0, eq);
+        int count = std::atoi(item.c_str() + eq + 1);
+        if (kind == "s") spec.stringFields = count;
+        else if (kind == "i") spec.intFields = count;
+        else if (kind == "f") spec.floatFields = count;
+        else if (kind == "d") spec.doubleFields = count;
+        else if (kind == "sel") spec.selectFields = count;
+        else if (kind == "t") spec.timestampFields = count;
+        else return false;
+    }
+    return true;
+}
+
+std::shared_ptr<FormDefinition> makeSyntheticForm(const std::string& formName, const SyntheticFormSpec& spec) {
+    auto formDef = std::make_shared<FormDefinition>();
+    formDef->name = formName;
+    for (int i = 0; i < spec.stringFields; ++i) {
+        formDef->fields.push_back(std::make_shared<StringField>("s" + std::to_string(i)));
+    }
+    for (int i = 0; i < spec.intFields; ++i) {
+        formDef->fields.push_back(std::make_shared<NumberField>("i" + std::to_string(i), "int"));
+    }
+    for (int i = 0; i < spec.floatFields; ++i) {
+        formDef->fields.push_back(std::make_shared<NumberField>("f" + std::to_string(i), "float"));
+    }
+    for (int i = 0; i < spec.doubleFields; ++i) {
+        formDef->fields.push_back(std::make_shared<NumberField>("d" + std::to_string(i), "double"));
+    }
+    for (int i = 0; i < spec.selectFields; ++i) {
+        auto selectField = std::make_shared<SelectField>("sel" + std::to_string(i));
+        for (int option = 1; option <= spec.selectOptions; ++option) {
+            selectField->options[option] = "option " + std::to_string(option);
+        }
+        formDef->fields.push_back(selectField);
+    }
+    for (int i = 0; i < spec.timestampFields; ++i) {
+        formDef->fields.push_back(std::make_shared<TimestampField>("t" + std::to_string(i)));
+    }
+    return formDef;
+}
+
+std::vector<SyntheticRow> makeSyntheticRows(const FormDefinition& formDef, size_t rowCount, const SyntheticFormSpec& spec, size_t firstRow) {
+    std::vector<SyntheticRow> rows;
+    rows.reserve(rowCount);
+    std::uniform_int_distribution<int> intDist(-1000000, 1000000);
+    std::uniform_real_distribution<double> realDist(-1e6, 1e6);
+    std::uniform_int_distribution<int64_t> timeDist(kTimestampRangeStart, kTimestampRangeStart + kTimestampRangeMillis);
+
+    for (size_t row = 0; row < rowCount; ++row) {
+        // Seeding per row keeps chunked generation identical to a single pass
+        std::mt19937_64 rng(spec.seed * 0x9E3779B97F4A7C15ULL + firstRow + row);
+        SyntheticRow data;
+        for (const auto& field : formDef.fields) {
+            if (field->type == "string") {
+                data[field->name] = randomText(rng, spec.minStringLength, spec.maxStringLength);
+            } else if (field->type == "number") {
+                auto numField = std::static_pointer_cast<NumberField>(field);
+                if (numField->numberType == "int") {
+                    data[field->name] = intDist(rng);
+                } else if (numField->numberType == "float") {
+                    data[field->name] = static_cast<float>(realDist(rng));
+                } else {
+                    data[field->name] = realDist(rng);
+                }
+            } else if (field->type == "select") {
+                auto selectField = std::static_pointer_cast<SelectField>(field);
+                std::uniform_int_distribution<int> optionDist(1, (int)selectField->options.size());
+                data[field->name] = selectField->options.at(optionDist(rng));
+            } else if (field->type == "timestamp") {
+                data[field->name] = Timestamp{timeDist(rng)};
+            }
+        }
+        rows.push_back(std::move(data));
+    }
+    return rows;
+}
+
+void writeSyntheticForm(const FormDefinition& formDef, size_t rowCount, const SyntheticFormSpec& spec) {
+    std::ofstream formFile("Forms/" + formDef.name + ".form");
+    formDef.saveToStream(formFile);
+    formFile.close();
+
+    std::error_code ec;
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(formDef.name), ec);
+    EntryManager manager(formDef.name);
+    for (size_t firstRow = 0; firstRow < rowCount; firstRow += kImportChunkRows) {
+        size_t chunk = std::min(kImportChunkRows, rowCount - firstRow);
+        manager.importEntries(makeSyntheticRows(formDef, chunk, spec, firstRow));
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SYNTHETIC_DATA_H
+#define SYNTHETIC_DATA_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // For std::shared_ptr
+#include <cstdint>
+#include "FormDefinition.h" // For FormDefinition struct
+#include "FieldValue.h" // For FieldValue
+
+// Shape of a generated form; the same spec and seed always produce the same data
+struct SyntheticFormSpec {
+    int stringFields = 2;
+    int intFields = 1;
+    int floatFields = 0;
+    int doubleFields = 1;
+    int selectFields = 1;
+    int selectOptions = 4;
+    int timestampFields = 0;
+    size_t minStringLength = 8;
+    size_t maxStringLength = 32;
+    uint64_t seed = 42;
+};
+
+using SyntheticRow = std::map<std::string, FieldValue>;
+
+// Applies a field mix such as "s=2,i=1,f=0,d=1,sel=1,t=1" to 'spec'; returns false on an unknown kind
+bool parseFieldMix(const std::string& mix, SyntheticFormSpec& spec);
+
+// Builds a form definition with the requested field mix (fields are named s0, i0, f0, d0, sel0, t0, ...)
+std::shared_ptr<FormDefinition> makeSyntheticForm(const std::string& formName, const SyntheticFormSpec& spec);
+
+// Generates rows matching the form; 'firstRow' lets callers produce a large set in reproducible chunks
+std::vector<SyntheticRow> makeSyntheticRows(const FormDefinition& formDef, size_t rowCount, const SyntheticFormSpec& spec, size_t firstRow = 0);
+
+// Writes Forms/<name>.form and an entries file with 'rowCount' rows under the current directory
+void writeSyntheticForm(const FormDefinition& formDef, size_t rowCount, const SyntheticFormSpec& spec);
+
+#endif // SYNTHETIC_DATA_H
@@ -0,0 +1,225 @@
+#include <benchmark/benchmark.h>
+#include "SyntheticData.h"
+#include "FormDefinition.h" // For currentSelectedForm
+#include "Entry.h"          // For EntryManager
+#include "PartitionStore.h" // For PartitionManifest
+#include "EntryReader.h"    // For SnapshotEntrySource
+#include "SaveAsCSV.h"
+#include "SaveAsJSON.h"
+#include "SaveAsSQL.h"
+#include <iostream>
+#include <filesystem>
+#include <map>
+#include <cstdlib> // For std::getenv
+#include <unistd.h> // For getpid
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Row counts benchmarked by default are capped by TODOAPP_BENCH_MAX_ROWS
+const size_t kRowCounts[] = {1000, 10000, 100000, 1000000, 10000000};
+const size_t kDefaultMaxRows = 100000;
+
+SyntheticFormSpec benchSpec;
+
+// Counts and discards everything written through it
+class CountingBuffer : public std::streambuf {
+public:
+    size_t count = 0;
+
+protected:
+    int overflow(int c) override {
+        ++count;
+        return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        count += n;
+        return n;
+    }
+};
+
+// Redirects std::cout into a CountingBuffer while in scope
+class CoutSilencer {
+private:
+    std::streambuf* previous;
+
+public:
+    CountingBuffer buffer;
+
+    CoutSilencer() : previous(std::cout.rdbuf(&buffer)) {}
+    ~CoutSilencer() { std::cout.rdbuf(previous); }
+};
+
+uintmax_t fileSizeOrZero(const std::string& path) {
+    std::error_code ec;
+    uintmax_t size = fs::file_size(path, ec);
+    return ec ? 0 : size;
+}
+
+// Bytes of all partition files stored for a form
+uintmax_t storedBytes(const std::string& formName) {
+    PartitionManifest manifest;
+    manifest.loadFromFile(PartitionStore::manifestPathFor(formName));
+    uintmax_t bytes = 0;
+    for (const auto& part : manifest.partitions) {
+        bytes += part.bytes;
+    }
+    return bytes;
+}
+
+// Generates each synthetic form once and reuses it across benchmarks
+std::shared_ptr<FormDefinition> ensureForm(const std::string& formName, size_t rows) {
+    static std::map<std::string, std::shared_ptr<FormDefinition>> cache;
+    auto it = cache.find(formName);
+    if (it != cache.end()) {
+        return it->second;
+    }
+    auto formDef = makeSyntheticForm(formName, benchSpec);
+    writeSyntheticForm(*formDef, rows, benchSpec);
+    cache[formName] = formDef;
+    return formDef;
+}
+
+std::string readFormName(size_t rows) {
+    return "bench_" + std::to_string(rows);
+}
+
+void BM_LoadEntries(benchmark::State& state, size_t rows) {
+    auto formDef = ensureForm(readFormName(rows), rows);
+    for (auto _ : state) {
+        EntryManager manager(formDef->name);
+        benchmark::DoNotOptimize(manager.getEntries()->size());
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * storedBytes(formDef->name));
+}
+
+void BM_SaveEntries(benchmark::State& state, size_t rows) {
+    auto formDef = ensureForm(readFormName(rows), rows);
+    EntryManager manager(formDef->name);
+    for (auto _ : state) {
+        manager.persist(true); // Full rewrite; single-row saves are covered by BM_UpdateEntry
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * storedBytes(formDef->name));
+}
+
+void BM_ViewEntries(benchmark::State& state, size_t rows) {
+    auto formDef = ensureForm(readFormName(rows), rows);
+    EntryManager manager(formDef->name);
+    std::atomic_store(&currentSelectedForm, formDef);
+
+    const int entriesPerPage = 5;
+    int totalPages = (int)((rows + entriesPerPage - 1) / entriesPerPage);
+    int page = 1;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        CoutSilencer silencer;
+        manager.viewEntries(page, entriesPerPage);
+        page = (page - 1 + 7919) % totalPages + 1; // Stride across the whole form
+        bytes += silencer.buffer.count;
+    }
+    state.SetItemsProcessed(state.iterations() * entriesPerPage);
+    state.SetBytesProcessed(bytes);
+}
+
+void BM_InsertEntry(benchmark::State& state, size_t rows) {
+    // Mutations get their own form so the read benchmarks keep a fixed size
+    std::string formName = "bench_mutate_" + std::to_string(rows);
+    auto formDef = makeSyntheticForm(formName, benchSpec);
+    writeSyntheticForm(*formDef, rows, benchSpec);
+    EntryManager manager(formName);
+    auto extraRows = makeSyntheticRows(*formDef, 64, benchSpec, rows);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        manager.insertEntry(extraRows[next++ % extraRows.size()]);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * storedBytes(formName));
+}
+
+void BM_UpdateEntry(benchmark::State& state, size_t rows) {
+    std::string formName = "bench_mutate_" + std::to_string(rows);
+    auto formDef = makeSyntheticForm(formName, benchSpec);
+    writeSyntheticForm(*formDef, rows, benchSpec);
+    EntryManager manager(formName);
+    auto changes = makeSyntheticRows(*formDef, 64, benchSpec, rows);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        int key = (int)((next * 2654435761u) % rows) + 1;
+        manager.updateEntry(key, changes[next++ % changes.size()]);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * storedBytes(formName));
+}
+
+using ExportFunction = void (*)(const std::string&, const std::shared_ptr<FormDefinition>&, EntrySource&);
+
+void BM_Export(benchmark::State& state, size_t rows, ExportFunction exporter, const std::string& extension) {
+    auto formDef = ensureForm(readFormName(rows), rows);
+    EntryManager manager(formDef->name);
+    std::string outputPath = "Forms/bench_export." + extension;
+    for (auto _ : state) {
+        CoutSilencer silencer;
+        SnapshotEntrySource source(manager.getEntries());
+        exporter(outputPath, formDef, source);
+    }
+    state.SetItemsProcessed(state.iterations() * rows);
+    state.SetBytesProcessed(state.iterations() * fileSizeOrZero(outputPath));
+}
+
+size_t envSize(const char* name, size_t fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+void registerBenchmarks(size_t maxRows) {
+    for (size_t rows : kRowCounts) {
+        if (rows > maxRows) {
+            break;
+        }
+        std::string suffix = "/" + std::to_string(rows);
+        auto unit = rows >= 100000 ? benchmark::kMillisecond : benchmark::kMicrosecond;
+        benchmark::RegisterBenchmark(("BM_LoadEntries" + suffix).c_str(), BM_LoadEntries, rows)->Unit(unit);
+        benchmark::RegisterBenchmark(("BM_SaveEntries" + suffix).c_str(), BM_SaveEntries, rows)->Unit(unit);
+        benchmark::RegisterBenchmark(("BM_ViewEntries" + suffix).c_str(), BM_ViewEntries, rows);
+        benchmark::RegisterBenchmark(("BM_InsertEntry" + suffix).c_str(), BM_InsertEntry, rows)->Unit(unit);
+        benchmark::RegisterBenchmark(("BM_UpdateEntry" + suffix).c_str(), BM_UpdateEntry, rows)->Unit(unit);
+        benchmark::RegisterBenchmark(("BM_ExportCSV" + suffix).c_str(), BM_Export, rows, static_cast<ExportFunction>(&saveAsCSV), std::string("csv"))->Unit(unit);
+        benchmark::RegisterBenchmark(("BM_ExportJSON" + suffix).c_str(), BM_Export, rows, static_cast<ExportFunction>(&saveAsJSON), std::string("json"))->Unit(unit);
+        benchmark::RegisterBenchmark(("BM_ExportSQL" + suffix).c_str(), BM_Export, rows, static_cast<ExportFunction>(&saveAsSQL), std::string("sql"))->Unit(unit);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // TODOAPP_BENCH_FIELDS="s=2,i=1,f=0,d=1,sel=1,t=0" overrides the field mix
+    if (const char* mix = std::getenv("TODOAPP_BENCH_FIELDS")) {
+        if (!parseFieldMix(mix, benchSpec)) {
+            std::cerr << "Warning: Ignoring part of TODOAPP_BENCH_FIELDS=" << mix << "\n";
+        }
+    }
+    benchSpec.minStringLength = envSize("TODOAPP_BENCH_MIN_STRLEN", benchSpec.minStringLength);
+    benchSpec.maxStringLength = envSize("TODOAPP_BENCH_MAX_STRLEN", benchSpec.maxStringLength);
+    benchSpec.seed = envSize("TODOAPP_BENCH_SEED", benchSpec.seed);
+
+    // Everything runs inside a scratch directory with its own Forms/ folder
+    fs::path workDir = fs::temp_directory_path() / ("todoapp_bench_" + std::to_string(getpid()));
+    fs::create_directories(workDir / "Forms");
+    fs::path originalDir = fs::current_path();
+    fs::current_path(workDir);
+
+    registerBenchmarks(envSize("TODOAPP_BENCH_MAX_ROWS", kDefaultMaxRows));
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    fs::current_path(originalDir);
+    std::error_code ec;
+    fs::remove_all(workDir, ec);
+    return 0;
+}
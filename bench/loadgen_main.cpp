@@ -0,0 +1,111 @@
+#include "LoadGenerator.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <algorithm> // For std::max
+#include <cstdlib> // For std::strtoull, std::atoi
+#include <unistd.h> // For getpid
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: loadgen [options]\n"
+              << "  --rows N              rows in the form before the run (default 10000)\n"
+              << "  --ops N               operations to run (default 10000)\n"
+              << "  --mix SPEC            operation weights, e.g. add=40,edit=30,delete=5,view=20,export=5\n"
+              << "  --fields SPEC         field mix, e.g. s=2,i=1,f=0,d=1,sel=1,t=0\n"
+              << "  --seed N              seed for the operation sequence and the data (default 42)\n"
+              << "  --page N              rows per viewed page (default 20)\n"
+              << "  --sorted-views P      percent of views sorted by a random field (default 50)\n"
+              << "  --export FORMAT       csv, json, sql, cols or arrow (default csv)\n"
+              << "  --storage MODE        plain, lz4 or both (default plain)\n"
+              << "  --csv PATH            also write the results as CSV\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    WorkloadSpec spec;
+    std::string storage = "plain";
+    std::string csvPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Missing value for " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        bool valid = true;
+        if (arg == "--rows") spec.initialRows = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--ops") spec.operations = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--mix") valid = spec.parseMix(value);
+        else if (arg == "--fields") valid = parseFieldMix(value, spec.form);
+        else if (arg == "--seed") spec.seed = spec.form.seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--page") spec.entriesPerPage = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--sorted-views") spec.sortedViewPercent = std::atoi(value.c_str());
+        else if (arg == "--export") {
+            spec.exportFormat = value;
+            valid = value == "csv" || value == "json" || value == "sql" || value == "cols" || value == "arrow";
+        } else if (arg == "--storage") {
+            storage = value;
+            valid = value == "plain" || value == "lz4" || value == "both";
+        } else if (arg == "--csv") csvPath = value;
+        else {
+            std::cerr << "Error: Unknown option " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+        if (!valid) {
+            std::cerr << "Error: Invalid value '" << value << "' for " << arg << "\n";
+            return 1;
+        }
+    }
+    if (spec.addWeight + spec.editWeight + spec.deleteWeight + spec.viewWeight + spec.exportWeight <= 0) {
+        std::cerr << "Error: The operation mix needs at least one positive weight\n";
+        return 1;
+    }
+
+    std::vector<bool> modes; // Compression on or off
+    if (storage != "lz4") modes.push_back(false);
+    if (storage != "plain") modes.push_back(true);
+
+    // Everything runs inside a scratch directory with its own Forms/ folder
+    fs::path originalDir = fs::current_path();
+    if (!csvPath.empty()) {
+        csvPath = fs::absolute(csvPath).string();
+    }
+    fs::path workDir = fs::temp_directory_path() / ("todoapp_loadgen_" + std::to_string(getpid()));
+    fs::create_directories(workDir / "Forms");
+    fs::current_path(workDir);
+
+    std::vector<WorkloadReport> reports;
+    for (bool compression : modes) {
+        spec.compression = compression;
+        reports.push_back(runWorkload(spec));
+        printReport(std::cout, reports.back());
+    }
+
+    fs::current_path(originalDir);
+    std::error_code ec;
+    fs::remove_all(workDir, ec);
+
+    if (!csvPath.empty()) {
+        std::ofstream csvFile(csvPath);
+        if (!csvFile) {
+            std::cerr << "Error: Could not open " << csvPath << " for writing\n";
+            return 1;
+        }
+        for (size_t i = 0; i < reports.size(); ++i) {
+            writeReportCsv(csvFile, reports[i], i == 0);
+        }
+    }
+    return 0;
+}
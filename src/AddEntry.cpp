@@ -1,20 +1,18 @@
 #include "AddEntry.h"
-#include "FormDefinition.h" // For currentSelectedForm
+#include "FormDefinition.h" // For FormDefinition
 #include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For acquireSelectedManager
 #include <iostream>
 
-extern std::unique_ptr<EntryManager> currentEntryManager; // Declare extern
-
 void addEntry() {
-    if (!currentSelectedForm) {
-        std::cout << "No form is currently selected. Please select a form first (Option 3).\n";
+    std::shared_ptr<FormDefinition> selectedForm;
+    auto manager = acquireSelectedManager(selectedForm);
+    if (!manager) {
         return;
     }
 
-    // If the form changes, or if it's the first time, create/recreate the EntryManager
-    if (!currentEntryManager || currentEntryManager->getFormName() != currentSelectedForm->name) {
-        currentEntryManager = std::make_unique<EntryManager>(currentSelectedForm->name);
+    if (std::cin.peek() == '\n') {
+        std::cin.ignore(); // Drop the newline left by the menu choice, or the first string field reads empty
     }
-
-    currentEntryManager->addEntry(currentSelectedForm);
+    manager->addEntry(selectedForm);
 }
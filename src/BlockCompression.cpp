@@ -0,0 +1,494 @@
+#include "BlockCompression.h"
+#include "Instrumentation.h" // For TRACE_SCOPE, recordCounter
+#include <cstring> // For std::memcpy
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional> // For std::function
+#include <algorithm> // For std::min, std::max
+
+std::atomic<bool> compressionEnabled(false);
+
+void setCompressionEnabled(bool enabled) {
+    compressionEnabled = enabled;
+}
+
+namespace {
+
+const uint32_t kFrameMagic = 0x184D2204;
+const uint32_t kUncompressedBlockFlag = 0x80000000;
+const size_t kMinMatch = 4;
+const size_t kLastLiterals = 5; // The last 5 bytes of a block are always literals
+const size_t kMatchFindLimit = 12; // The last match must start at least 12 bytes before the end
+const size_t kMaxOffset = 65535;
+const int kHashBits = 14;
+
+uint32_t read32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t readLittleEndian32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void appendLittleEndian32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back((char)((value >> (8 * i)) & 0xFF));
+    }
+}
+
+uint32_t rotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// xxHash32 with seed 0, for inputs shorter than 16 bytes (the frame descriptor checksum)
+uint32_t shortXxHash32(const unsigned char* data, size_t size) {
+    const uint32_t prime1 = 2654435761U, prime2 = 2246822519U, prime3 = 3266489917U, prime4 = 668265263U, prime5 = 374761393U;
+    uint32_t hash = prime5 + (uint32_t)size;
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        hash = rotateLeft(hash + readLittleEndian32(data + i) * prime3, 17) * prime4;
+    }
+    for (; i < size; ++i) {
+        hash = rotateLeft(hash + data[i] * prime5, 11) * prime1;
+    }
+    hash ^= hash >> 15;
+    hash *= prime2;
+    hash ^= hash >> 13;
+    hash *= prime3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+unsigned char descriptorChecksum(const unsigned char* descriptor, size_t size) {
+    return (unsigned char)((shortXxHash32(descriptor, size) >> 8) & 0xFF);
+}
+
+void appendLength(std::string& out, size_t length) {
+    while (length >= 255) {
+        out.push_back((char)255);
+        length -= 255;
+    }
+    out.push_back((char)length);
+}
+
+// One LZ4 sequence: literals, then a match of 'matchLength' bytes at 'offset' back (none for the last sequence)
+void appendSequence(std::string& out, const char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+    out.push_back((char)((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        appendLength(out, literalLength - 15);
+    }
+    out.append(literals, literalLength);
+    if (matchLength) {
+        out.push_back((char)(offset & 0xFF));
+        out.push_back((char)(offset >> 8));
+        if (matchCode >= 15) {
+            appendLength(out, matchCode - 15);
+        }
+    }
+}
+
+// A fixed set of threads shared by every compressing stream
+class WorkerPool {
+private:
+    struct Batch {
+        const std::function<void(size_t)>* job;
+        size_t count;
+        std::atomic<size_t> nextIndex{0};
+        size_t pending; // Guarded by mutex
+    };
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable batchDone;
+    std::shared_ptr<Batch> current; // Guarded by mutex
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void runJobs(const std::shared_ptr<Batch>& batch) {
+        for (size_t i = batch->nextIndex++; i < batch->count; i = batch->nextIndex++) {
+            (*batch->job)(i);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--batch->pending == 0) {
+                batchDone.notify_all();
+            }
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            std::shared_ptr<Batch> batch = current; // A late worker only finds an exhausted batch
+            lock.unlock();
+            runJobs(batch);
+            lock.lock();
+        }
+    }
+
+public:
+    explicit WorkerPool(unsigned threadCount) {
+        for (unsigned i = 0; i < threadCount; ++i) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    size_t size() const { return threads.size() + 1; }
+
+    // Runs job(0) .. job(count - 1) on the pool and the calling thread; returns when all are done
+    void parallelFor(size_t count, const std::function<void(size_t)>& job) {
+        auto batch = std::make_shared<Batch>();
+        batch->job = &job;
+        batch->count = count;
+        batch->pending = count;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batchDone.wait(lock, [this] { return !current; }); // One batch at a time
+            current = batch;
+            ++generation;
+        }
+        wake.notify_all();
+        runJobs(batch);
+        std::unique_lock<std::mutex> lock(mutex);
+        batchDone.wait(lock, [&] { return batch->pending == 0; });
+        current.reset();
+        batchDone.notify_all();
+    }
+};
+
+WorkerPool& compressionPool() {
+    static WorkerPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+} // namespace
+
+bool compressLz4Block(const char* source, size_t size, std::string& out) {
+    out.clear();
+    out.reserve(size);
+    size_t anchor = 0;
+    if (size > kMatchFindLimit) {
+        std::vector<uint32_t> table(1 << kHashBits, 0); // Position + 1 of the last 4-byte sequence with each hash
+        const size_t matchLimit = size - kLastLiterals;
+        const size_t findLimit = size - kMatchFindLimit;
+        size_t ip = 0;
+        while (ip < findLimit) {
+            uint32_t sequence = read32(source + ip);
+            uint32_t hash = (sequence * 2654435761U) >> (32 - kHashBits);
+            size_t candidate = table[hash];
+            table[hash] = (uint32_t)(ip + 1);
+            if (candidate == 0 || ip - (candidate - 1) > kMaxOffset || read32(source + candidate - 1) != sequence) {
+                ip += 1 + ((ip - anchor) >> 6); // Skip faster through data that does not compress
+                continue;
+            }
+
+            size_t ref = candidate - 1;
+            size_t length = kMinMatch;
+            while (ip + length < matchLimit && source[ref + length] == source[ip + length]) {
+                ++length;
+            }
+            while (ip > anchor && ref > 0 && source[ip - 1] == source[ref - 1]) {
+                --ip;
+                --ref;
+                ++length;
+            }
+            appendSequence(out, source + anchor, ip - anchor, ip - ref, length);
+            ip += length;
+            anchor = ip;
+            if (out.size() >= size) {
+                return false;
+            }
+        }
+    }
+    appendSequence(out, source + anchor, size - anchor, 0, 0);
+    return out.size() < size;
+}
+
+bool decompressLz4Block(const char* source, size_t size, char* destination, size_t capacity, size_t& produced) {
+    const unsigned char* ip = (const unsigned char*)source;
+    const unsigned char* end = ip + size;
+    size_t op = 0;
+    while (ip < end) {
+        unsigned token = *ip++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            unsigned char more;
+            do {
+                if (ip >= end) {
+                    return false;
+                }
+                more = *ip++;
+                literalLength += more;
+            } while (more == 255);
+        }
+        if (literalLength > (size_t)(end - ip) || literalLength > capacity - op) {
+            return false;
+        }
+        std::memcpy(destination + op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+        if (ip == end) {
+            break; // The last sequence has no match
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) {
+            return false;
+        }
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            unsigned char more;
+            do {
+                if (ip >= end) {
+                    return false;
+                }
+                more = *ip++;
+                matchLength += more;
+            } while (more == 255);
+        }
+        matchLength += kMinMatch;
+        if (matchLength > capacity - op) {
+            return false;
+        }
+        if (offset >= matchLength) {
+            std::memcpy(destination + op, destination + op - offset, matchLength);
+        } else {
+            for (size_t i = 0; i < matchLength; ++i) { // Overlapping copy repeats the last 'offset' bytes
+                destination[op + i] = destination[op + i - offset];
+            }
+        }
+        op += matchLength;
+    }
+    produced = op;
+    return true;
+}
+
+bool isCompressedFile(const std::string& path) {
+    std::ifstream inFile(path, std::ios::binary);
+    unsigned char magic[4];
+    return inFile.read((char*)magic, sizeof(magic)) && readLittleEndian32(magic) == kFrameMagic;
+}
+
+Lz4FrameWriteBuf::Lz4FrameWriteBuf(std::ostream& sink)
+    : sink(sink), batchBytes(kCompressionBlockSize * std::max<size_t>(2, 2 * compressionPool().size())),
+      headerWritten(false), failed(false) {
+    pending.resize(batchBytes);
+    setp(&pending[0], &pending[0] + batchBytes);
+}
+
+bool Lz4FrameWriteBuf::writeHeader() {
+    // FLG: version 01, independent blocks, no checksums or content size; BD: 256 KiB maximum block size
+    unsigned char descriptor[2] = {0x60, 0x50};
+    std::string header;
+    appendLittleEndian32(header, kFrameMagic);
+    header.append((const char*)descriptor, sizeof(descriptor));
+    header.push_back((char)descriptorChecksum(descriptor, sizeof(descriptor)));
+    headerWritten = true;
+    return (bool)sink.write(header.data(), header.size());
+}
+
+bool Lz4FrameWriteBuf::flushBatch() {
+    TRACE_SCOPE("Lz4FrameWriteBuf::flushBatch");
+    size_t used = pptr() - pbase();
+    if (!headerWritten && !writeHeader()) {
+        failed = true;
+    }
+    size_t blockCount = (used + kCompressionBlockSize - 1) / kCompressionBlockSize;
+    std::vector<std::string> blocks(blockCount);
+    std::vector<char> compressed(blockCount, 0);
+    std::function<void(size_t)> compressOne = [&](size_t i) {
+        size_t begin = i * kCompressionBlockSize;
+        compressed[i] = compressLz4Block(pbase() + begin, std::min(kCompressionBlockSize, used - begin), blocks[i]);
+    };
+    compressionPool().parallelFor(blockCount, compressOne);
+
+    std::string sizeField;
+    for (size_t i = 0; i < blockCount && !failed; ++i) {
+        size_t begin = i * kCompressionBlockSize;
+        size_t rawSize = std::min(kCompressionBlockSize, used - begin);
+        sizeField.clear();
+        if (compressed[i]) {
+            appendLittleEndian32(sizeField, (uint32_t)blocks[i].size());
+            failed = !sink.write(sizeField.data(), sizeField.size()) || !sink.write(blocks[i].data(), blocks[i].size());
+        } else {
+            appendLittleEndian32(sizeField, (uint32_t)rawSize | kUncompressedBlockFlag); // Stored as is
+            failed = !sink.write(sizeField.data(), sizeField.size()) || !sink.write(pbase() + begin, rawSize);
+        }
+    }
+    recordCounter("compression.blocks", (int64_t)blockCount);
+    setp(&pending[0], &pending[0] + batchBytes);
+    return !failed;
+}
+
+Lz4FrameWriteBuf::int_type Lz4FrameWriteBuf::overflow(int_type ch) {
+    if (!flushBatch()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize Lz4FrameWriteBuf::xsputn(const char* data, std::streamsize count) {
+    std::streamsize written = 0;
+    while (written < count) {
+        if (pptr() == epptr() && !flushBatch()) {
+            break;
+        }
+        std::streamsize chunk = std::min<std::streamsize>(count - written, epptr() - pptr());
+        std::memcpy(pptr(), data + written, (size_t)chunk);
+        pbump((int)chunk);
+        written += chunk;
+    }
+    return written;
+}
+
+bool Lz4FrameWriteBuf::finish() {
+    if (pptr() != pbase() || !headerWritten) {
+        flushBatch();
+    }
+    std::string endMark;
+    appendLittleEndian32(endMark, 0);
+    if (!failed && !sink.write(endMark.data(), endMark.size())) {
+        failed = true;
+    }
+    return !failed;
+}
+
+Lz4FrameReadBuf::Lz4FrameReadBuf(std::istream& source)
+    : source(source), maxBlockSize(0), blockChecksums(false), valid(false), finished(true) {
+    unsigned char header[7];
+    if (!source.read((char*)header, 6) || readLittleEndian32(header) != kFrameMagic) {
+        return;
+    }
+    unsigned char flags = header[4];
+    unsigned char blockDescriptor = header[5];
+    unsigned sizeCode = (blockDescriptor >> 4) & 0x7;
+    bool independentBlocks = flags & 0x20;
+    if ((flags >> 6) != 1 || !independentBlocks || sizeCode < 4) {
+        return; // Only independent blocks are supported, as written by Lz4FrameWriteBuf and "lz4" by default
+    }
+
+    // Optional content size and dictionary id fields are part of the descriptor checksum
+    std::string descriptor((const char*)header + 4, 2);
+    size_t extra = ((flags & 0x08) ? 8 : 0) + ((flags & 0x01) ? 4 : 0);
+    std::string extraBytes(extra, '\0');
+    if (extra && !source.read(&extraBytes[0], extra)) {
+        return;
+    }
+    descriptor += extraBytes;
+    unsigned char checksum;
+    if (!source.read((char*)&checksum, 1)
+        || checksum != descriptorChecksum((const unsigned char*)descriptor.data(), descriptor.size())) {
+        return;
+    }
+
+    maxBlockSize = (size_t)1 << (8 + 2 * sizeCode); // 4 = 64 KiB ... 7 = 4 MiB
+    blockChecksums = flags & 0x10;
+    block.resize(maxBlockSize);
+    valid = true;
+    finished = false;
+}
+
+bool Lz4FrameReadBuf::readNextBlock() {
+    unsigned char sizeField[4];
+    if (finished || !source.read((char*)sizeField, sizeof(sizeField))) {
+        finished = true;
+        return false;
+    }
+    uint32_t blockSize = readLittleEndian32(sizeField);
+    if (blockSize == 0) {
+        finished = true; // End mark; a trailing content checksum is not verified
+        return false;
+    }
+
+    bool stored = blockSize & kUncompressedBlockFlag;
+    blockSize &= ~kUncompressedBlockFlag;
+    if (blockSize > maxBlockSize) {
+        finished = true;
+        return false;
+    }
+    size_t produced = 0;
+    if (stored) {
+        finished = !source.read(block.data(), blockSize);
+        produced = blockSize;
+    } else {
+        compressed.resize(blockSize);
+        finished = !source.read(compressed.data(), blockSize)
+            || !decompressLz4Block(compressed.data(), blockSize, block.data(), block.size(), produced);
+    }
+    if (blockChecksums) {
+        source.ignore(4);
+    }
+    if (finished) {
+        return false;
+    }
+    setg(block.data(), block.data(), block.data() + produced);
+    return true;
+}
+
+Lz4FrameReadBuf::int_type Lz4FrameReadBuf::underflow() {
+    while (gptr() == egptr()) {
+        if (!readNextBlock()) {
+            return traits_type::eof();
+        }
+    }
+    return traits_type::to_int_type(*gptr());
+}
+
+OutputFile::OutputFile(const std::string& requestedPath, bool compress)
+    : path(compress ? requestedPath + kCompressedFileSuffix : requestedPath),
+      file(path, compress ? std::ios::out | std::ios::binary : std::ios::out), out(nullptr) {
+    if (compress) {
+        compressor = std::make_unique<Lz4FrameWriteBuf>(file);
+        out.rdbuf(compressor.get());
+    } else {
+        out.rdbuf(file.rdbuf());
+    }
+}
+
+bool OutputFile::close() {
+    bool ok = !out.bad();
+    if (compressor) {
+        ok = compressor->finish() && ok;
+    }
+    file.close();
+    return ok && !file.fail();
+}
+
+InputFile::InputFile(const std::string& path) : in(nullptr) {
+    if (isCompressedFile(path)) {
+        file.open(path, std::ios::binary);
+        decompressor = std::make_unique<Lz4FrameReadBuf>(file);
+        in.rdbuf(decompressor.get());
+    } else {
+        file.open(path);
+        in.rdbuf(file.rdbuf());
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <streambuf>
+#include <memory> // For std::unique_ptr
+#include <atomic>
+#include <cstdint>
+
+// Optional block compression for partition files and saveAs outputs, in the LZ4 frame
+// format (independent 256 KiB blocks, no checksums), so files can be inspected with the
+// standard "lz4 -d". The block codec is built in; no external library is needed.
+// Disabled by default; enable with "--compress" or TODOAPP_COMPRESS=1. Readers detect
+// compressed files by their magic number, so compressed and plain files can be mixed.
+
+extern std::atomic<bool> compressionEnabled;
+
+inline bool isCompressionEnabled() {
+    return compressionEnabled.load(std::memory_order_relaxed);
+}
+
+void setCompressionEnabled(bool enabled);
+
+const char* const kCompressedFileSuffix = ".lz4";
+const size_t kCompressionBlockSize = 256 * 1024;
+
+// Compresses one LZ4 block; returns false if the data does not shrink ('out' is then unspecified)
+bool compressLz4Block(const char* source, size_t size, std::string& out);
+
+// Decompresses one LZ4 block into 'destination'; returns false on malformed input or overflow
+bool decompressLz4Block(const char* source, size_t size, char* destination, size_t capacity, size_t& produced);
+
+// True if the file starts with the LZ4 frame magic number
+bool isCompressedFile(const std::string& path);
+
+// Output stream buffer that writes an LZ4 frame to 'sink'. Data is cut into blocks; a batch
+// of blocks is compressed in parallel on a shared worker pool and written in order.
+class Lz4FrameWriteBuf : public std::streambuf {
+private:
+    std::ostream& sink;
+    std::string pending; // Uncompressed bytes of the current batch
+    size_t batchBytes;
+    bool headerWritten;
+    bool failed;
+
+    bool writeHeader();
+    bool flushBatch();
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* data, std::streamsize count) override;
+
+public:
+    explicit Lz4FrameWriteBuf(std::ostream& sink);
+
+    // Compresses what is buffered and writes the end mark; returns false if any write failed
+    bool finish();
+};
+
+// Input stream buffer that decodes an LZ4 frame from 'source' one block at a time
+class Lz4FrameReadBuf : public std::streambuf {
+private:
+    std::istream& source;
+    std::vector<char> compressed;
+    std::vector<char> block;
+    size_t maxBlockSize;
+    bool blockChecksums;
+    bool valid;
+    bool finished;
+
+    bool readNextBlock();
+
+protected:
+    int_type underflow() override;
+
+public:
+    explicit Lz4FrameReadBuf(std::istream& source);
+
+    bool isValid() const { return valid; } // False if the frame header was not recognized
+};
+
+// An output file that is LZ4 compressed when compression is enabled, in which case
+// kCompressedFileSuffix is appended to the path
+class OutputFile {
+private:
+    std::string path;
+    std::ofstream file;
+    std::unique_ptr<Lz4FrameWriteBuf> compressor;
+    std::ostream out;
+
+public:
+    explicit OutputFile(const std::string& requestedPath, bool compress = isCompressionEnabled());
+
+    bool isOpen() const { return file.is_open(); }
+    const std::string& getPath() const { return path; }
+    std::ostream& stream() { return out; }
+
+    // Flushes and closes; returns false if anything failed to write
+    bool close();
+};
+
+// An input file that is transparently decompressed when it is an LZ4 frame
+class InputFile {
+private:
+    std::ifstream file;
+    std::unique_ptr<Lz4FrameReadBuf> decompressor;
+    std::istream in;
+
+public:
+    explicit InputFile(const std::string& path);
+
+    bool isOpen() const { return file.is_open() && (!decompressor || decompressor->isValid()); }
+    bool isCompressed() const { return decompressor != nullptr; }
+    std::istream& stream() { return in; }
+};
+
+#endif // BLOCK_COMPRESSION_H
@@ -0,0 +1,141 @@
+#include "ColumnBatch.h"
+#include "FormDefinition.h" // For FormDefinition struct
+#include <memory> // For std::static_pointer_cast
+
+namespace {
+
+ColumnBatch::Encoding encodingFor(const FormField& field) {
+    if (field.type == "select") {
+        return ColumnBatch::Encoding::Dictionary;
+    } else if (field.type == "timestamp") {
+        return ColumnBatch::Encoding::TimestampMillis;
+    } else if (field.type == "number") {
+        const std::string& numberType = static_cast<const NumberField&>(field).numberType;
+        if (numberType == "int") {
+            return ColumnBatch::Encoding::Int32;
+        } else if (numberType == "float") {
+            return ColumnBatch::Encoding::Float32;
+        }
+        return ColumnBatch::Encoding::Float64;
+    }
+    return ColumnBatch::Encoding::Utf8;
+}
+
+} // namespace
+
+size_t ColumnBatch::Column::valueWidth() const {
+    switch (encoding) {
+        case Encoding::Utf8: return 0;
+        case Encoding::Int32: return sizeof(int32_t);
+        case Encoding::Float32: return sizeof(float);
+        case Encoding::Float64: return sizeof(double);
+        case Encoding::TimestampMillis: return sizeof(int64_t);
+        case Encoding::Dictionary: return sizeof(int32_t);
+    }
+    return 0;
+}
+
+ColumnBatch::ColumnBatch(const FormDefinition& formDef) : rows(0) {
+    Column key;
+    key.name = "KEY";
+    key.encoding = Encoding::Int32;
+    key.nullable = false;
+    columns.push_back(std::move(key));
+
+    for (const auto& field : formDef.fields) {
+        Column column;
+        column.name = field->name;
+        column.encoding = encodingFor(*field);
+        if (column.encoding == Encoding::Dictionary) {
+            // Seed with the options so codes follow the form's option order
+            for (const auto& option : std::static_pointer_cast<SelectField>(field)->options) {
+                if (column.codes.emplace(option.second, (int32_t)column.dictionary.size()).second) {
+                    column.dictionary.push_back(option.second);
+                }
+            }
+        }
+        columns.push_back(std::move(column));
+    }
+    clear();
+}
+
+void ColumnBatch::clear() {
+    rows = 0;
+    for (auto& column : columns) {
+        column.validity.clear();
+        column.nullCount = 0;
+        column.values.clear();
+        column.offsets.assign(column.encoding == Encoding::Utf8 ? 1 : 0, 0);
+    }
+}
+
+void ColumnBatch::append(const EntryView& row) {
+    if (rows % 8 == 0) {
+        for (auto& column : columns) {
+            column.validity.push_back(0);
+        }
+    }
+    const uint8_t bit = (uint8_t)(1u << (rows % 8));
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        Column& column = columns[i];
+        const FieldValueView* value = i == 0 ? nullptr : row.find(column.name);
+        bool valid = true;
+        switch (column.encoding) {
+            case Encoding::Int32: {
+                const int* number = i == 0 ? &row.key : value ? std::get_if<int>(value) : nullptr;
+                valid = number != nullptr;
+                appendLittleEndian<int32_t>(column.values, valid ? *number : 0);
+                break;
+            }
+            case Encoding::Float32: {
+                const float* number = value ? std::get_if<float>(value) : nullptr;
+                valid = number != nullptr;
+                appendLittleEndian<float>(column.values, valid ? *number : 0.0f);
+                break;
+            }
+            case Encoding::Float64: {
+                const double* number = value ? std::get_if<double>(value) : nullptr;
+                valid = number != nullptr;
+                appendLittleEndian<double>(column.values, valid ? *number : 0.0);
+                break;
+            }
+            case Encoding::TimestampMillis: {
+                const Timestamp* time = value ? std::get_if<Timestamp>(value) : nullptr;
+                valid = time != nullptr;
+                appendLittleEndian<int64_t>(column.values, valid ? time->millis : 0);
+                break;
+            }
+            case Encoding::Utf8: {
+                const std::string_view* text = value ? std::get_if<std::string_view>(value) : nullptr;
+                valid = text != nullptr;
+                if (valid) {
+                    column.values.insert(column.values.end(), text->begin(), text->end());
+                }
+                column.offsets.push_back((int32_t)column.values.size());
+                break;
+            }
+            case Encoding::Dictionary: {
+                const std::string_view* text = value ? std::get_if<std::string_view>(value) : nullptr;
+                valid = text != nullptr;
+                int32_t code = 0;
+                if (valid) {
+                    auto found = column.codes.find(std::string(*text));
+                    if (found == column.codes.end()) {
+                        found = column.codes.emplace(std::string(*text), (int32_t)column.dictionary.size()).first;
+                        column.dictionary.emplace_back(*text);
+                    }
+                    code = found->second;
+                }
+                appendLittleEndian<int32_t>(column.values, code);
+                break;
+            }
+        }
+        if (valid) {
+            column.validity.back() |= bit;
+        } else {
+            ++column.nullCount;
+        }
+    }
+    ++rows;
+}
@@ -0,0 +1,80 @@
+#ifndef COLUMN_BATCH_H
+#define COLUMN_BATCH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring> // For std::memcpy
+#include <algorithm> // For std::reverse
+#include <type_traits> // For std::is_trivially_copyable_v
+#include "EntryView.h" // For EntryView
+
+struct FormDefinition;
+
+// A run of exported rows split into typed columns, shared by the columnar binary and
+// Arrow exporters. Column 0 is the entry key; the rest follow the form's fields in order.
+// All values are stored little-endian, so the buffers can be written out as they are.
+class ColumnBatch {
+public:
+    enum class Encoding : uint8_t {
+        Utf8 = 0, // Offsets plus bytes
+        Int32 = 1,
+        Float32 = 2,
+        Float64 = 3,
+        TimestampMillis = 4, // int64 milliseconds since the epoch, UTC
+        Dictionary = 5, // int32 codes into a dictionary of strings; used for select fields
+    };
+
+    struct Column {
+        std::string name;
+        Encoding encoding;
+        bool nullable = true;
+        std::vector<uint8_t> validity; // One bit per row, least significant bit first
+        size_t nullCount = 0;
+        std::vector<uint8_t> values; // Fixed width values or dictionary codes; UTF-8 bytes for Utf8
+        std::vector<int32_t> offsets; // Utf8 only: rows + 1 byte offsets into 'values'
+
+        // Dictionary only; kept across batches so codes stay stable for the whole export
+        std::vector<std::string> dictionary;
+        std::unordered_map<std::string, int32_t> codes;
+        size_t dictionaryWritten = 0; // Entries already written out by the exporter
+
+        size_t valueWidth() const; // Bytes per row in 'values', 0 for Utf8
+    };
+
+    static const size_t kDefaultRowsPerBatch = 64 * 1024;
+
+    explicit ColumnBatch(const FormDefinition& formDef);
+
+    // Adds one row; values whose type does not match the column are exported as null
+    void append(const EntryView& row);
+
+    // Empties the columns for the next batch; dictionaries are kept
+    void clear();
+
+    size_t rowCount() const { return rows; }
+    std::vector<Column>& getColumns() { return columns; }
+    const std::vector<Column>& getColumns() const { return columns; }
+
+private:
+    std::vector<Column> columns;
+    size_t rows;
+};
+
+// Appends 'value' to 'out' in little-endian byte order
+template <typename T>
+void appendLittleEndian(std::vector<uint8_t>& out, T value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be appended");
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if constexpr (sizeof(T) > 1) {
+        const uint16_t probe = 1;
+        if (*reinterpret_cast<const uint8_t*>(&probe) != 1) { // Big-endian host
+            std::reverse(bytes, bytes + sizeof(T));
+        }
+    }
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+#endif // COLUMN_BATCH_H
@@ -0,0 +1,145 @@
+#include "ColumnWidthStats.h"
+#include "Entry.h" // For Entry
+#include "FormDefinition.h" // For FormDefinition
+#include <fstream>
+#include <sstream>
+#include <algorithm> // For std::max, std::min
+
+namespace {
+
+const size_t kKeyColumnMinWidth = 5;
+const size_t kStableWidthLimit = 48; // Columns up to this wide always fit their widest value
+const double kOutlierFraction = 0.95;
+const size_t kMissingValueWidth = 3; // Width of "N/A"
+
+} // namespace
+
+void ColumnWidthStats::addEntry(const Entry& entry) {
+    for (const auto& pair : entry.data) {
+        histograms[pair.first][fieldValueDisplayWidth(pair.second)]++;
+    }
+    entryCount++;
+}
+
+void ColumnWidthStats::removeEntry(const Entry& entry) {
+    for (const auto& pair : entry.data) {
+        auto field = histograms.find(pair.first);
+        if (field == histograms.end()) {
+            continue;
+        }
+        auto bucket = field->second.find(fieldValueDisplayWidth(pair.second));
+        if (bucket != field->second.end() && --bucket->second == 0) {
+            field->second.erase(bucket);
+        }
+    }
+    if (entryCount > 0) {
+        entryCount--;
+    }
+}
+
+void ColumnWidthStats::clear() {
+    histograms.clear();
+    entryCount = 0;
+}
+
+size_t ColumnWidthStats::maxWidth(const std::string& fieldName) const {
+    auto field = histograms.find(fieldName);
+    if (field == histograms.end() || field->second.empty()) {
+        return 0;
+    }
+    return field->second.rbegin()->first;
+}
+
+size_t ColumnWidthStats::valueCount(const std::string& fieldName) const {
+    auto field = histograms.find(fieldName);
+    if (field == histograms.end()) {
+        return 0;
+    }
+    size_t total = 0;
+    for (const auto& bucket : field->second) {
+        total += bucket.second;
+    }
+    return total;
+}
+
+size_t ColumnWidthStats::percentileWidth(const std::string& fieldName, double fraction) const {
+    auto field = histograms.find(fieldName);
+    if (field == histograms.end() || field->second.empty()) {
+        return 0;
+    }
+    size_t total = valueCount(fieldName);
+    size_t target = (size_t)(fraction * total + 0.5);
+    size_t seen = 0;
+    for (const auto& bucket : field->second) {
+        seen += bucket.second;
+        if (seen >= target) {
+            return bucket.first;
+        }
+    }
+    return field->second.rbegin()->first;
+}
+
+std::vector<size_t> ColumnWidthStats::layoutWidths(const FormDefinition& formDef, int maxKey) const {
+    std::vector<size_t> widths;
+    widths.push_back(std::max(kKeyColumnMinWidth, std::to_string(maxKey).size()));
+    for (const auto& field : formDef.fields) {
+        size_t width = maxWidth(field->name);
+        if (width > kStableWidthLimit) {
+            width = std::min(width, std::max(percentileWidth(field->name, kOutlierFraction), kStableWidthLimit));
+        }
+        if (valueCount(field->name) < entryCount) {
+            width = std::max(width, kMissingValueWidth); // Some rows show "N/A"
+        }
+        widths.push_back(std::max(width, field->name.length()));
+    }
+    return widths;
+}
+
+bool ColumnWidthStats::saveToFile(const std::string& path, uint64_t sourceStamp) const {
+    std::ofstream outFile(path);
+    if (!outFile.is_open()) {
+        return false;
+    }
+    // Format: "WIDTHS:1:<entries>:<source stamp>", then per field a "FIELD:<name>"
+    // line followed by one "<width> <count>" line per histogram bucket
+    outFile << "WIDTHS:1:" << entryCount << ":" << sourceStamp << "\n";
+    for (const auto& field : histograms) {
+        outFile << "FIELD:" << field.first << "\n";
+        for (const auto& bucket : field.second) {
+            outFile << bucket.first << " " << bucket.second << "\n";
+        }
+    }
+    return (bool)outFile;
+}
+
+bool ColumnWidthStats::loadFromFile(const std::string& path, uint64_t sourceStamp, size_t expectedEntries) {
+    std::ifstream inFile(path);
+    std::string line;
+    if (!inFile.is_open() || !std::getline(inFile, line)) {
+        return false;
+    }
+    std::ostringstream expectedHeader;
+    expectedHeader << "WIDTHS:1:" << expectedEntries << ":" << sourceStamp;
+    if (line != expectedHeader.str()) {
+        return false; // Written for another version of the entries
+    }
+
+    std::map<std::string, std::map<size_t, size_t>> loaded;
+    std::map<size_t, size_t>* current = nullptr;
+    while (std::getline(inFile, line)) {
+        if (line.rfind("FIELD:", 0) == 0) {
+            current = &loaded[line.substr(6)];
+            continue;
+        }
+        std::istringstream ss(line);
+        size_t width, count;
+        if (!current || !(ss >> width >> count)) {
+            return false;
+        }
+        (*current)[width] = count;
+    }
+
+    histograms = std::move(loaded);
+    entryCount = expectedEntries;
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef COLUMN_WIDTH_STATS_H
+#define COLUMN_WIDTH_STATS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+struct Entry;
+struct FormDefinition;
+
+// Per-field histogram of display widths (formatted cell lengths).
+// Kept up to date on every add/edit/delete, so the widest value and width percentiles
+// are known without rescanning the entries. One histogram bucket per distinct width.
+class ColumnWidthStats {
+private:
+    std::map<std::string, std::map<size_t, size_t>> histograms; // Field name -> (width -> count)
+    size_t entryCount;
+
+public:
+    ColumnWidthStats() : entryCount(0) {}
+
+    void addEntry(const Entry& entry);
+    void removeEntry(const Entry& entry);
+    void clear();
+
+    size_t getEntryCount() const { return entryCount; }
+
+    // Number of entries that have a value for the field
+    size_t valueCount(const std::string& fieldName) const;
+
+    // Widest value in the field, 0 if it has no values
+    size_t maxWidth(const std::string& fieldName) const;
+
+    // Smallest width that at least 'fraction' (0..1] of the field's values fit in
+    size_t percentileWidth(const std::string& fieldName, double fraction) const;
+
+    // Column widths for KEY followed by every field: the exact maximum, unless a few
+    // outliers make it very wide, in which case the 95th percentile (the table truncates wider cells)
+    std::vector<size_t> layoutWidths(const FormDefinition& formDef, int maxKey) const;
+
+    // Sidecar persistence; 'sourceStamp' identifies the stored version the stats describe
+    // (the partition manifest generation).
+    // load() returns false if the file is missing, malformed or describes a different version.
+    bool saveToFile(const std::string& path, uint64_t sourceStamp) const;
+    bool loadFromFile(const std::string& path, uint64_t sourceStamp, size_t expectedEntries);
+};
+
+#endif // COLUMN_WIDTH_STATS_H
@@ -55,12 +55,13 @@ void createNewForm() {
         std::cout << "2. Add Number Input\n";
         std::cout << "3. Add Select Input\n";
         std::cout << "4. Finish Form Creation\n";
+        std::cout << "5. Add Timestamp Input\n";
         std::cout << "Enter your choice: ";
         std::cin >> choice;
         std::cin.ignore(); // Clear the buffer
 
         std::string inputName;
-        if (choice >= 1 && choice <= 3) {
+        if ((choice >= 1 && choice <= 3) || choice == 5) {
             std::cout << "Enter the name for this input: ";
             std::getline(std::cin, inputName);
         }
@@ -152,6 +153,12 @@ void createNewForm() {
                 formFields.push_back({inputName, "select"});
                 break;
             }
+            case 5: { // Timestamp Input
+                formFields.push_back({inputName, "timestamp"});
+                outFile << "timestamp:" << inputName << "\n";
+                std::cout << "Timestamp input '" << inputName << "' added.\n";
+                break;
+            }
             case 4:
                 std::cout << "Form '" << formName << "' created successfully in " << formFilePath << std::endl;
                 break;
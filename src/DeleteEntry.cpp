@@ -1,30 +1,58 @@
 #include "DeleteEntry.h"
-#include "FormDefinition.h" // For currentSelectedForm
-#include "Entry.h"          // For currentEntryManager
+#include "FormDefinition.h" // For FormDefinition
+#include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For acquireSelectedManager
+#include "EntryFilter.h"    // For EntryFilter
 #include <iostream>
-#include <limits> // For numeric_limits
-
-extern std::unique_ptr<EntryManager> currentEntryManager; // Declare extern
+#include <sstream> // For std::istringstream
 
 void deleteEntry() {
-    if (!currentSelectedForm) {
-        std::cout << "No form is currently selected. Please select a form first (Option 3).\n";
+    std::shared_ptr<FormDefinition> selectedForm;
+    auto manager = acquireSelectedManager(selectedForm);
+    if (!manager) {
         return;
     }
 
-    if (!currentEntryManager || currentEntryManager->getFormName() != currentSelectedForm->name) {
-        currentEntryManager = std::make_unique<EntryManager>(currentSelectedForm->name);
-    }
-
-    if (currentEntryManager->getEntries().empty()) {
+    if (manager->getEntries()->empty()) {
         std::cout << "No entries to delete for the current form.\n";
         return;
     }
 
+    std::string selection;
+    std::cout << "Enter the key of the entry to delete, a key range (e.g. 10-20) or a condition (e.g. status = done): ";
+    std::getline(std::cin >> std::ws, selection);
+
     int keyToDelete;
-    std::cout << "Enter the key of the entry to delete: ";
-    std::cin >> keyToDelete;
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear buffer
+    std::istringstream keyInput(selection);
+    if (keyInput >> keyToDelete && (keyInput >> std::ws).eof()) {
+        manager->deleteEntry(keyToDelete);
+        return;
+    }
+
+    EntryFilter filter;
+    std::string error;
+    if (!EntryFilter::parse(*selectedForm, selection, filter, error)) {
+        std::cout << "Error: " << error << "\n";
+        return;
+    }
+    size_t matches = 0;
+    for (const Entry& entry : *manager->getEntries()) {
+        matches += filter.matches(entry) ? 1 : 0;
+    }
+    if (matches == 0) {
+        std::cout << "No entries match '" << selection << "'.\n";
+        return;
+    }
 
-    currentEntryManager->deleteEntry(keyToDelete);
+    std::string confirm;
+    std::cout << "Delete " << matches << " entries? (y/n): ";
+    std::getline(std::cin, confirm);
+    if (confirm != "y" && confirm != "Y") {
+        std::cout << "Deletion cancelled.\n";
+        return;
+    }
+    // Removed in one pass and saved once, then renumbered like a single delete
+    size_t removed = manager->removeEntries([&filter](const Entry& entry) { return filter.matches(entry); });
+    std::cout << removed << " entries deleted successfully.\n";
+    std::cout << "Entry numbering reset.\n";
 }
@@ -1,4 +1,6 @@
 #include "DeleteForm.h"
+#include "FormCatalog.h" // For formCatalog
+#include "EntryManagerPool.h" // For entryManagerPool
 #include <iostream>
 #include <string>
 #include <vector>
@@ -16,14 +18,12 @@ void deleteForm() {
         return;
     }
 
-    std::vector<std::string> formFiles;
+    // The catalog only rescans what changed since the last menu visit
+    std::vector<std::string> formFiles = formCatalog.listForms();
     std::cout << "Available Forms:\n";
     int i = 1;
-    for (const auto& entry : fs::directory_iterator(formsDir)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".form") {
-            formFiles.push_back(entry.path().filename().string());
-            std::cout << i++ << ". " << entry.path().filename().string() << "\n";
-        }
+    for (const auto& formFile : formFiles) {
+        std::cout << i++ << ". " << formFile << "\n";
     }
 
     if (formFiles.empty()) {
@@ -36,12 +36,12 @@ void deleteForm() {
     std::cin >> choice;
 
     if (choice > 0 && choice <= formFiles.size()) {
-        std::string formToDelete = formsDir + formFiles[choice - 1];
-        try {
-            fs::remove(formToDelete);
+        if (formCatalog.removeForm(formFiles[choice - 1])) {
+            std::string formName = formFiles[choice - 1].substr(0, formFiles[choice - 1].length() - 5);
+            entryManagerPool.evict(formName); // Release its entries, the form can no longer be selected
             std::cout << "Form '" << formFiles[choice - 1] << "' deleted successfully.\n";
-        } catch (const fs::filesystem_error& e) {
-            std::cerr << "Error deleting form: " << e.what() << std::endl;
+        } else {
+            std::cout << "Failed to delete form '" << formFiles[choice - 1] << "'.\n";
         }
     } else if (choice == 0) {
         std::cout << "Form deletion cancelled.\n";
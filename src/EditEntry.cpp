@@ -1,30 +1,72 @@
 #include "EditEntry.h"
-#include "FormDefinition.h" // For currentSelectedForm
-#include "Entry.h"          // For currentEntryManager
+#include "FormDefinition.h" // For FormDefinition
+#include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For acquireSelectedManager
+#include "EntryFilter.h"    // For EntryFilter, parseFieldInput
+#include "FormValidator.h"  // For FormValidator
 #include <iostream>
-#include <limits> // For numeric_limits
-
-extern std::unique_ptr<EntryManager> currentEntryManager; // Declare extern
+#include <sstream> // For std::istringstream
 
 void editEntry() {
-    if (!currentSelectedForm) {
-        std::cout << "No form is currently selected. Please select a form first (Option 3).\n";
+    std::shared_ptr<FormDefinition> selectedForm;
+    auto manager = acquireSelectedManager(selectedForm);
+    if (!manager) {
         return;
     }
 
-    if (!currentEntryManager || currentEntryManager->getFormName() != currentSelectedForm->name) {
-        currentEntryManager = std::make_unique<EntryManager>(currentSelectedForm->name);
-    }
-
-    if (currentEntryManager->getEntries().empty()) {
+    if (manager->getEntries()->empty()) {
         std::cout << "No entries to edit for the current form.\n";
         return;
     }
 
+    std::string selection;
+    std::cout << "Enter the key of the entry to edit, or a key range (e.g. 10-20) or condition (e.g. status = open) to set one field on every match: ";
+    std::getline(std::cin >> std::ws, selection);
+
     int keyToEdit;
-    std::cout << "Enter the key of the entry to edit: ";
-    std::cin >> keyToEdit;
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear buffer
+    std::istringstream keyInput(selection);
+    if (keyInput >> keyToEdit && (keyInput >> std::ws).eof()) {
+        manager->editEntry(keyToEdit, selectedForm);
+        return;
+    }
+
+    EntryFilter filter;
+    std::string error;
+    if (!EntryFilter::parse(*selectedForm, selection, filter, error)) {
+        std::cout << "Error: " << error << "\n";
+        return;
+    }
+
+    std::string fieldName;
+    std::cout << "Field to set: ";
+    std::getline(std::cin, fieldName);
+    std::shared_ptr<FormField> field;
+    for (const auto& candidate : selectedForm->fields) {
+        if (candidate->name == fieldName) {
+            field = candidate;
+        }
+    }
+    if (!field) {
+        std::cout << "Error: Unknown field '" << fieldName << "'.\n";
+        return;
+    }
+
+    std::string input;
+    FieldValue value;
+    std::cout << "New value for " << field->name << (field->type == "select" ? " (option number or text)" : "") << ": ";
+    std::getline(std::cin, input);
+    if (!parseFieldInput(*field, input, value)) {
+        std::cout << "Error: '" << input << "' is not a valid value for " << field->name << ".\n";
+        return;
+    }
+
+    std::map<std::string, FieldValue> changes = {{field->name, value}};
+    if (selectedForm->validator && !selectedForm->validator->validateChanges(changes, error)) {
+        std::cout << "Error: " << error << " No entries updated.\n";
+        return;
+    }
 
-    currentEntryManager->editEntry(keyToEdit, currentSelectedForm);
+    // Every matching row is changed in one pass and saved once
+    size_t updated = manager->updateEntries([&filter](const Entry& entry) { return filter.matches(entry); }, changes);
+    std::cout << updated << " entries updated successfully.\n";
 }
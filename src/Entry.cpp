@@ -1,13 +1,19 @@
 #include "Entry.h"
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "TableRenderer.h" // For TableRenderer
+#include "SchemaMigration.h" // For SchemaMigration
+#include "EntryFilter.h" // For EntryFilter
+#include "FormValidator.h" // For FormValidator
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <limits> // For numeric_limits
-#include <iomanip> // For std::setw
-#include <algorithm> // For std::find_if, std::remove_if
+#include <algorithm> // For std::max, std::min, std::sort
+#include <chrono> // For load timing
+#include <unordered_set>
+#include <unordered_map>
 
 // Global EntryManager instance definition
-std::unique_ptr<EntryManager> currentEntryManager = nullptr;
+std::shared_ptr<EntryManager> currentEntryManager = nullptr;
 
 // Helper to get input safely
 template<typename T>
@@ -27,322 +33,1139 @@ T getValidatedInput(const std::string& prompt) {
     }
 }
 
-EntryManager::EntryManager(const std::string& formName) : formName(formName), nextKey(1) {
-    entriesFilePath = "Forms/" + formName + "_entries.dat"; // Using .dat for generic data
+// False, after printing why, when 'value' breaks the field's rules from the .form file
+bool passesRules(const FormDefinition& formDef, const std::string& fieldName, const FieldValue& value) {
+    std::string error;
+    if (!formDef.validator || formDef.validator->validateField(fieldName, &value, error)) {
+        return true;
+    }
+    std::cout << error << (std::cin ? " Please try again." : "") << "\n";
+    return false;
+}
+
+// Reads a line until it parses as a timestamp
+Timestamp getValidatedTimestamp(const std::string& prompt) {
+    std::string text;
+    Timestamp time;
+    while (true) {
+        std::cout << prompt;
+        if (!std::getline(std::cin, text)) {
+            return time;
+        }
+        if (parseTimestamp(text, time)) {
+            return time;
+        }
+        std::cout << "Invalid timestamp. Use YYYY-MM-DD or YYYY-MM-DDTHH:MM[:SS].\n";
+    }
+}
+
+EntryManager::EntryManager(const std::string& formName, const std::shared_ptr<FormDefinition>& formDef)
+    : formName(formName), store(formName), entries(std::make_shared<EntrySnapshot>()), nextKey(1), approximateBytes(0), lastLoadMillis(0.0),
+      schemaHash(formDef ? schemaHashOf(*formDef) : 0), schemaMigration(formDef ? std::make_shared<SchemaMigration>(*formDef) : nullptr), dedupIndexBytes(0),
+      operationLogBytes(0) {
+    store.setSchemaHash(schemaHash);
     loadEntriesFromFile();
 }
 
-void EntryManager::saveEntriesToFile() {
-    std::ofstream outFile(entriesFilePath);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Could not save entries to file " << entriesFilePath << std::endl;
-        return;
+EntryManager::~EntryManager() {
+    if (schemaRewriteThread.joinable()) {
+        schemaRewriteThread.join();
+    }
+}
+
+namespace {
+
+// Rough per-node cost of a std::map node header (colour, parent, left, right)
+const size_t kMapNodeOverhead = 4 * sizeof(void*);
+const size_t kShortStringCapacity = 15; // Strings up to this length live inside std::string (SSO)
+
+size_t stringHeapBytes(const std::string& value) {
+    return value.capacity() > kShortStringCapacity ? value.capacity() + 1 : 0;
+}
+
+// Bytes held by one stored value beyond the map node; FieldValue is stored inline, so only long strings add heap
+size_t valueBytes(const FieldValue& value, size_t& heapBytes) {
+    const std::string* text = std::get_if<std::string>(&value);
+    heapBytes = text ? stringHeapBytes(*text) : 0;
+    return heapBytes;
+}
+
+} // namespace
+
+size_t EntryManager::entryFootprint(const Entry& entry) {
+    size_t bytes = sizeof(Entry);
+    size_t heapBytes;
+    for (const auto& pair : entry.data) {
+        bytes += kMapNodeOverhead + sizeof(pair) + stringHeapBytes(pair.first);
+        bytes += valueBytes(pair.second, heapBytes);
     }
+    return bytes;
+}
+
+FormStats EntryManager::computeStats() const {
+    TRACE_SCOPE("EntryManager::computeStats");
+    auto snapshot = getEntries();
+    FormStats stats;
+    stats.entryCount = snapshot->size();
+    stats.loadMillis = lastLoadMillis;
+    stats.entryOverheadBytes = snapshot->size() * sizeof(Entry);
 
-    for (const auto& entry : entries) {
-        outFile << "KEY:" << entry.key << "\n";
+    std::map<std::string, size_t> columnIndex; // Field name -> position in stats.columns
+    size_t heapBytes;
+    for (const Entry& entry : *snapshot) {
         for (const auto& pair : entry.data) {
-            outFile << pair.first << ":";
-            // Need to handle different std::any types for saving
-            if (pair.second.type() == typeid(std::string)) {
-                outFile << "string:" << std::any_cast<std::string>(pair.second) << "\n";
-            } else if (pair.second.type() == typeid(int)) {
-                outFile << "int:" << std::any_cast<int>(pair.second) << "\n";
-            } else if (pair.second.type() == typeid(float)) {
-                outFile << "float:" << std::any_cast<float>(pair.second) << "\n";
-            } else if (pair.second.type() == typeid(double)) {
-                outFile << "double:" << std::any_cast<double>(pair.second) << "\n";
+            auto it = columnIndex.find(pair.first);
+            if (it == columnIndex.end()) {
+                it = columnIndex.emplace(pair.first, stats.columns.size()).first;
+                stats.columns.emplace_back();
+                stats.columns.back().name = pair.first;
+                stats.columns.back().type = fieldValueTypeName(pair.second);
             }
-            // Add more types as needed
+
+            size_t cellBytes = kMapNodeOverhead + sizeof(pair) + stringHeapBytes(pair.first) + valueBytes(pair.second, heapBytes);
+            FormStats::ColumnStats& column = stats.columns[it->second];
+            column.values++;
+            column.bytes += cellBytes;
+            column.stringHeapBytes += heapBytes + stringHeapBytes(pair.first);
+
+            FormStats::TypeStats& type = stats.types[fieldValueTypeName(pair.second)];
+            type.values++;
+            type.bytes += cellBytes;
+            stats.stringHeapBytes += heapBytes + stringHeapBytes(pair.first);
+        }
+    }
+
+    stats.totalBytes = stats.entryOverheadBytes;
+    for (const auto& column : stats.columns) {
+        stats.totalBytes += column.bytes;
+    }
+
+    // The segment table is the only index today: one shared pointer plus control block per segment
+    stats.indexBytes["snapshot segments"] = snapshot->getSegments().size() * (sizeof(EntrySegmentPtr) + sizeof(EntrySegment) + 2 * sizeof(long));
+
+    stats.indexBytes["partition manifest"] = store.getManifest().partitions.size() * sizeof(PartitionInfo);
+    if (dedupIndexBytes > 0) {
+        stats.indexBytes["dedup hash set"] = dedupIndexBytes;
+    }
+    if (operationLogBytes > 0) {
+        stats.indexBytes["undo log"] = operationLogBytes;
+    }
+    {
+        std::lock_guard<std::mutex> lock(timestampIndexMutex);
+        for (const auto& pair : timestampIndexes) {
+            stats.indexBytes["timestamp index (" + pair.first + ")"] = pair.second->memoryBytes();
         }
-        outFile << "---\n"; // Separator for entries
     }
-    outFile.close();
+
+    stats.fileBytes = store.totalBytes();
+    return stats;
+}
+
+std::string EntryManager::entriesDirectoryFor(const std::string& formName) {
+    return PartitionStore::directoryFor(formName);
+}
+
+std::string EntryManager::widthStatsFilePathFor(const std::string& formName) {
+    return entriesDirectoryFor(formName) + "/widths";
+}
+
+std::vector<size_t> EntryManager::getColumnLayout(const FormDefinition& formDef) const {
+    auto snapshot = getEntries();
+    int maxKey = snapshot->empty() ? 0 : (*snapshot)[snapshot->size() - 1].key; // Keys stay sequential
+    std::lock_guard<std::mutex> lock(widthMutex);
+    return widthStats.layoutWidths(formDef, maxKey);
+}
+
+ColumnWidthStats EntryManager::getWidthStats() const {
+    std::lock_guard<std::mutex> lock(widthMutex);
+    return widthStats;
+}
+
+EntrySnapshotPtr EntryManager::getEntries() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    return entries;
+}
+
+void EntryManager::publish(EntrySnapshotPtr snapshot) {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    entries = std::move(snapshot);
+}
+
+void EntryManager::saveEntriesToFile(const EntrySnapshotPtr& snapshot, bool rewriteAll) {
+    TRACE_SCOPE("EntryManager::saveEntriesToFile");
+    // Only partitions touched since the last save are rewritten; the manifest switch is atomic
+    if (!store.save(snapshot, rewriteAll)) {
+        return;
+    }
+
+    // The sidecar records the manifest generation, so a stale one is detected and rebuilt on load
+    std::lock_guard<std::mutex> lock(widthMutex);
+    widthStats.saveToFile(widthStatsFilePathFor(formName), store.getManifest().generation);
 }
 
 void EntryManager::loadEntriesFromFile() {
-    std::ifstream inFile(entriesFilePath);
-    if (!inFile.is_open()) {
-        // File might not exist yet, which is fine for a new form
+    TRACE_SCOPE("EntryManager::loadEntriesFromFile");
+    auto loadStart = std::chrono::steady_clock::now();
+    std::vector<Entry> loaded;
+    bool needsMigration = false;
+    if (!store.load(loaded, needsMigration)) {
+        // Nothing stored yet, which is fine for a new form
         return;
     }
 
-    entries.clear();
-    std::string line;
-    std::shared_ptr<Entry> currentEntry = nullptr;
+    // Rows written under another schema are converted lazily, so a large form opens immediately
+    std::shared_ptr<const SchemaMigration> migration;
+    if (store.getManifest().schemaHash != schemaHash) {
+        migration = schemaMigration;
+    }
+
     nextKey = 1; // Reset nextKey for loading
+    size_t loadedBytes = 0;
+    for (const auto& entry : loaded) {
+        nextKey = std::max(nextKey, entry.key + 1); // Update nextKey
+        loadedBytes += entryFootprint(entry);
+    }
 
-    while (std::getline(inFile, line)) {
-        if (line.rfind("KEY:", 0) == 0) { // Starts with "KEY:"
-            int key = std::stoi(line.substr(4));
-            currentEntry = std::make_shared<Entry>(key);
-            entries.push_back(*currentEntry); // Add to vector
-            nextKey = std::max(nextKey, key + 1); // Update nextKey
-        } else if (line == "---") {
-            currentEntry = nullptr; // End of current entry
-        } else if (currentEntry) {
-            std::stringstream ss(line);
-            std::string fieldName, fieldType, fieldValueStr;
-            std::getline(ss, fieldName, ':');
-            std::getline(ss, fieldType, ':');
-            std::getline(ss, fieldValueStr);
-
-            if (fieldType == "string") {
-                entries.back().data[fieldName] = fieldValueStr;
-            } else if (fieldType == "int") {
-                entries.back().data[fieldName] = std::stoi(fieldValueStr);
-            } else if (fieldType == "float") {
-                entries.back().data[fieldName] = std::stof(fieldValueStr);
-            } else if (fieldType == "double") {
-                entries.back().data[fieldName] = std::stod(fieldValueStr);
+    approximateBytes = loadedBytes;
+    {
+        std::lock_guard<std::mutex> lock(widthMutex);
+        if (needsMigration || !widthStats.loadFromFile(widthStatsFilePathFor(formName), store.getManifest().generation, loaded.size())) {
+            widthStats.clear();
+            for (const auto& loadedEntry : loaded) {
+                widthStats.addEntry(loadedEntry);
             }
         }
     }
-    inFile.close();
+    lastLoadMillis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    recordCounter("entries.loaded", (int64_t)loaded.size());
+    auto snapshot = EntrySnapshot::fromEntries(std::move(loaded), 0, migration);
+    publish(snapshot);
+
+    DedupSettings dedup;
+    if (DedupSettings::parseSpec(store.getManifest().dedupSpec, dedup) && dedup.enabled()) {
+        dedupIndex.configure(dedup);
+        rebuildDedupIndex(*snapshot);
+    }
+
+    if (needsMigration) {
+        // One-time conversion of a pre-partition entries file
+        WriteTransaction transaction(*this);
+        saveEntriesToFile(snapshot, true);
+        store.removeLegacyFile();
+    } else {
+        store.markPersisted(snapshot);
+        if (migration && !snapshot->empty() && backgroundSchemaRewriteEnabled) {
+            schemaRewriteThread = std::thread(&EntryManager::rewriteForSchema, this);
+        }
+    }
 }
 
-void EntryManager::addEntry(const std::shared_ptr<FormDefinition>& formDef) {
-    if (!formDef) {
-        std::cout << "No form selected. Please select a form first.\n";
-        return;
+void EntryManager::rewriteForSchema() {
+    TRACE_SCOPE("EntryManager::rewriteForSchema");
+    // Migrate every segment first without blocking anyone; writers publishing meanwhile share these segments
+    for (const auto& segment : getEntries()->getSegments()) {
+        segment->ensureMigrated();
     }
 
-    Entry newEntry(nextKey++);
-    std::cout << "\n--- Add New Entry for Form: " << formDef->name << " ---\n";
+    WriteTransaction transaction(*this);
+    auto snapshot = getEntries();
+    saveEntriesToFile(snapshot, true); // Records the new schema in the manifest
+    std::lock_guard<std::mutex> widthLock(widthMutex);
+    widthStats.clear(); // Drop widths of removed fields and of values before conversion
+    for (const Entry& entry : *snapshot) {
+        widthStats.addEntry(entry);
+    }
+    widthStats.saveToFile(widthStatsFilePathFor(formName), store.getManifest().generation);
+}
 
-    for (const auto& field : formDef->fields) {
-        if (field->type == "string") {
-            std::string value;
-            std::cout << "Enter value for " << field->name << " (string): ";
-            std::getline(std::cin, value);
-            newEntry.data[field->name] = value;
-        } else if (field->type == "number") {
-            auto numField = std::static_pointer_cast<NumberField>(field);
-            if (numField->numberType == "int") {
-                newEntry.data[field->name] = getValidatedInput<int>("Enter value for " + field->name + " (int): ");
-            } else if (numField->numberType == "float") {
-                newEntry.data[field->name] = getValidatedInput<float>("Enter value for " + field->name + " (float): ");
-            } else if (numField->numberType == "double") {
-                newEntry.data[field->name] = getValidatedInput<double>("Enter value for " + field->name + " (double): ");
+EntryManager::WriteTransaction::WriteTransaction(EntryManager& manager) : manager(manager), threadLock(manager.writeMutex) {
+    manager.store.beginWrite();
+    manager.reloadLocked(); // The change is made to what other processes saved, not to a stale copy
+}
+
+EntryManager::WriteTransaction::~WriteTransaction() {
+    manager.store.endWrite();
+}
+
+bool EntryManager::reloadIfChanged() {
+    if (!store.hasChangedOnDisk()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return reloadLocked();
+}
+
+bool EntryManager::reloadLocked() {
+    if (!store.hasChangedOnDisk()) {
+        return false;
+    }
+    TRACE_SCOPE("EntryManager::reloadIfChanged");
+    auto current = getEntries();
+    auto next = store.reload(current->getVersion() + 1, schemaMigration); // Another process may still write the old schema
+    if (!next) {
+        return false;
+    }
+
+    adoptSnapshot(std::move(next));
+    operationLog.clear(); // Its steps describe rows another process may have changed
+    operationLogBytes = 0;
+
+    DedupSettings dedup;
+    DedupSettings::parseSpec(store.getManifest().dedupSpec, dedup);
+    dedupIndex.configure(dedup);
+    rebuildDedupIndex(*getEntries());
+    if (!dedup.enabled()) {
+        dedupIndexBytes = 0;
+    }
+    recordCounter("entries.reloads", 1);
+    return true;
+}
+
+void EntryManager::adoptSnapshot(EntrySnapshotPtr next) {
+    // Only rows in segments that are not shared with the current snapshot change the estimates
+    auto current = getEntries();
+    const auto& oldSegments = current->getSegments();
+    const auto& newSegments = next->getSegments();
+    {
+        std::lock_guard<std::mutex> widthLock(widthMutex);
+        for (size_t s = 0; s < std::max(oldSegments.size(), newSegments.size()); ++s) {
+            bool inOld = s < oldSegments.size(), inNew = s < newSegments.size();
+            if (inOld && inNew && oldSegments[s] == newSegments[s]) {
+                continue;
             }
-        } else if (field->type == "select") {
-            auto selectField = std::static_pointer_cast<SelectField>(field);
-            std::cout << "Select an option for " << field->name << ":\n";
-            for (const auto& option : selectField->options) {
-                std::cout << option.first << ". " << option.second << "\n";
+            // Through the migrating accessor: a segment with a pending migration must not be read raw
+            if (inOld) {
+                oldSegments[s]->ensureMigrated();
+                for (const Entry& entry : oldSegments[s]->rows) {
+                    approximateBytes -= entryFootprint(entry);
+                    widthStats.removeEntry(entry);
+                }
             }
-            int selectedOption = getValidatedInput<int>("Enter your choice: ");
-            if (selectField->options.count(selectedOption)) {
-                newEntry.data[field->name] = selectField->options[selectedOption];
-            } else {
-                std::cout << "Invalid option selected. Storing empty value.\n";
-                newEntry.data[field->name] = std::string("");
+            if (inNew) {
+                newSegments[s]->ensureMigrated();
+                for (const Entry& entry : newSegments[s]->rows) {
+                    approximateBytes += entryFootprint(entry);
+                    widthStats.addEntry(entry);
+                }
             }
         }
     }
-    entries.push_back(newEntry);
-    saveEntriesToFile();
-    std::cout << "Entry with key " << newEntry.key << " added successfully.\n";
+    nextKey = next->empty() ? 1 : (*next)[next->size() - 1].key + 1;
+    publish(std::move(next));
 }
 
-void EntryManager::editEntry(int key, const std::shared_ptr<FormDefinition>& formDef) {
-    if (!formDef) {
-        std::cout << "No form selected. Please select a form first.\n";
-        return;
-    }
+EntryManager::EntryLookup EntryManager::lookupIn(const EntrySnapshotPtr& snapshot) {
+    return [snapshot](int key) -> const Entry* {
+        long index = snapshot->findIndexByKey(key);
+        return index < 0 ? nullptr : &(*snapshot)[index];
+    };
+}
 
-    auto it = std::find_if(entries.begin(), entries.end(), [key](const Entry& e) {
-        return e.key == key;
-    });
+int EntryManager::insertEntry(const std::map<std::string, FieldValue>& data, bool* duplicate) {
+    TRACE_SCOPE("EntryManager::insertEntry");
+    WriteTransaction transaction(*this);
+    uint64_t hash = 0;
+    if (dedupIndex.getSettings().enabled()) {
+        hash = dedupIndex.hashOf(data);
+        int existing = dedupIndex.findDuplicate(data, hash, lookupIn(getEntries()));
+        if (existing != 0) {
+            if (duplicate) {
+                *duplicate = true;
+            }
+            recordCounter("entries.duplicates", 1);
+            if (dedupIndex.getSettings().mode == DedupSettings::Mode::Merge && !dedupIndex.getSettings().fields.empty()) {
+                updateLocked(existing, data); // Identity fields match, so only the other fields can change
+            }
+            return existing;
+        }
+    }
+    if (duplicate) {
+        *duplicate = false;
+    }
 
-    if (it == entries.end()) {
-        std::cout << "Entry with key " << key << " not found.\n";
-        return;
+    Entry newEntry(nextKey++);
+    newEntry.data = data;
+    approximateBytes += entryFootprint(newEntry);
+    {
+        std::lock_guard<std::mutex> widthLock(widthMutex);
+        widthStats.addEntry(newEntry);
+    }
+    if (dedupIndex.getSettings().enabled()) {
+        dedupIndex.add(hash, newEntry.key);
+        dedupIndexBytes = dedupIndex.memoryBytes();
     }
 
-    Entry& entryToEdit = *it;
-    std::cout << "\n--- Editing Entry with Key: " << key << " for Form: " << formDef->name << " ---\n";
+    auto snapshot = getEntries();
+    OperationStep step;
+    step.kind = OperationStep::Kind::Append;
+    step.indices.push_back(snapshot->size());
+    step.rows.push_back(newEntry);
+    recordOperation({"add", {std::move(step)}});
 
-    for (const auto& field : formDef->fields) {
-        std::cout << "Current value for " << field->name << ": ";
-        if (entryToEdit.data.count(field->name)) {
-            if (field->type == "string") {
-                std::cout << std::any_cast<std::string>(entryToEdit.data[field->name]) << "\n";
-            } else if (field->type == "number") {
-                auto numField = std::static_pointer_cast<NumberField>(field);
-                if (numField->numberType == "int") {
-                    std::cout << std::any_cast<int>(entryToEdit.data[field->name]) << "\n";
-                } else if (numField->numberType == "float") {
-                    std::cout << std::any_cast<float>(entryToEdit.data[field->name]) << "\n";
-                } else if (numField->numberType == "double") {
-                    std::cout << std::any_cast<double>(entryToEdit.data[field->name]) << "\n";
+    auto next = snapshot->withAppended(newEntry);
+    saveEntriesToFile(next);
+    publish(std::move(next));
+    return newEntry.key;
+}
+
+size_t EntryManager::importEntries(const std::vector<std::map<std::string, FieldValue>>& rows, size_t* duplicates) {
+    TRACE_SCOPE("EntryManager::importEntries");
+    WriteTransaction transaction(*this);
+    auto snapshot = getEntries();
+
+    // Rebuild only the partially filled tail segment plus the new rows
+    size_t firstSegment = snapshot->size() / EntrySnapshot::kSegmentCapacity;
+    size_t firstRow = firstSegment * EntrySnapshot::kSegmentCapacity;
+    std::vector<Entry> tailRows(snapshot->begin() + firstRow, snapshot->end());
+    tailRows.reserve(tailRows.size() + rows.size());
+    int firstTailKey = tailRows.empty() ? nextKey : tailRows.front().key;
+    size_t storedTailRows = tailRows.size();
+
+    // Duplicates may match stored rows or rows earlier in this batch
+    const DedupSettings& dedup = dedupIndex.getSettings();
+    bool mergeFields = dedup.mode == DedupSettings::Mode::Merge && !dedup.fields.empty();
+    std::vector<Entry> storedTail; // Stored tail rows as they were, for undoing merges into them
+    if (mergeFields) {
+        storedTail = tailRows;
+    }
+    std::vector<std::pair<size_t, Entry>> mergedRows; // Stored rows before the tail that take merged values
+    std::unordered_map<int, size_t> mergedPositions; // Key -> position in mergedRows
+    auto findRow = [&](int key) -> Entry* {
+        if (key >= firstTailKey) {
+            size_t offset = (size_t)(key - firstTailKey);
+            return offset < tailRows.size() ? &tailRows[offset] : nullptr;
+        }
+        auto merged = mergedPositions.find(key);
+        if (merged != mergedPositions.end()) {
+            return &mergedRows[merged->second].second;
+        }
+        long index = snapshot->findIndexByKey(key);
+        if (index < 0) {
+            return nullptr;
+        }
+        mergedPositions[key] = mergedRows.size();
+        mergedRows.emplace_back(index, (*snapshot)[index]);
+        return &mergedRows.back().second;
+    };
+    auto lookup = [&](int key) -> const Entry* {
+        if (key >= firstTailKey) {
+            return findRow(key);
+        }
+        long index = snapshot->findIndexByKey(key);
+        return index < 0 ? nullptr : &(*snapshot)[index];
+    };
+
+    size_t added = 0;
+    size_t duplicateCount = 0;
+    std::unique_lock<std::mutex> widthLock(widthMutex);
+    for (const auto& data : rows) {
+        uint64_t hash = 0;
+        if (dedup.enabled()) {
+            hash = dedupIndex.hashOf(data);
+            int existing = dedupIndex.findDuplicate(data, hash, lookup);
+            if (existing != 0) {
+                ++duplicateCount;
+                Entry* target = mergeFields ? findRow(existing) : nullptr;
+                if (target) {
+                    widthStats.removeEntry(*target);
+                    approximateBytes -= entryFootprint(*target);
+                    for (const auto& pair : data) {
+                        target->data[pair.first] = pair.second;
+                    }
+                    approximateBytes += entryFootprint(*target);
+                    widthStats.addEntry(*target);
                 }
-            } else if (field->type == "select") {
-                std::cout << std::any_cast<std::string>(entryToEdit.data[field->name]) << "\n";
+                continue;
             }
+        }
+        tailRows.emplace_back(nextKey++);
+        tailRows.back().data = data;
+        approximateBytes += entryFootprint(tailRows.back());
+        widthStats.addEntry(tailRows.back());
+        if (dedup.enabled()) {
+            dedupIndex.add(hash, tailRows.back().key);
+        }
+        ++added;
+    }
+    widthLock.unlock();
+    dedupIndexBytes = dedupIndex.memoryBytes();
+    recordCounter("entries.duplicates", (int64_t)duplicateCount);
+    if (duplicates) {
+        *duplicates = duplicateCount;
+    }
+
+    std::sort(mergedRows.begin(), mergedRows.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    LoggedOperation operation{"import " + std::to_string(added) + " entries", {}};
+    OperationStep merged;
+    merged.kind = OperationStep::Kind::Replace;
+    for (const auto& pair : mergedRows) {
+        merged.indices.push_back(pair.first);
+        merged.rows.push_back(pair.second);
+        merged.previous.push_back((*snapshot)[pair.first]);
+    }
+    for (size_t i = 0; i < storedTail.size(); ++i) {
+        if (tailRows[i].data != storedTail[i].data) {
+            merged.indices.push_back(firstRow + i);
+            merged.rows.push_back(tailRows[i]);
+            merged.previous.push_back(std::move(storedTail[i]));
+        }
+    }
+    if (!merged.indices.empty()) {
+        operation.steps.push_back(std::move(merged));
+    }
+    if (added > 0) {
+        OperationStep appended;
+        appended.kind = OperationStep::Kind::Append;
+        appended.indices.push_back(snapshot->size());
+        appended.rows.assign(tailRows.begin() + storedTailRows, tailRows.end());
+        operation.steps.push_back(std::move(appended));
+    }
+    if (!operation.steps.empty()) {
+        recordOperation(std::move(operation));
+    }
+
+    auto base = mergedRows.empty() ? snapshot : snapshot->withReplacedRows(std::move(mergedRows));
+    auto next = base->withTailReplaced(firstSegment, std::move(tailRows));
+    saveEntriesToFile(next);
+    publish(std::move(next));
+    return added;
+}
+
+void EntryManager::persist(bool rewriteAll) {
+    WriteTransaction transaction(*this);
+    saveEntriesToFile(getEntries(), rewriteAll);
+}
+
+bool EntryManager::updateEntry(int key, const std::map<std::string, FieldValue>& changes) {
+    TRACE_SCOPE("EntryManager::updateEntry");
+    WriteTransaction transaction(*this);
+    return updateLocked(key, changes);
+}
+
+bool EntryManager::updateLocked(int key, const std::map<std::string, FieldValue>& changes) {
+    auto snapshot = getEntries();
+    long index = snapshot->findIndexByKey(key);
+    if (index < 0) {
+        return false;
+    }
+
+    Entry updated = (*snapshot)[index];
+    approximateBytes -= entryFootprint(updated);
+    for (const auto& pair : changes) {
+        updated.data[pair.first] = pair.second;
+    }
+    approximateBytes += entryFootprint(updated);
+    {
+        std::lock_guard<std::mutex> widthLock(widthMutex);
+        widthStats.removeEntry((*snapshot)[index]);
+        widthStats.addEntry(updated);
+    }
+    if (dedupIndex.getSettings().enabled()) {
+        // Uniqueness is enforced on add and import; an edit may create a duplicate, which removeDuplicates() cleans up
+        dedupIndex.remove(dedupIndex.hashOf((*snapshot)[index].data), key);
+        dedupIndex.add(dedupIndex.hashOf(updated.data), key);
+    }
+
+    OperationStep step;
+    step.kind = OperationStep::Kind::Replace;
+    step.indices.push_back(index);
+    step.rows.push_back(updated);
+    step.previous.push_back((*snapshot)[index]);
+    recordOperation({"edit " + std::to_string(key), {std::move(step)}});
+
+    auto next = snapshot->withReplaced(index, updated);
+    saveEntriesToFile(next);
+    publish(std::move(next));
+    return true;
+}
+
+bool EntryManager::removeEntry(int key) {
+    WriteTransaction transaction(*this);
+    bool found = false;
+    removeAndRenumber(key, found);
+    return found;
+}
+
+void EntryManager::removeAndRenumber(int key, bool& found) {
+    TRACE_SCOPE("EntryManager::removeAndRenumber");
+    long index = getEntries()->findIndexByKey(key);
+    found = index >= 0;
+    if (found) {
+        removeMatching([key](const Entry& entry) { return entry.key == key; }, index, "delete " + std::to_string(key));
+    }
+}
+
+size_t EntryManager::removeMatching(const EntryPredicate& match, size_t firstIndex, const std::string& label) {
+    auto snapshot = getEntries();
+    while (firstIndex < snapshot->size() && !match((*snapshot)[firstIndex])) {
+        ++firstIndex;
+    }
+    if (firstIndex >= snapshot->size()) {
+        return 0;
+    }
+
+    // Segments before the first deleted row keep their keys and are shared as-is
+    size_t firstSegment = firstIndex / EntrySnapshot::kSegmentCapacity;
+    size_t firstRow = firstSegment * EntrySnapshot::kSegmentCapacity;
+    int newKey = firstRow > 0 ? (*snapshot)[firstRow - 1].key + 1 : 1;
+
+    std::vector<Entry> tailRows;
+    tailRows.reserve(snapshot->size() - firstRow);
+    size_t removed = 0;
+    OperationStep step; // Removed rows and the keys of the rebuilt region, for undo
+    step.kind = OperationStep::Kind::Remove;
+    step.firstKey = (*snapshot)[firstRow].key;
+    bool keysConsecutive = true;
+    std::unique_lock<std::mutex> widthLock(widthMutex);
+    for (size_t i = firstRow; i < snapshot->size(); ++i) {
+        const Entry& entry = (*snapshot)[i];
+        step.keys.push_back(entry.key);
+        keysConsecutive = keysConsecutive && entry.key == step.firstKey + (int)(i - firstRow);
+        if (i >= firstIndex && match(entry)) {
+            approximateBytes -= entryFootprint(entry);
+            widthStats.removeEntry(entry);
+            step.indices.push_back(i);
+            step.rows.push_back(entry);
+            ++removed;
+            continue;
+        }
+        tailRows.push_back(entry);
+        tailRows.back().key = newKey++;
+    }
+    widthLock.unlock();
+    nextKey = newKey;
+    if (keysConsecutive) {
+        step.keys.clear();
+    }
+    recordOperation({label.empty() ? "delete " + std::to_string(removed) + " entries" : label, {std::move(step)}});
+
+    auto next = snapshot->withTailReplaced(firstSegment, std::move(tailRows));
+    saveEntriesToFile(next);
+    publish(next);
+    rebuildDedupIndex(*next); // Keys after the first removal changed
+    return removed;
+}
+
+size_t EntryManager::removeEntries(const EntryPredicate& match) {
+    TRACE_SCOPE("EntryManager::removeEntries");
+    WriteTransaction transaction(*this);
+    size_t removed = removeMatching(match, 0, "");
+    recordCounter("entries.bulk_removed", (int64_t)removed);
+    return removed;
+}
+
+size_t EntryManager::updateEntries(const EntryPredicate& match, const std::map<std::string, FieldValue>& changes) {
+    TRACE_SCOPE("EntryManager::updateEntries");
+    WriteTransaction transaction(*this);
+    auto snapshot = getEntries();
+    std::vector<std::pair<size_t, Entry>> updatedRows;
+    std::unique_lock<std::mutex> widthLock(widthMutex);
+    for (size_t i = 0; i < snapshot->size(); ++i) {
+        const Entry& entry = (*snapshot)[i];
+        if (!match(entry)) {
+            continue;
+        }
+        updatedRows.emplace_back(i, entry);
+        Entry& updated = updatedRows.back().second;
+        for (const auto& pair : changes) {
+            updated.data[pair.first] = pair.second;
+        }
+        approximateBytes -= entryFootprint(entry);
+        approximateBytes += entryFootprint(updated);
+        widthStats.removeEntry(entry);
+        widthStats.addEntry(updated);
+    }
+    widthLock.unlock();
+    if (updatedRows.empty()) {
+        return 0;
+    }
+
+    size_t updated = updatedRows.size();
+    OperationStep step;
+    step.kind = OperationStep::Kind::Replace;
+    for (const auto& pair : updatedRows) {
+        step.indices.push_back(pair.first);
+        step.rows.push_back(pair.second);
+        step.previous.push_back((*snapshot)[pair.first]);
+    }
+    recordOperation({"update " + std::to_string(updated) + " entries", {std::move(step)}});
+
+    auto next = snapshot->withReplacedRows(std::move(updatedRows));
+    saveEntriesToFile(next);
+    publish(next);
+    rebuildDedupIndex(*next);
+    recordCounter("entries.bulk_updated", (int64_t)updated);
+    return updated;
+}
+
+std::shared_ptr<const TimestampIndex> EntryManager::getTimestampIndex(const EntrySnapshotPtr& snapshot, const std::string& fieldName) const {
+    std::lock_guard<std::mutex> lock(timestampIndexMutex);
+    auto& cached = timestampIndexes[fieldName];
+    if (!cached || cached->getSnapshot() != snapshot) {
+        cached = TimestampIndex::build(snapshot, fieldName, cached.get());
+    }
+    return cached;
+}
+
+std::vector<size_t> EntryManager::findMatchingRows(const EntrySnapshotPtr& snapshot, const EntryFilter& filter) const {
+    TRACE_SCOPE("EntryManager::findMatchingRows");
+    std::vector<size_t> rows;
+    std::string timeField;
+    Timestamp from, to;
+    if (filter.timeBounds(timeField, from, to)) {
+        std::vector<size_t> candidates;
+        getTimestampIndex(snapshot, timeField)->rowsInRange(from, to, candidates);
+        std::sort(candidates.begin(), candidates.end());
+        for (size_t row : candidates) {
+            if (filter.matches((*snapshot)[row])) {
+                rows.push_back(row);
+            }
+        }
+        return rows;
+    }
+    for (size_t i = 0; i < snapshot->size(); ++i) {
+        if (filter.matches((*snapshot)[i])) {
+            rows.push_back(i);
+        }
+    }
+    return rows;
+}
+
+void EntryManager::rebuildDedupIndex(const EntrySnapshot& snapshot) {
+    if (dedupIndex.getSettings().enabled()) {
+        dedupIndex.rebuild(snapshot);
+        dedupIndexBytes = dedupIndex.memoryBytes();
+    }
+}
+
+void EntryManager::setDedupSettings(const DedupSettings& settings) {
+    WriteTransaction transaction(*this);
+    dedupIndex.configure(settings);
+    auto snapshot = getEntries();
+    rebuildDedupIndex(*snapshot);
+    if (!settings.enabled()) {
+        dedupIndex.clear();
+        dedupIndexBytes = 0;
+    }
+    store.setDedupSpec(settings.toSpec());
+    saveEntriesToFile(snapshot); // No partition changed, so this only writes the manifest
+}
+
+DedupSettings EntryManager::getDedupSettings() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return dedupIndex.getSettings();
+}
+
+size_t EntryManager::removeDuplicates() {
+    TRACE_SCOPE("EntryManager::removeDuplicates");
+    WriteTransaction transaction(*this);
+    auto snapshot = getEntries();
+
+    // Whole-row identity unless the form has its own identity fields
+    DedupIndex seen;
+    DedupSettings settings = dedupIndex.getSettings();
+    settings.mode = DedupSettings::Mode::Reject;
+    seen.configure(settings);
+    auto lookup = lookupIn(snapshot);
+    std::unordered_set<int> duplicateKeys;
+    size_t firstDuplicate = snapshot->size();
+    for (size_t i = 0; i < snapshot->size(); ++i) {
+        const Entry& entry = (*snapshot)[i];
+        uint64_t hash = seen.hashOf(entry.data);
+        if (seen.findDuplicate(entry.data, hash, lookup) != 0) {
+            duplicateKeys.insert(entry.key);
+            firstDuplicate = std::min(firstDuplicate, i);
         } else {
-            std::cout << "[Not set]\n";
+            seen.add(hash, entry.key);
         }
+    }
+    if (duplicateKeys.empty()) {
+        return 0;
+    }
+    // The first occurrence of each row is kept; the rest go in one pass and one save
+    size_t removed = removeMatching([&duplicateKeys](const Entry& entry) { return duplicateKeys.count(entry.key) > 0; }, firstDuplicate,
+                                    "remove duplicates");
+    recordCounter("entries.duplicates_removed", (int64_t)removed);
+    return removed;
+}
 
-        std::string response;
-        std::cout << "Do you want to edit this field? (y/n): ";
-        std::getline(std::cin, response);
-        if (response == "y" || response == "Y") {
+void EntryManager::addEntry(const std::shared_ptr<FormDefinition>& formDef) {
+    if (!formDef) {
+        std::cout << "No form selected. Please select a form first.\n";
+        return;
+    }
+
+    // Prompts run without holding any lock; the finished row is committed in one step
+    Entry newEntry(0);
+    std::cout << "\n--- Add New Entry for Form: " << formDef->name << " ---\n";
+
+    for (const auto& field : formDef->fields) {
+        do { // Asked again until the value passes the field's rules; at end of input the row check rejects it
             if (field->type == "string") {
                 std::string value;
-                std::cout << "Enter new value for " << field->name << " (string): ";
+                std::cout << "Enter value for " << field->name << " (string): ";
                 std::getline(std::cin, value);
-                entryToEdit.data[field->name] = value;
+                newEntry.data[field->name] = value;
             } else if (field->type == "number") {
                 auto numField = std::static_pointer_cast<NumberField>(field);
                 if (numField->numberType == "int") {
-                    entryToEdit.data[field->name] = getValidatedInput<int>("Enter new value for " + field->name + " (int): ");
+                    newEntry.data[field->name] = getValidatedInput<int>("Enter value for " + field->name + " (int): ");
                 } else if (numField->numberType == "float") {
-                    entryToEdit.data[field->name] = getValidatedInput<float>("Enter new value for " + field->name + " (float): ");
+                    newEntry.data[field->name] = getValidatedInput<float>("Enter value for " + field->name + " (float): ");
                 } else if (numField->numberType == "double") {
-                    entryToEdit.data[field->name] = getValidatedInput<double>("Enter new value for " + field->name + " (double): ");
+                    newEntry.data[field->name] = getValidatedInput<double>("Enter value for " + field->name + " (double): ");
                 }
+            } else if (field->type == "timestamp") {
+                newEntry.data[field->name] = getValidatedTimestamp("Enter value for " + field->name + " (timestamp, YYYY-MM-DD[THH:MM[:SS]]): ");
             } else if (field->type == "select") {
                 auto selectField = std::static_pointer_cast<SelectField>(field);
-                std::cout << "Select a new option for " << field->name << ":\n";
+                std::cout << "Select an option for " << field->name << ":\n";
                 for (const auto& option : selectField->options) {
                     std::cout << option.first << ". " << option.second << "\n";
                 }
                 int selectedOption = getValidatedInput<int>("Enter your choice: ");
                 if (selectField->options.count(selectedOption)) {
-                    entryToEdit.data[field->name] = selectField->options[selectedOption];
+                    newEntry.data[field->name] = selectField->options[selectedOption];
                 } else {
-                    std::cout << "Invalid option selected. Value remains unchanged.\n";
+                    std::cout << "Invalid option selected. Storing empty value.\n";
+                    newEntry.data[field->name] = std::string("");
                 }
             }
-        }
+        } while (!passesRules(*formDef, field->name, newEntry.data[field->name]) && std::cin);
+    }
+    std::string error;
+    if (formDef->validator && !formDef->validator->validateRow(newEntry.data, error)) {
+        std::cout << error << " Entry not added.\n";
+        return;
+    }
+    bool duplicate = false;
+    int key = insertEntry(newEntry.data, &duplicate);
+    if (!duplicate) {
+        std::cout << "Entry with key " << key << " added successfully.\n";
+    } else if (getDedupSettings().mode == DedupSettings::Mode::Merge) {
+        std::cout << "Duplicate entry merged into entry with key " << key << ".\n";
+    } else {
+        std::cout << "Duplicate entry rejected: same as entry with key " << key << ".\n";
     }
-    saveEntriesToFile();
-    std::cout << "Entry with key " << key << " updated successfully.\n";
 }
 
-void EntryManager::viewEntries(int page, int entriesPerPage) {
-    if (entries.empty()) {
-        std::cout << "No entries to display.\n";
+void EntryManager::editEntry(int key, const std::shared_ptr<FormDefinition>& formDef) {
+    if (!formDef) {
+        std::cout << "No form selected. Please select a form first.\n";
         return;
     }
 
-    if (!currentSelectedForm) {
-        std::cout << "No form selected. Cannot display entries without a form definition.\n";
+    auto snapshot = getEntries();
+    long index = snapshot->findIndexByKey(key);
+    if (index < 0) {
+        std::cout << "Entry with key " << key << " not found.\n";
         return;
     }
 
-    int totalEntries = entries.size();
-    int totalPages = (totalEntries + entriesPerPage - 1) / entriesPerPage;
-
-    if (page < 1) page = 1;
-    if (page > totalPages) page = totalPages;
-
-    int startIdx = (page - 1) * entriesPerPage;
-    int endIdx = std::min(startIdx + entriesPerPage, totalEntries);
-
-    std::cout << "\n--- Viewing Entries for Form: " << currentSelectedForm->name << " (Page " << page << "/" << totalPages << ") ---\n";
+    Entry entryToEdit = (*snapshot)[index]; // Edited as a private copy, then committed
+    std::cout << "\n--- Editing Entry with Key: " << key << " for Form: " << formDef->name << " ---\n";
 
-    // Determine column widths
-    std::map<std::string, int> columnWidths;
-    columnWidths["KEY"] = 5; // For "KEY" column
-    for (const auto& field : currentSelectedForm->fields) {
-        columnWidths[field->name] = field->name.length(); // Initial width is field name length
-    }
+    for (const auto& field : formDef->fields) {
+        std::cout << "Current value for " << field->name << ": ";
+        auto current = entryToEdit.data.find(field->name);
+        if (current != entryToEdit.data.end()) {
+            // Shown whatever kind is stored, so a value that does not match the schema cannot throw
+            std::cout << formatFieldValue(current->second) << "\n";
+        } else {
+            std::cout << "[Not set]\n";
+        }
 
-    // Adjust column widths based on data
-    for (int i = startIdx; i < endIdx; ++i) {
-        const auto& entry = entries[i];
-        columnWidths["KEY"] = std::max(columnWidths["KEY"], (int)std::to_string(entry.key).length());
-        for (const auto& field : currentSelectedForm->fields) {
-            if (entry.data.count(field->name)) {
+        std::string response;
+        std::cout << "Do you want to edit this field? (y/n): ";
+        std::getline(std::cin, response);
+        if (response == "y" || response == "Y") {
+            do {
                 if (field->type == "string") {
-                    columnWidths[field->name] = std::max(columnWidths[field->name], (int)std::any_cast<std::string>(entry.data.at(field->name)).length());
+                    std::string value;
+                    std::cout << "Enter new value for " << field->name << " (string): ";
+                    std::getline(std::cin, value);
+                    entryToEdit.data[field->name] = value;
                 } else if (field->type == "number") {
                     auto numField = std::static_pointer_cast<NumberField>(field);
                     if (numField->numberType == "int") {
-                        columnWidths[field->name] = std::max(columnWidths[field->name], (int)std::to_string(std::any_cast<int>(entry.data.at(field->name))).length());
+                        entryToEdit.data[field->name] = getValidatedInput<int>("Enter new value for " + field->name + " (int): ");
                     } else if (numField->numberType == "float") {
-                        columnWidths[field->name] = std::max(columnWidths[field->name], (int)std::to_string(std::any_cast<float>(entry.data.at(field->name))).length());
+                        entryToEdit.data[field->name] = getValidatedInput<float>("Enter new value for " + field->name + " (float): ");
                     } else if (numField->numberType == "double") {
-                        columnWidths[field->name] = std::max(columnWidths[field->name], (int)std::to_string(std::any_cast<double>(entry.data.at(field->name))).length());
+                        entryToEdit.data[field->name] = getValidatedInput<double>("Enter new value for " + field->name + " (double): ");
                     }
+                } else if (field->type == "timestamp") {
+                    entryToEdit.data[field->name] = getValidatedTimestamp("Enter new value for " + field->name + " (timestamp, YYYY-MM-DD[THH:MM[:SS]]): ");
                 } else if (field->type == "select") {
-                    columnWidths[field->name] = std::max(columnWidths[field->name], (int)std::any_cast<std::string>(entry.data.at(field->name)).length());
+                    auto selectField = std::static_pointer_cast<SelectField>(field);
+                    std::cout << "Select a new option for " << field->name << ":\n";
+                    for (const auto& option : selectField->options) {
+                        std::cout << option.first << ". " << option.second << "\n";
+                    }
+                    int selectedOption = getValidatedInput<int>("Enter your choice: ");
+                    if (selectField->options.count(selectedOption)) {
+                        entryToEdit.data[field->name] = selectField->options[selectedOption];
+                    } else {
+                        std::cout << "Invalid option selected. Value remains unchanged.\n";
+                    }
                 }
-            }
+            } while (!passesRules(*formDef, field->name, entryToEdit.data[field->name]) && std::cin);
         }
     }
-
-    // Print header
-    std::cout << std::left << std::setw(columnWidths["KEY"] + 2) << "KEY";
-    for (const auto& field : currentSelectedForm->fields) {
-        std::cout << std::left << std::setw(columnWidths[field->name] + 2) << field->name;
+    std::string error;
+    if (formDef->validator && !formDef->validator->validateRow(entryToEdit.data, error)) {
+        std::cout << error << " Entry not updated.\n";
+        return;
     }
-    std::cout << "\n";
-
-    // Print separator
-    std::cout << std::string(columnWidths["KEY"] + 2, '-');
-    for (const auto& field : currentSelectedForm->fields) {
-        std::cout << std::string(columnWidths[field->name] + 2, '-');
+    if (!updateEntry(key, entryToEdit.data)) {
+        std::cout << "Entry with key " << key << " was removed while editing.\n";
+        return;
     }
-    std::cout << "\n";
+    std::cout << "Entry with key " << key << " updated successfully.\n";
+}
 
-    // Print entries
-    for (int i = startIdx; i < endIdx; ++i) {
-        const auto& entry = entries[i];
-        std::cout << std::left << std::setw(columnWidths["KEY"] + 2) << entry.key;
-        for (const auto& field : currentSelectedForm->fields) {
-            if (entry.data.count(field->name)) {
-                if (field->type == "string") {
-                    std::cout << std::left << std::setw(columnWidths[field->name] + 2) << std::any_cast<std::string>(entry.data.at(field->name));
-                } else if (field->type == "int") {
-                    std::cout << std::left << std::setw(columnWidths[field->name] + 2) << std::any_cast<int>(entry.data.at(field->name));
-                } else if (field->type == "float") {
-                    std::cout << std::left << std::setw(columnWidths[field->name] + 2) << std::any_cast<float>(entry.data.at(field->name));
-                } else if (field->type == "double") {
-                    std::cout << std::left << std::setw(columnWidths[field->name] + 2) << std::any_cast<double>(entry.data.at(field->name));
-                } else if (field->type == "select") {
-                    std::cout << std::left << std::setw(columnWidths[field->name] + 2) << std::any_cast<std::string>(entry.data.at(field->name));
-                }
-            } else {
-                std::cout << std::left << std::setw(columnWidths[field->name] + 2) << "N/A";
-            }
-        }
-        std::cout << "\n";
+void EntryManager::viewEntries(int page, int entriesPerPage, const std::string& sortField, bool descending) {
+    TRACE_SCOPE("EntryManager::viewEntries");
+    auto snapshot = getEntries(); // Rendered from one consistent version
+    if (snapshot->empty()) {
+        std::cout << "No entries to display.\n";
+        return;
     }
 
-    // Page navigation
-    std::cout << "\nPage Navigation: ";
-    if (page > 1) {
-        std::cout << "< Previous ";
+    auto currentSelectedForm = std::atomic_load(&::currentSelectedForm);
+    if (!currentSelectedForm) {
+        std::cout << "No form selected. Cannot display entries without a form definition.\n";
+        return;
     }
-    std::cout << " (Current Page: " << page << ") ";
-    if (page < totalPages) {
-        std::cout << "Next >";
+
+    // One-off render; interactive browsing keeps its own TableRenderer so cells stay cached between pages
+    TableRenderer renderer(currentSelectedForm);
+    renderer.setSnapshot(snapshot);
+    renderer.setColumnLayout(getColumnLayout(*currentSelectedForm));
+    if (!sortField.empty()) {
+        renderer.setSortOrder(sortField, descending);
     }
-    std::cout << "\n";
+    renderer.writePage(page, entriesPerPage);
 }
 
 void EntryManager::deleteEntry(int key) {
-    auto it = std::remove_if(entries.begin(), entries.end(), [key](const Entry& e) {
-        return e.key == key;
-    });
+    bool found = false;
+    {
+        WriteTransaction transaction(*this);
+        removeAndRenumber(key, found);
+    }
 
-    if (it != entries.end()) {
-        entries.erase(it, entries.end());
+    if (found) {
         std::cout << "Entry with key " << key << " deleted successfully.\n";
-        resetEntryNumbering();
-        saveEntriesToFile();
+        std::cout << "Entry numbering reset.\n";
     } else {
         std::cout << "Entry with key " << key << " not found.\n";
     }
 }
 
 void EntryManager::resetEntryNumbering() {
+    TRACE_SCOPE("EntryManager::resetEntryNumbering");
+    WriteTransaction transaction(*this);
+    auto snapshot = getEntries();
+    std::vector<Entry> rows(snapshot->begin(), snapshot->end());
+    OperationStep step; // A removal of nothing from row 0: undo puts the old keys back
+    step.kind = OperationStep::Kind::Remove;
+    bool renumbered = false;
     nextKey = 1;
-    for (auto& entry : entries) {
+    for (auto& entry : rows) {
+        step.keys.push_back(entry.key);
+        renumbered = renumbered || entry.key != nextKey;
         entry.key = nextKey++;
     }
+    if (renumbered) {
+        recordOperation({"reset numbering", {std::move(step)}});
+    }
+
+    auto next = snapshot->withTailReplaced(0, std::move(rows));
+    saveEntriesToFile(next);
+    publish(next);
+    rebuildDedupIndex(*next);
     std::cout << "Entry numbering reset.\n";
 }
+
+void EntryManager::recordOperation(LoggedOperation&& operation) {
+    operationLog.record(std::move(operation));
+    operationLogBytes = operationLog.memoryBytes();
+}
+
+EntrySnapshotPtr EntryManager::applyStep(const EntrySnapshotPtr& snapshot, const OperationStep& step, bool reverse) {
+    const size_t capacity = EntrySnapshot::kSegmentCapacity;
+    switch (step.kind) {
+        case OperationStep::Kind::Append: {
+            size_t start = step.indices.front();
+            if (snapshot->size() != (reverse ? start + step.rows.size() : start)) {
+                return nullptr;
+            }
+            size_t firstSegment = start / capacity;
+            std::vector<Entry> tailRows(snapshot->begin() + firstSegment * capacity, snapshot->begin() + start);
+            if (!reverse) {
+                tailRows.insert(tailRows.end(), step.rows.begin(), step.rows.end());
+            }
+            return snapshot->withTailReplaced(firstSegment, std::move(tailRows));
+        }
+        case OperationStep::Kind::Replace: {
+            const std::vector<Entry>& values = reverse ? step.previous : step.rows;
+            std::vector<std::pair<size_t, Entry>> rows;
+            rows.reserve(step.indices.size());
+            for (size_t i = 0; i < step.indices.size(); ++i) {
+                if (step.indices[i] >= snapshot->size()) {
+                    return nullptr;
+                }
+                rows.emplace_back(step.indices[i], values[i]);
+            }
+            return snapshot->withReplacedRows(std::move(rows));
+        }
+        case OperationStep::Kind::Remove: {
+            // Only the segments from the one holding the first removed row are rebuilt
+            size_t firstSegment = step.indices.empty() ? 0 : step.indices.front() / capacity;
+            size_t firstRow = firstSegment * capacity;
+            size_t sizeBefore = reverse ? snapshot->size() + step.rows.size() : snapshot->size();
+            if (sizeBefore < firstRow || (!step.keys.empty() && firstRow + step.keys.size() != sizeBefore)) {
+                return nullptr;
+            }
+            std::vector<Entry> tailRows;
+            tailRows.reserve(sizeBefore - firstRow);
+            if (reverse) {
+                // Merge the removed rows back in at their old positions, then restore the old keys
+                size_t removed = 0;
+                for (size_t i = firstRow; i < snapshot->size() || removed < step.rows.size();) {
+                    if (removed < step.rows.size() && step.indices[removed] == firstRow + tailRows.size()) {
+                        tailRows.push_back(step.rows[removed++]);
+                    } else if (i < snapshot->size()) {
+                        tailRows.push_back((*snapshot)[i++]);
+                    } else {
+                        return nullptr;
+                    }
+                }
+                for (size_t i = 0; i < tailRows.size(); ++i) {
+                    tailRows[i].key = step.keys.empty() ? step.firstKey + (int)i : step.keys[i];
+                }
+            } else {
+                int newKey = firstRow > 0 ? (*snapshot)[firstRow - 1].key + 1 : 1;
+                size_t removed = 0;
+                for (size_t i = firstRow; i < snapshot->size(); ++i) {
+                    if (removed < step.indices.size() && step.indices[removed] == i) {
+                        ++removed;
+                        continue;
+                    }
+                    tailRows.push_back((*snapshot)[i]);
+                    tailRows.back().key = newKey++;
+                }
+            }
+            return snapshot->withTailReplaced(firstSegment, std::move(tailRows));
+        }
+        case OperationStep::Kind::Restore: {
+            const EntrySnapshotPtr& target = reverse ? step.before : step.after;
+            std::vector<EntrySegmentPtr> segments = target->getSegments();
+            return EntrySnapshot::fromSegments(std::move(segments), snapshot->getVersion() + 1);
+        }
+    }
+    return nullptr;
+}
+
+bool EntryManager::replayOperation(bool undoing, std::string* label) {
+    const LoggedOperation* operation = undoing ? operationLog.nextUndo() : operationLog.nextRedo();
+    if (!operation) {
+        return false;
+    }
+    auto next = getEntries();
+    for (size_t i = 0; i < operation->steps.size() && next; ++i) {
+        // Undo walks the steps backwards
+        const OperationStep& step = operation->steps[undoing ? operation->steps.size() - 1 - i : i];
+        next = applyStep(next, step, undoing);
+    }
+    if (!next) {
+        std::cerr << "Error: The undo log of form " << formName << " does not match its entries and was cleared." << std::endl;
+        operationLog.clear();
+        operationLogBytes = 0;
+        return false;
+    }
+    if (label) {
+        *label = operation->label;
+    }
+
+    saveEntriesToFile(next);
+    adoptSnapshot(next);
+    rebuildDedupIndex(*next);
+    if (undoing) {
+        operationLog.markUndone();
+    } else {
+        operationLog.markRedone();
+    }
+    operationLogBytes = operationLog.memoryBytes();
+    recordCounter(undoing ? "entries.undos" : "entries.redos", 1);
+    return true;
+}
+
+bool EntryManager::undo(std::string* label) {
+    TRACE_SCOPE("EntryManager::undo");
+    WriteTransaction transaction(*this);
+    return replayOperation(true, label);
+}
+
+bool EntryManager::redo(std::string* label) {
+    TRACE_SCOPE("EntryManager::redo");
+    WriteTransaction transaction(*this);
+    return replayOperation(false, label);
+}
+
+size_t EntryManager::getUndoDepth() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return operationLog.undoDepth();
+}
+
+size_t EntryManager::getRedoDepth() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return operationLog.redoDepth();
+}
+
+void EntryManager::setUndoLimits(size_t operations, size_t memoryBytes) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    operationLog.setLimits(operations, memoryBytes);
+    operationLogBytes = operationLog.memoryBytes();
+}
+
+void EntryManager::saveSnapshot(const std::string& name) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    namedSnapshots[name] = getEntries(); // Holds the segment list, not a copy of the rows
+}
+
+bool EntryManager::restoreSnapshot(const std::string& name) {
+    TRACE_SCOPE("EntryManager::restoreSnapshot");
+    WriteTransaction transaction(*this);
+    auto found = namedSnapshots.find(name);
+    if (found == namedSnapshots.end()) {
+        return false;
+    }
+    OperationStep step;
+    step.kind = OperationStep::Kind::Restore;
+    step.before = getEntries();
+    step.after = found->second;
+    auto next = applyStep(step.before, step, false);
+    recordOperation({"restore " + name, {std::move(step)}});
+
+    // Partitions whose segments are still those of the snapshot are not rewritten
+    saveEntriesToFile(next);
+    adoptSnapshot(next);
+    rebuildDedupIndex(*next);
+    return true;
+}
+
+bool EntryManager::dropSnapshot(const std::string& name) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    return namedSnapshots.erase(name) > 0;
+}
+
+std::vector<std::string> EntryManager::listSnapshots() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    std::vector<std::string> names;
+    for (const auto& pair : namedSnapshots) {
+        names.push_back(pair.first);
+    }
+    return names;
+}
@@ -4,47 +4,190 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <any> // For storing different types of data
 #include <memory> // For std::shared_ptr
+#include <mutex> // For std::mutex
+#include <atomic> // For std::atomic
+#include <thread> // For std::thread
+#include <functional> // For std::function
 #include "FormDefinition.h" // To know the form structure
+#include "FieldValue.h" // For FieldValue
+#include "EntrySnapshot.h" // For EntrySnapshot
+#include "FormStats.h" // For FormStats
+#include "ColumnWidthStats.h" // For ColumnWidthStats
+#include "PartitionStore.h" // For PartitionStore
+#include "EntryDeduplication.h" // For DedupIndex
+#include "TimestampIndex.h" // For TimestampIndex
+#include "OperationLog.h" // For OperationLog
+
+class EntryFilter;
+class SchemaMigration;
 
 // Forward declaration of EntryManager
 class EntryManager;
 
 // Declare the global EntryManager instance
-extern std::unique_ptr<EntryManager> currentEntryManager;
+extern std::shared_ptr<EntryManager> currentEntryManager;
 
 // A single entry, which is a collection of key-value pairs based on a form definition
 struct Entry {
     int key; // Automatically assigned key number
-    std::map<std::string, std::any> data; // Stores the actual data for each field
+    std::map<std::string, FieldValue> data; // Stores the actual data for each field
 
     // Constructor to initialize with a key
     Entry(int k) : key(k) {}
 };
 
-// Class to manage entries for a specific form
+// Selects rows for the bulk operations, e.g. EntryFilter::matches
+using EntryPredicate = std::function<bool(const Entry&)>;
+
+// Class to manage entries for a specific form.
+// Readers work on an immutable EntrySnapshot and never block; writers serialize on
+// writeMutex, build a copy-on-write successor snapshot and publish it atomically.
 class EntryManager {
 private:
     std::string formName;
-    std::string entriesFilePath;
-    std::vector<Entry> entries;
+    PartitionStore store; // Partition files and manifest on disk
+    EntrySnapshotPtr entries; // Current published snapshot, guarded by snapshotMutex
+    mutable std::mutex snapshotMutex; // Held only to read or swap 'entries'
+    mutable std::mutex writeMutex; // Serializes writers among themselves
     int nextKey;
+    std::atomic<size_t> approximateBytes; // Running estimate of the heap held by 'entries'
+    std::atomic<double> lastLoadMillis; // Duration of the last loadEntriesFromFile
+    ColumnWidthStats widthStats; // Display widths of the current entries, guarded by widthMutex
+    mutable std::mutex widthMutex;
+    uint64_t schemaHash; // Schema of the form definition the entries were opened with, 0 if none was given
+    std::shared_ptr<const SchemaMigration> schemaMigration; // To that schema; null if none was given
+    std::thread schemaRewriteThread; // Background rewrite after a schema change, joined on destruction
+    DedupIndex dedupIndex; // Content hashes when the form has a uniqueness mode, guarded by writeMutex
+    std::atomic<size_t> dedupIndexBytes; // Last dedupIndex.memoryBytes(), readable without writeMutex
+    // Field name -> range index of the latest snapshot it was asked for, guarded by timestampIndexMutex
+    mutable std::map<std::string, std::shared_ptr<const TimestampIndex>> timestampIndexes;
+    mutable std::mutex timestampIndexMutex;
+    OperationLog operationLog; // Inverse steps of this session's writes, guarded by writeMutex
+    std::atomic<size_t> operationLogBytes; // Last operationLog.memoryBytes(), readable without writeMutex
+    std::map<std::string, EntrySnapshotPtr> namedSnapshots; // Guarded by writeMutex
+
+    // Held by every write: writeMutex orders this process's writers and the form's exclusive
+    // file lock orders them with other processes. Saves made elsewhere are reloaded first, so
+    // the write applies to the latest rows and none of those saves is overwritten.
+    class WriteTransaction {
+    private:
+        EntryManager& manager;
+        std::lock_guard<std::mutex> threadLock;
 
-    void saveEntriesToFile();
+    public:
+        explicit WriteTransaction(EntryManager& manager);
+        ~WriteTransaction();
+    };
+
+    void saveEntriesToFile(const EntrySnapshotPtr& snapshot, bool rewriteAll = false); // Caller must hold writeMutex
     void loadEntriesFromFile();
+    void rewriteForSchema();
+    void publish(EntrySnapshotPtr snapshot);
+    void removeAndRenumber(int key, bool& found); // Caller must hold writeMutex
+    // Caller must hold writeMutex; the removal is logged for undo under 'label' ("delete N entries" if empty)
+    size_t removeMatching(const EntryPredicate& match, size_t firstIndex, const std::string& label);
+    bool updateLocked(int key, const std::map<std::string, FieldValue>& changes); // Caller must hold writeMutex
+    void rebuildDedupIndex(const EntrySnapshot& snapshot); // Caller must hold writeMutex
+    // Publishes a snapshot that is not derived by a write, e.g. a reload or an undo, updating the
+    // estimates from the segments it does not share with the current one. Caller must hold writeMutex.
+    void adoptSnapshot(EntrySnapshotPtr next);
+    void recordOperation(LoggedOperation&& operation); // Caller must hold writeMutex
+    // Applies 'step' (or its inverse) to 'snapshot'; null if the step does not fit it
+    static EntrySnapshotPtr applyStep(const EntrySnapshotPtr& snapshot, const OperationStep& step, bool reverse);
+    bool replayOperation(bool undoing, std::string* label); // Caller must hold writeMutex
+    bool reloadLocked(); // reloadIfChanged() for a caller that holds writeMutex
+
+    using EntryLookup = std::function<const Entry*(int key)>;
+    static EntryLookup lookupIn(const EntrySnapshotPtr& snapshot);
 
 public:
-    EntryManager(const std::string& formName);
+    // With a form definition, rows stored under a different schema are migrated to it lazily,
+    // one snapshot segment at a time on first access (see SchemaMigration)
+    EntryManager(const std::string& formName, const std::shared_ptr<FormDefinition>& formDef = nullptr);
+    ~EntryManager();
 
+    EntryManager(const EntryManager&) = delete;
+    EntryManager& operator=(const EntryManager&) = delete;
+
+    // Interactive operations driven by std::cin
     void addEntry(const std::shared_ptr<FormDefinition>& formDef);
     void editEntry(int key, const std::shared_ptr<FormDefinition>& formDef);
-    void viewEntries(int page = 1, int entriesPerPage = 5);
+    // Shows one page; with a sort field only that page is selected and sorted (top-K)
+    void viewEntries(int page = 1, int entriesPerPage = 5, const std::string& sortField = "", bool descending = false);
     void deleteEntry(int key);
     void resetEntryNumbering(); // Resets keys after deletion
 
-    const std::vector<Entry>& getEntries() const { return entries; }
+    // Programmatic operations; each is atomic with respect to readers and persists once
+    // Returns the assigned key. With a uniqueness mode, a duplicate returns the existing row's
+    // key and sets '*duplicate'; in merge mode the existing row takes the new values.
+    int insertEntry(const std::map<std::string, FieldValue>& data, bool* duplicate = nullptr);
+    bool updateEntry(int key, const std::map<std::string, FieldValue>& changes); // Merges the given fields
+    bool removeEntry(int key); // Deletes and renumbers, returns false if the key is absent
+    // Appends all rows, persists once; returns how many were added (duplicates are counted in '*duplicates')
+    size_t importEntries(const std::vector<std::map<std::string, FieldValue>>& rows, size_t* duplicates = nullptr);
+
+    // Bulk operations: one pass over the entries and one persist, however many rows match.
+    // Segments before the first change are shared with the previous snapshot.
+    size_t removeEntries(const EntryPredicate& match); // Deletes matches and renumbers, returns how many
+    size_t updateEntries(const EntryPredicate& match, const std::map<std::string, FieldValue>& changes); // Returns rows changed
+
+    // Uniqueness mode, recorded in the manifest; enabling it does not remove existing duplicates
+    void setDedupSettings(const DedupSettings& settings);
+    DedupSettings getDedupSettings() const;
+    // Offline dedup pass: keeps the first of each set of duplicate rows, one pass and one persist
+    size_t removeDuplicates();
+
+    // Range index of a timestamp field over 'snapshot', built on first use and extended
+    // incrementally for later snapshots
+    std::shared_ptr<const TimestampIndex> getTimestampIndex(const EntrySnapshotPtr& snapshot, const std::string& fieldName) const;
+    // Row indices of 'snapshot' that match 'filter', in row order. When the filter bounds a
+    // timestamp field, only the rows its range index finds in those bounds are checked.
+    std::vector<size_t> findMatchingRows(const EntrySnapshotPtr& snapshot, const EntryFilter& filter) const;
+
+    // Picks up a save made by another process sharing Forms/: a stat() of the manifest when
+    // nothing changed, otherwise only the changed partitions are read. Returns whether it reloaded.
+    bool reloadIfChanged();
+
+    // Undo and redo of this session's add, edit, delete, import and bulk operations. Each write
+    // logs only the rows it touched; a reload of another process's changes clears the log.
+    // Returns false when there is nothing to undo or redo; 'label' names the operation.
+    bool undo(std::string* label = nullptr);
+    bool redo(std::string* label = nullptr);
+    size_t getUndoDepth() const;
+    size_t getRedoDepth() const;
+    void setUndoLimits(size_t operations, size_t memoryBytes);
+
+    // Named snapshots share their segments with the form, so saving one is O(1) and restoring
+    // it writes only the partitions that differ. They live for the session; a restore can be undone.
+    void saveSnapshot(const std::string& name);
+    bool restoreSnapshot(const std::string& name);
+    bool dropSnapshot(const std::string& name);
+    std::vector<std::string> listSnapshots() const;
+
+    // Rewrites the entries file from the current snapshot
+    void persist(bool rewriteAll = false); // Writes partitions that changed since the last save, or all of them
+
+    // Consistent snapshot of the entries; stays valid and unchanged while writers proceed
+    EntrySnapshotPtr getEntries() const;
     std::string getFormName() const { return formName; } // Getter for formName
+    uint64_t getSchemaHash() const { return schemaHash; }
+
+    // Estimated memory held by the loaded entries, maintained incrementally
+    size_t getApproximateMemoryUsage() const { return approximateBytes; }
+    static size_t entryFootprint(const Entry& entry);
+
+    // Column widths (KEY first, then one per field) for a table layout that is the same on every page
+    std::vector<size_t> getColumnLayout(const FormDefinition& formDef) const;
+    ColumnWidthStats getWidthStats() const;
+
+    // Per-column, per-type and index memory accounting in one pass over the current snapshot
+    FormStats computeStats() const;
+
+    // Directory holding the form's partition files and manifest
+    static std::string entriesDirectoryFor(const std::string& formName);
+    // Sidecar file that persists the column width statistics next to the partitions
+    static std::string widthStatsFilePathFor(const std::string& formName);
 };
 
 #endif // ENTRY_H
@@ -0,0 +1,249 @@
+#include "EntryDeduplication.h"
+#include "Entry.h" // For Entry struct
+#include "EntrySnapshot.h" // For EntrySnapshot
+#include "FormDefinition.h" // For FormDefinition struct
+#include <type_traits> // For std::is_same_v, std::is_floating_point_v
+#include <sstream>
+
+namespace {
+
+const uint64_t kPrime1 = 11400714785074694791ULL;
+const uint64_t kPrime2 = 14029467366897019727ULL;
+const uint64_t kPrime3 = 1609587929392839161ULL;
+const uint64_t kPrime4 = 9650029242287828579ULL;
+const uint64_t kPrime5 = 2870177450012600261ULL;
+
+uint64_t rotateLeft(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t read64(const unsigned char* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i]; // Little-endian regardless of the host
+    }
+    return value;
+}
+
+uint32_t read32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint64_t round64(uint64_t accumulator, uint64_t input) {
+    accumulator += input * kPrime2;
+    return rotateLeft(accumulator, 31) * kPrime1;
+}
+
+uint64_t mergeRound(uint64_t hash, uint64_t value) {
+    hash ^= round64(0, value);
+    return hash * kPrime1 + kPrime4;
+}
+
+void appendBytes(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+// Kind tag, then the value's bytes; strings are length-prefixed so field boundaries are unambiguous
+void encodeValue(const FieldValue& value, std::string& out) {
+    out.push_back((char)fieldKindOf(value));
+    visitFieldValue(value, [&out](const auto& typed) {
+        using T = std::decay_t<decltype(typed)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            uint64_t length = typed.size();
+            appendBytes(out, &length, sizeof(length));
+            out += typed;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            T normalized = typed == T(0) ? T(0) : typed; // -0.0 and 0.0 compare equal, so encode them alike
+            appendBytes(out, &normalized, sizeof(normalized));
+        } else {
+            appendBytes(out, &typed, sizeof(typed));
+        }
+    });
+}
+
+} // namespace
+
+uint64_t xxHash64(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        do {
+            v1 = round64(v1, read64(p));
+            v2 = round64(v2, read64(p + 8));
+            v3 = round64(v3, read64(p + 16));
+            v4 = round64(v4, read64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    } else {
+        hash = seed + kPrime5;
+    }
+    hash += size;
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= round64(0, read64(p));
+        hash = rotateLeft(hash, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        hash ^= (uint64_t)read32(p) * kPrime1;
+        hash = rotateLeft(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= (*p) * kPrime5;
+        hash = rotateLeft(hash, 11) * kPrime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string DedupSettings::toSpec() const {
+    if (mode == Mode::Off) {
+        return "";
+    }
+    std::string spec = mode == Mode::Reject ? "reject:" : "merge:";
+    for (size_t i = 0; i < fields.size(); ++i) {
+        spec += (i > 0 ? "," : "") + fields[i];
+    }
+    return spec;
+}
+
+bool DedupSettings::parseMode(const std::string& name, Mode& out) {
+    if (name == "off") {
+        out = Mode::Off;
+    } else if (name == "reject") {
+        out = Mode::Reject;
+    } else if (name == "merge") {
+        out = Mode::Merge;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool DedupSettings::parseSpec(const std::string& spec, DedupSettings& out) {
+    out = DedupSettings();
+    if (spec.empty()) {
+        return true;
+    }
+    std::stringstream ss(spec);
+    std::string modeName, field;
+    std::getline(ss, modeName, ':');
+    if (!parseMode(modeName, out.mode)) {
+        return false;
+    }
+    while (std::getline(ss, field, ',')) {
+        if (!field.empty()) {
+            out.fields.push_back(field);
+        }
+    }
+    return true;
+}
+
+bool DedupSettings::checkFields(const FormDefinition& formDef, std::string& error) const {
+    for (const auto& fieldName : fields) {
+        bool found = false;
+        for (const auto& field : formDef.fields) {
+            found = found || field->name == fieldName;
+        }
+        if (!found) {
+            error = "Unknown field '" + fieldName + "'";
+            return false;
+        }
+    }
+    return true;
+}
+
+void DedupIndex::encode(const std::map<std::string, FieldValue>& data, std::string& out) const {
+    out.clear();
+    auto encodeField = [&](const std::string& name, const FieldValue* value) {
+        appendBytes(out, name.c_str(), name.size() + 1);
+        if (value) {
+            encodeValue(*value, out);
+        } else {
+            out.push_back((char)0xFF); // Absent
+        }
+    };
+    if (settings.fields.empty()) {
+        for (const auto& pair : data) { // std::map order is the canonical field order
+            encodeField(pair.first, &pair.second);
+        }
+        return;
+    }
+    for (const auto& name : settings.fields) {
+        auto it = data.find(name);
+        encodeField(name, it == data.end() ? nullptr : &it->second);
+    }
+}
+
+bool DedupIndex::sameIdentity(const std::map<std::string, FieldValue>& a, const std::map<std::string, FieldValue>& b) const {
+    if (settings.fields.empty()) {
+        return a == b;
+    }
+    for (const auto& name : settings.fields) {
+        auto left = a.find(name);
+        auto right = b.find(name);
+        if ((left == a.end()) != (right == b.end()) || (left != a.end() && left->second != right->second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t DedupIndex::hashOf(const std::map<std::string, FieldValue>& data) const {
+    thread_local std::string encoded; // Reused to avoid an allocation per row
+    encode(data, encoded);
+    return xxHash64(encoded.data(), encoded.size());
+}
+
+int DedupIndex::findDuplicate(const std::map<std::string, FieldValue>& data, uint64_t hash, const RowLookup& rowForKey) const {
+    auto range = keysByHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const Entry* row = rowForKey(it->second);
+        if (row && sameIdentity(row->data, data)) {
+            return it->second;
+        }
+    }
+    return 0;
+}
+
+void DedupIndex::remove(uint64_t hash, int key) {
+    auto range = keysByHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == key) {
+            keysByHash.erase(it);
+            return;
+        }
+    }
+}
+
+void DedupIndex::rebuild(const EntrySnapshot& rows) {
+    keysByHash.clear();
+    if (!settings.enabled()) {
+        return;
+    }
+    keysByHash.reserve(rows.size());
+    for (const Entry& entry : rows) {
+        add(hashOf(entry.data), entry.key);
+    }
+}
+
+size_t DedupIndex::memoryBytes() const {
+    // Per node: hash, key and the bucket chain pointer, plus one bucket slot per bucket
+    return keysByHash.size() * (sizeof(std::pair<const uint64_t, int>) + sizeof(void*)) + keysByHash.bucket_count() * sizeof(void*);
+}
@@ -0,0 +1,71 @@
+#ifndef ENTRY_DEDUPLICATION_H
+#define ENTRY_DEDUPLICATION_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional> // For std::function
+#include <cstdint>
+#include "FieldValue.h" // For FieldValue
+
+struct Entry;
+struct FormDefinition;
+class EntrySnapshot;
+
+// xxHash64 (XXH64) of 'size' bytes
+uint64_t xxHash64(const void* data, size_t size, uint64_t seed = 0);
+
+// Per-form uniqueness mode, stored in the partition manifest as "<mode>:<field,field>".
+// Two rows are duplicates when their identity fields (all fields if none are listed) hold
+// the same values. On add/import a duplicate is either rejected, leaving the existing row
+// as it is, or merged, copying the new row's other fields into the existing row.
+struct DedupSettings {
+    enum class Mode { Off, Reject, Merge };
+
+    Mode mode = Mode::Off;
+    std::vector<std::string> fields; // Identity fields; empty means every field
+
+    bool enabled() const { return mode != Mode::Off; }
+
+    std::string toSpec() const; // "" when off
+    static bool parseSpec(const std::string& spec, DedupSettings& out); // Returns false for unknown modes
+    static bool parseMode(const std::string& name, Mode& out); // "off", "reject" or "merge"
+
+    // Sets 'error' and returns false if an identity field is not part of the form
+    bool checkFields(const FormDefinition& formDef, std::string& error) const;
+};
+
+// Content hashes of a form's rows, for O(1) duplicate checks. Each row's identity fields are
+// encoded canonically (name, kind and value bytes, in field-name order) and hashed with
+// xxHash64; a hash hit is confirmed by comparing the values, so collisions cannot merge
+// different rows.
+class DedupIndex {
+private:
+    DedupSettings settings;
+    std::unordered_multimap<uint64_t, int> keysByHash;
+
+    void encode(const std::map<std::string, FieldValue>& data, std::string& out) const;
+    bool sameIdentity(const std::map<std::string, FieldValue>& a, const std::map<std::string, FieldValue>& b) const;
+
+public:
+    void configure(const DedupSettings& newSettings) { settings = newSettings; keysByHash.clear(); }
+    const DedupSettings& getSettings() const { return settings; }
+
+    uint64_t hashOf(const std::map<std::string, FieldValue>& data) const;
+
+    // Key of an indexed row with the same identity as 'data', or 0 if there is none.
+    // 'rowForKey' returns the current row for an indexed key (or null).
+    using RowLookup = std::function<const Entry*(int key)>;
+    int findDuplicate(const std::map<std::string, FieldValue>& data, uint64_t hash, const RowLookup& rowForKey) const;
+
+    void add(uint64_t hash, int key) { keysByHash.emplace(hash, key); }
+    void remove(uint64_t hash, int key);
+    void rebuild(const EntrySnapshot& rows); // After keys were renumbered
+    void clear() { keysByHash.clear(); }
+
+    size_t size() const { return keysByHash.size(); }
+    size_t memoryBytes() const;
+};
+
+#endif // ENTRY_DEDUPLICATION_H
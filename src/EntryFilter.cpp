@@ -0,0 +1,236 @@
+#include "EntryFilter.h"
+#include "FormDefinition.h" // For FormDefinition, SelectField
+#include "Entry.h" // For Entry struct
+#include <cstdlib> // For std::strtol
+#include <type_traits> // For std::is_arithmetic_v
+#include <algorithm> // For std::min, std::max
+#include <cstdint> // For INT64_MIN, INT64_MAX
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool parseInt(const std::string& text, int& out) {
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    long value = std::strtol(begin, &end, 10);
+    if (end == begin || *end != '\0') {
+        return false;
+    }
+    out = (int)value;
+    return true;
+}
+
+// Three-way comparison of a stored value with a condition value; false if they cannot be compared
+bool compareValues(const FieldValue& stored, const FieldValue& wanted, int& order) {
+    const std::string* storedText = std::get_if<std::string>(&stored);
+    const std::string* wantedText = std::get_if<std::string>(&wanted);
+    if (storedText || wantedText) {
+        if (!storedText || !wantedText) {
+            return false;
+        }
+        order = storedText->compare(*wantedText);
+        return true;
+    }
+    const Timestamp* storedTime = std::get_if<Timestamp>(&stored);
+    const Timestamp* wantedTime = std::get_if<Timestamp>(&wanted);
+    if (storedTime || wantedTime) {
+        if (!storedTime || !wantedTime) {
+            return false;
+        }
+        order = *storedTime < *wantedTime ? -1 : (*storedTime > *wantedTime ? 1 : 0);
+        return true;
+    }
+    auto toDouble = [](const auto& typed) -> double {
+        if constexpr (std::is_arithmetic_v<std::decay_t<decltype(typed)>>) {
+            return static_cast<double>(typed);
+        } else {
+            return 0.0;
+        }
+    };
+    double a = visitFieldValue(stored, toDouble);
+    double b = visitFieldValue(wanted, toDouble);
+    order = a < b ? -1 : (a > b ? 1 : 0);
+    return true;
+}
+
+bool holds(EntryFilter::Op op, int order) {
+    switch (op) {
+        case EntryFilter::Op::Equal: return order == 0;
+        case EntryFilter::Op::NotEqual: return order != 0;
+        case EntryFilter::Op::Less: return order < 0;
+        case EntryFilter::Op::LessEqual: return order <= 0;
+        case EntryFilter::Op::Greater: return order > 0;
+        case EntryFilter::Op::GreaterEqual: return order >= 0;
+    }
+    return false;
+}
+
+// Finds the operator in "field op value"; two-character operators are tried first
+bool splitCondition(const std::string& clause, std::string& field, EntryFilter::Op& op, std::string& value) {
+    static const struct { const char* text; EntryFilter::Op op; } kOperators[] = {
+        {"!=", EntryFilter::Op::NotEqual}, {"<=", EntryFilter::Op::LessEqual}, {">=", EntryFilter::Op::GreaterEqual},
+        {"=", EntryFilter::Op::Equal}, {"<", EntryFilter::Op::Less}, {">", EntryFilter::Op::Greater},
+    };
+    size_t position = clause.find_first_of("!<>=");
+    if (position == std::string::npos) {
+        return false;
+    }
+    for (const auto& candidate : kOperators) {
+        if (clause.compare(position, std::char_traits<char>::length(candidate.text), candidate.text) == 0) {
+            field = trim(clause.substr(0, position));
+            op = candidate.op;
+            value = trim(clause.substr(position + std::char_traits<char>::length(candidate.text)));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                value = value.substr(1, value.size() - 2);
+            }
+            return !field.empty();
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+void EntryFilter::addKeyCondition(Op op, int key) {
+    conditions.push_back({"", op, key});
+}
+
+void EntryFilter::addFieldCondition(const std::string& field, Op op, const FieldValue& value) {
+    conditions.push_back({field, op, value});
+}
+
+bool EntryFilter::matches(const Entry& entry) const {
+    for (const auto& condition : conditions) {
+        int order = 0;
+        if (condition.field.empty()) {
+            order = entry.key < std::get<int>(condition.value) ? -1 : (entry.key > std::get<int>(condition.value) ? 1 : 0);
+        } else {
+            auto stored = entry.data.find(condition.field);
+            if (stored == entry.data.end() || !compareValues(stored->second, condition.value, order)) {
+                if (condition.op != Op::NotEqual) {
+                    return false;
+                }
+                continue;
+            }
+        }
+        if (!holds(condition.op, order)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EntryFilter::timeBounds(std::string& field, Timestamp& from, Timestamp& to) const {
+    field.clear();
+    from.millis = INT64_MIN;
+    to.millis = INT64_MAX;
+    for (const auto& condition : conditions) {
+        const Timestamp* time = std::get_if<Timestamp>(&condition.value);
+        if (!time || (!field.empty() && condition.field != field)) {
+            continue;
+        }
+        field = condition.field;
+        switch (condition.op) {
+            case Op::Equal:
+                from = std::max(from, *time);
+                to = std::min(to, *time);
+                break;
+            case Op::Greater:
+                from = std::max(from, Timestamp{time->millis + 1});
+                break;
+            case Op::GreaterEqual:
+                from = std::max(from, *time);
+                break;
+            case Op::Less:
+                to = std::min(to, Timestamp{time->millis - 1});
+                break;
+            case Op::LessEqual:
+                to = std::min(to, *time);
+                break;
+            case Op::NotEqual:
+                break;
+        }
+    }
+    return !field.empty();
+}
+
+bool EntryFilter::parse(const FormDefinition& formDef, const std::string& text, EntryFilter& out, std::string& error) {
+    out.conditions.clear();
+    std::string rest = text;
+    while (true) {
+        size_t separator = rest.find(" and ");
+        std::string clause = trim(rest.substr(0, separator));
+
+        int first, last;
+        size_t dash = clause.find('-', 1); // A leading '-' belongs to a negative key
+        std::string field, value;
+        Op op;
+        if (dash != std::string::npos && clause.find_first_of("!<>=") == std::string::npos
+            && parseInt(trim(clause.substr(0, dash)), first) && parseInt(trim(clause.substr(dash + 1)), last)) {
+            out.addKeyCondition(Op::GreaterEqual, first);
+            out.addKeyCondition(Op::LessEqual, last);
+        } else if (!splitCondition(clause, field, op, value)) {
+            error = "Expected a key range like 10-20 or a condition like 'field = value', got '" + clause + "'";
+            return false;
+        } else if (field == "key") {
+            int key;
+            if (!parseInt(value, key)) {
+                error = "Key conditions need a whole number, got '" + value + "'";
+                return false;
+            }
+            out.addKeyCondition(op, key);
+        } else {
+            std::shared_ptr<FormField> formField;
+            for (const auto& candidate : formDef.fields) {
+                if (candidate->name == field) {
+                    formField = candidate;
+                }
+            }
+            FieldValue parsed;
+            if (!formField) {
+                error = "Unknown field '" + field + "'";
+                return false;
+            }
+            if (!parseFieldInput(*formField, value, parsed)) {
+                error = "'" + value + "' is not a valid value for field '" + field + "'";
+                return false;
+            }
+            out.addFieldCondition(field, op, parsed);
+        }
+
+        if (separator == std::string::npos) {
+            return true;
+        }
+        rest = rest.substr(separator + 5);
+    }
+}
+
+bool parseFieldInput(const FormField& field, const std::string& text, FieldValue& out) {
+    if (field.type == "select") {
+        const auto& options = static_cast<const SelectField&>(field).options;
+        int number;
+        if (parseInt(text, number) && options.count(number)) {
+            out = options.at(number);
+            return true;
+        }
+        for (const auto& option : options) {
+            if (option.second == text) {
+                out = option.second;
+                return true;
+            }
+        }
+        return false;
+    }
+    if ((field.type == "number" || field.type == "timestamp") && trim(text).empty()) {
+        return false;
+    }
+    return parseFieldValue(fieldKindFor(field), text, out);
+}
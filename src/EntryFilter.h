@@ -0,0 +1,52 @@
+#ifndef ENTRY_FILTER_H
+#define ENTRY_FILTER_H
+
+#include <string>
+#include <vector>
+#include "FieldValue.h" // For FieldValue
+
+struct FormDefinition;
+struct FormField;
+struct Entry;
+
+// Selects the rows a bulk update or delete applies to. Every condition must hold.
+// Text form, as typed at the prompts and sent by service clients:
+//   "10-20"                            keys 10 to 20 inclusive
+//   "status = done and qty >= 5"      field conditions joined by "and"
+//   "key > 100"                        "key" compares the entry key
+// Operators are = != < <= > >=. Values are parsed with the field's kind; select fields take
+// an option number or option text, timestamp fields ISO-8601 ("ts >= 2024-05-01T08:00").
+// Numbers compare numerically, text lexicographically, timestamps chronologically.
+// A row without the field matches only "!=".
+class EntryFilter {
+public:
+    enum class Op { Equal, NotEqual, Less, LessEqual, Greater, GreaterEqual };
+
+private:
+    struct Condition {
+        std::string field; // Empty for the entry key
+        Op op;
+        FieldValue value;
+    };
+
+    std::vector<Condition> conditions;
+
+public:
+    void addKeyCondition(Op op, int key);
+    void addFieldCondition(const std::string& field, Op op, const FieldValue& value);
+
+    bool matches(const Entry& entry) const;
+    bool empty() const { return conditions.empty(); } // An empty filter matches every row
+
+    // Range [from, to] that the conditions on the first timestamp field they mention allow;
+    // returns false if no condition compares a timestamp. Rows outside the range cannot match.
+    bool timeBounds(std::string& field, Timestamp& from, Timestamp& to) const;
+
+    // Parses the text form against 'formDef'; on failure 'error' says why
+    static bool parse(const FormDefinition& formDef, const std::string& text, EntryFilter& out, std::string& error);
+};
+
+// Converts typed input for 'field' to the value stored for it (select fields store the option text)
+bool parseFieldInput(const FormField& field, const std::string& text, FieldValue& out);
+
+#endif // ENTRY_FILTER_H
@@ -0,0 +1,100 @@
+#include "EntryManagerPool.h"
+#include "SchemaMigration.h" // For schemaHashOf
+#include "FormDefinition.h" // For currentSelectedForm
+#include <iostream>
+
+// Global pool definition
+EntryManagerPool entryManagerPool;
+
+EntryManagerPool::EntryManagerPool(size_t maxManagers, size_t memoryBudgetBytes)
+    : maxManagers(maxManagers), memoryBudgetBytes(memoryBudgetBytes) {}
+
+std::shared_ptr<EntryManager> EntryManagerPool::acquire(const std::string& formName, const std::shared_ptr<FormDefinition>& formDef) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    auto it = slots.find(formName);
+    if (it != slots.end() && formDef && it->second.manager->getSchemaHash() != schemaHashOf(*formDef)) {
+        // The .form file changed since this manager was opened
+        lruOrder.erase(it->second.lruPosition);
+        slots.erase(it);
+        it = slots.end();
+    }
+    if (it != slots.end()) {
+        // Hit: move to the front of the LRU list
+        lruOrder.splice(lruOrder.begin(), lruOrder, it->second.lruPosition);
+        auto manager = it->second.manager;
+        manager->reloadIfChanged(); // Another process may have saved the form since
+        enforceLimits(); // Other managers may have grown since they were last checked
+        return manager;
+    }
+
+    auto manager = std::make_shared<EntryManager>(formName, formDef);
+    lruOrder.push_front(formName);
+    slots[formName] = PoolSlot{manager, lruOrder.begin()};
+    enforceLimits();
+    return manager;
+}
+
+void EntryManagerPool::evict(const std::string& formName) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    auto it = slots.find(formName);
+    if (it == slots.end()) {
+        return;
+    }
+    lruOrder.erase(it->second.lruPosition);
+    slots.erase(it);
+}
+
+void EntryManagerPool::clear() {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    slots.clear();
+    lruOrder.clear();
+}
+
+size_t EntryManagerPool::size() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return slots.size();
+}
+
+size_t EntryManagerPool::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return memoryUsageLocked();
+}
+
+size_t EntryManagerPool::memoryUsageLocked() const {
+    size_t total = 0;
+    for (const auto& pair : slots) {
+        total += pair.second.manager->getApproximateMemoryUsage();
+    }
+    return total;
+}
+
+void EntryManagerPool::setLimits(size_t newMaxManagers, size_t newMemoryBudgetBytes) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    maxManagers = newMaxManagers;
+    memoryBudgetBytes = newMemoryBudgetBytes;
+    enforceLimits();
+}
+
+void EntryManagerPool::enforceLimits() {
+    // Never evict the most recently used manager, it is the one the caller is about to use.
+    // Managers still referenced elsewhere (e.g. currentEntryManager) stay alive until released.
+    size_t usage = memoryUsageLocked();
+    while (slots.size() > 1 && (slots.size() > maxManagers || usage > memoryBudgetBytes)) {
+        const std::string& victim = lruOrder.back();
+        auto it = slots.find(victim);
+        usage -= it->second.manager->getApproximateMemoryUsage();
+        slots.erase(it);
+        lruOrder.pop_back();
+    }
+}
+
+std::shared_ptr<EntryManager> acquireSelectedManager(std::shared_ptr<FormDefinition>& selectedForm) {
+    selectedForm = std::atomic_load(&currentSelectedForm);
+    if (!selectedForm) {
+        std::cout << "No form is currently selected. Please select a form first (Option 3).\n";
+        return nullptr;
+    }
+    auto manager = entryManagerPool.acquire(selectedForm->name, selectedForm);
+    std::atomic_store(&currentEntryManager, manager);
+    return manager;
+}
@@ -0,0 +1,59 @@
+#ifndef ENTRY_MANAGER_POOL_H
+#define ENTRY_MANAGER_POOL_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <memory> // For std::shared_ptr
+#include <mutex> // For std::mutex
+#include "Entry.h" // For EntryManager
+
+// Bounded LRU pool of open EntryManagers keyed by form name.
+// Switching back to a recently used form reuses its loaded entries instead of
+// reloading the file; the least recently used managers are evicted once either
+// the manager count or the combined memory estimate exceeds its limit.
+class EntryManagerPool {
+private:
+    struct PoolSlot {
+        std::shared_ptr<EntryManager> manager;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    size_t maxManagers;
+    size_t memoryBudgetBytes;
+    std::list<std::string> lruOrder; // Front is the most recently used form
+    std::unordered_map<std::string, PoolSlot> slots;
+    mutable std::mutex poolMutex; // Acquire may be called from several threads
+
+    void enforceLimits(); // Caller must hold poolMutex
+    size_t memoryUsageLocked() const;
+
+public:
+    EntryManagerPool(size_t maxManagers = 8, size_t memoryBudgetBytes = 256 * 1024 * 1024);
+
+    // Returns the open manager for the form, loading it only on a pool miss. Given the form's
+    // definition, a resident manager opened under a different schema is replaced by a fresh
+    // one, which migrates the stored rows lazily.
+    std::shared_ptr<EntryManager> acquire(const std::string& formName, const std::shared_ptr<FormDefinition>& formDef = nullptr);
+
+    // Drops the manager for a form, e.g. after the form has been deleted
+    void evict(const std::string& formName);
+    void clear();
+
+    size_t size() const;
+    size_t memoryUsage() const;
+
+    void setLimits(size_t maxManagers, size_t memoryBudgetBytes);
+};
+
+// Global pool shared by the menu actions
+extern EntryManagerPool entryManagerPool;
+
+// Start of every menu action that works on the selected form. Takes a local copy of
+// currentSelectedForm, so another thread switching forms cannot change it mid-action, and
+// returns its manager from entryManagerPool, so switching between recently used forms does not
+// reload them and every action (edits, undo log, snapshots) goes through the same manager.
+// The manager also becomes currentEntryManager. With no form selected, says so and returns null.
+std::shared_ptr<EntryManager> acquireSelectedManager(std::shared_ptr<FormDefinition>& selectedForm);
+
+#endif // ENTRY_MANAGER_POOL_H
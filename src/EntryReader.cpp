@@ -0,0 +1,250 @@
+#include "EntryReader.h"
+#include "PartitionStore.h" // For PartitionManifest
+#include <sstream>
+#include <iostream> // For std::cerr
+#include <thread>
+#include <filesystem> // For std::filesystem::file_size
+#include <algorithm> // For std::min
+#include <iterator> // For std::back_inserter
+#include <type_traits> // For std::is_same_v
+#include <charconv> // For std::from_chars
+
+namespace {
+
+// Reads the key of a "KEY:<n>" line. Uses from_chars rather than std::stoi, which throws on a
+// corrupt line and would terminate the process from a reader thread.
+bool parseKeyLine(const std::string& line, int& key) {
+    const char* end = line.data() + line.size();
+    auto result = std::from_chars(line.data() + 4, end, key);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+} // namespace
+
+bool VectorEntrySource::next(Entry& entry) {
+    if (position >= entries.size()) {
+        return false;
+    }
+    entry = entries[position++];
+    return true;
+}
+
+bool SnapshotEntrySource::next(Entry& entry) {
+    if (!snapshot || position >= snapshot->size()) {
+        return false;
+    }
+    entry = (*snapshot)[position++];
+    return true;
+}
+
+bool EntrySource::nextView(EntryView& view) {
+    if (!next(viewBuffer)) {
+        return false;
+    }
+    makeEntryView(viewBuffer, view);
+    return true;
+}
+
+void makeEntryView(const Entry& entry, EntryView& view) {
+    view.key = entry.key;
+    view.fields.clear();
+    for (const auto& pair : entry.data) {
+        FieldValueView value = visitFieldValue(pair.second, [](const auto& typed) -> FieldValueView {
+            if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, std::string>) {
+                return std::string_view(typed);
+            } else {
+                return typed;
+            }
+        });
+        view.fields.emplace_back(pair.first, value);
+    }
+}
+
+EntryFileReader::EntryFileReader(const std::string& filePath) : input(filePath), hasPendingKey(false), pendingKey(0), malformed(false) {
+    if (input.isOpen()) {
+        advanceToNextKey(); // Prime the reader so atEnd() is accurate before the first next()
+    }
+}
+
+bool EntryFileReader::advanceToNextKey() {
+    hasPendingKey = false;
+    while (std::getline(input.stream(), line)) {
+        if (line.rfind("KEY:", 0) == 0) { // Starts with "KEY:"
+            malformed = !parseKeyLine(line, pendingKey);
+            hasPendingKey = !malformed;
+            return hasPendingKey;
+        }
+    }
+    return false;
+}
+
+bool EntryFileReader::next(Entry& entry) {
+    if (!hasPendingKey) {
+        return false;
+    }
+
+    entry.key = pendingKey;
+    entry.data.clear();
+    hasPendingKey = false;
+
+    while (std::getline(input.stream(), line)) {
+        if (line.rfind("KEY:", 0) == 0) { // Next entry starts without a "---" separator
+            malformed = !parseKeyLine(line, pendingKey);
+            hasPendingKey = !malformed;
+            return true;
+        } else if (line == "---") {
+            advanceToNextKey(); // End of current entry, look ahead for the next one
+            return true;
+        } else {
+            parseEntryFieldLine(line, entry);
+        }
+    }
+    return true; // Last entry in the file
+}
+
+PartitionedEntryReader::PartitionedEntryReader(const std::string& formName, std::shared_ptr<const SchemaMigration> migration)
+    : directory(PartitionStore::directoryFor(formName)), nextPath(0), migration(std::move(migration)) {
+    PartitionManifest manifest;
+    if (manifest.loadFromFile(PartitionStore::manifestPathFor(formName))) {
+        for (const auto& part : manifest.partitions) {
+            paths.push_back(directory + "/" + part.fileName);
+        }
+        if (this->migration && manifest.schemaHash == this->migration->getTargetHash()) {
+            this->migration.reset(); // Already stored in the current schema
+        }
+    } else if (std::ifstream(PartitionStore::legacyFilePathFor(formName)).is_open()) {
+        paths.push_back(PartitionStore::legacyFilePathFor(formName));
+    }
+    openNext();
+}
+
+bool PartitionedEntryReader::openNext() {
+    current.reset();
+    while (nextPath < paths.size()) {
+        auto reader = std::make_unique<EntryFileReader>(paths[nextPath++]);
+        if (reader->isOpen() && !reader->atEnd()) {
+            current = std::move(reader);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PartitionedEntryReader::next(Entry& entry) {
+    while (current) {
+        if (current->next(entry)) {
+            if (migration) {
+                migration->migrateEntry(entry);
+            }
+            if (current->atEnd()) {
+                openNext(); // Look ahead so atEnd() is accurate
+            }
+            return true;
+        }
+        openNext();
+    }
+    return false;
+}
+
+namespace {
+
+// Parses the records whose "KEY:" line starts in [begin, end); 'malformed' is set, and reading
+// stops, at a "KEY:" line that does not hold a number
+void readEntryRange(const std::string& filePath, uintmax_t begin, uintmax_t end, std::vector<Entry>& rows, char& malformed) {
+    std::ifstream inFile(filePath);
+    std::string line;
+    uintmax_t offset = begin;
+    if (begin > 0) {
+        // Step back one byte so a range that starts exactly on a line start is not skipped
+        inFile.seekg(begin - 1);
+        std::getline(inFile, line);
+        offset = begin - 1 + line.size() + 1;
+    }
+
+    bool inRecord = false;
+    while (std::getline(inFile, line)) {
+        uintmax_t lineStart = offset;
+        offset += line.size() + 1;
+        if (line.rfind("KEY:", 0) == 0) {
+            if (lineStart >= end) {
+                break; // Belongs to the next range
+            }
+            int key;
+            if (!parseKeyLine(line, key)) {
+                malformed = true;
+                return;
+            }
+            rows.emplace_back(key);
+            inRecord = true;
+        } else if (line == "---") {
+            inRecord = false;
+        } else if (inRecord) {
+            parseEntryFieldLine(line, rows.back());
+        }
+    }
+}
+
+} // namespace
+
+bool readEntriesFile(const std::string& filePath, std::vector<Entry>& rows, unsigned threadCount) {
+    std::error_code ec;
+    uintmax_t fileBytes = std::filesystem::file_size(filePath, ec);
+    if (ec) {
+        return false;
+    }
+    if (threadCount <= 1 || fileBytes < kParallelReadMinBytes || isCompressedFile(filePath)) {
+        EntryFileReader reader(filePath);
+        if (!reader.isOpen()) {
+            return false;
+        }
+        Entry entry(0);
+        while (reader.next(entry)) {
+            rows.push_back(std::move(entry));
+            entry = Entry(0);
+        }
+        if (reader.hasMalformedKey()) {
+            std::cerr << "Error: Malformed KEY line in " << filePath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<std::vector<Entry>> parts(threadCount);
+    std::vector<char> malformed(threadCount, 0); // One flag per worker, read after the join
+    std::vector<std::thread> workers;
+    uintmax_t rangeBytes = (fileBytes + threadCount - 1) / threadCount;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        uintmax_t begin = std::min(fileBytes, i * rangeBytes);
+        uintmax_t end = std::min(fileBytes, begin + rangeBytes);
+        workers.emplace_back(readEntryRange, std::cref(filePath), begin, end, std::ref(parts[i]), std::ref(malformed[i]));
+    }
+    size_t total = rows.size();
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers[i].join();
+        total += parts[i].size();
+    }
+    if (std::find(malformed.begin(), malformed.end(), 1) != malformed.end()) {
+        std::cerr << "Error: Malformed KEY line in " << filePath << std::endl;
+        return false;
+    }
+
+    rows.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(rows));
+    }
+    return true;
+}
+
+void parseEntryFieldLine(const std::string& line, Entry& entry) {
+    std::stringstream ss(line);
+    std::string fieldName, fieldType, fieldValueStr;
+    std::getline(ss, fieldName, ':');
+    std::getline(ss, fieldType, ':');
+    std::getline(ss, fieldValueStr);
+
+    FieldKind kind;
+    FieldValue value;
+    if (parseFieldKind(fieldType, kind) && parseFieldValue(kind, fieldValueStr, value)) {
+        entry.data[fieldName] = std::move(value);
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef ENTRY_READER_H
+#define ENTRY_READER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <memory> // For std::unique_ptr
+#include "Entry.h" // For Entry struct
+#include "BlockCompression.h" // For InputFile
+#include "SchemaMigration.h" // For SchemaMigration
+#include "EntryView.h" // For EntryView
+
+// A sequential source of entries, consumed one row at a time by the exporters
+class EntrySource {
+protected:
+    Entry viewBuffer; // Row the default nextView() points into
+
+public:
+    EntrySource() : viewBuffer(0) {}
+    virtual ~EntrySource() = default;
+
+    // Fills 'entry' with the next row; returns false once the source is exhausted
+    virtual bool next(Entry& entry) = 0;
+
+    // Points 'view' at the next row, valid until the following call. The default reads the
+    // row with next(); sources that already hold the row's bytes override it to skip the copy.
+    virtual bool nextView(EntryView& view);
+};
+
+// Adapts an in-memory vector of entries to the EntrySource interface
+class VectorEntrySource : public EntrySource {
+private:
+    const std::vector<Entry>& entries;
+    size_t position;
+
+public:
+    VectorEntrySource(const std::vector<Entry>& entries) : entries(entries), position(0) {}
+
+    bool next(Entry& entry) override;
+};
+
+// Adapts a consistent EntrySnapshot; holding it keeps that version alive during the export
+class SnapshotEntrySource : public EntrySource {
+private:
+    EntrySnapshotPtr snapshot;
+    size_t position;
+
+public:
+    SnapshotEntrySource(EntrySnapshotPtr snapshot) : snapshot(std::move(snapshot)), position(0) {}
+
+    bool next(Entry& entry) override;
+};
+
+// Streams entries straight from one entries file (a partition or a legacy Forms/<form>_entries.dat) with bounded memory.
+// LZ4 compressed files are decompressed block by block as they are read.
+class EntryFileReader : public EntrySource {
+private:
+    InputFile input;
+    std::string line;
+    bool hasPendingKey; // True when a "KEY:" line has been read but not yet returned
+    int pendingKey;
+    bool malformed; // Set when reading stopped at a "KEY:" line that does not hold a number
+
+    bool advanceToNextKey();
+
+public:
+    EntryFileReader(const std::string& filePath);
+
+    bool isOpen() const { return input.isOpen(); }
+    bool atEnd() const { return !hasPendingKey; } // True when no more entries remain
+    bool hasMalformedKey() const { return malformed; } // The file is corrupt; entries after it were not read
+
+    bool next(Entry& entry) override;
+};
+
+// Streams a form's stored entries partition by partition, in key order, holding at most
+// one partition file open. Reads a legacy single entries file if the form has no manifest yet.
+// Given a SchemaMigration, rows are converted to its schema unless the manifest says they already match.
+class PartitionedEntryReader : public EntrySource {
+private:
+    std::string directory;
+    std::vector<std::string> paths; // Partition files in key order
+    size_t nextPath;
+    std::unique_ptr<EntryFileReader> current;
+    std::shared_ptr<const SchemaMigration> migration; // Null when no conversion is needed
+
+    bool openNext();
+
+public:
+    PartitionedEntryReader(const std::string& formName, std::shared_ptr<const SchemaMigration> migration = nullptr);
+
+    bool isOpen() const { return !paths.empty(); } // False when the form has nothing stored
+    bool atEnd() const { return !current || current->atEnd(); }
+
+    bool next(Entry& entry) override;
+};
+
+// Reads a whole entries file, in file order. Files of at least kParallelReadMinBytes are split
+// into 'threadCount' byte ranges; a record belongs to the range its "KEY:" line starts in, so
+// each worker seeks to its range, skips to the first record start and parses into its own
+// buffer. Compressed files are always read sequentially. Returns false if the file cannot be opened
+// or a "KEY:" line does not hold a number.
+const uintmax_t kParallelReadMinBytes = 1 << 20;
+bool readEntriesFile(const std::string& filePath, std::vector<Entry>& rows, unsigned threadCount = 1);
+
+// Parses a single "name:type:value" line of an entries file into 'entry'
+void parseEntryFieldLine(const std::string& line, Entry& entry);
+
+#endif // ENTRY_READER_H
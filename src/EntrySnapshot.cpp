@@ -0,0 +1,141 @@
+#include "EntrySnapshot.h"
+#include "Entry.h" // For Entry struct
+#include "SchemaMigration.h" // For SchemaMigration
+#include "Instrumentation.h" // For recordCounter
+#include <algorithm> // For std::min
+
+EntrySegment::EntrySegment(const EntrySegment& other) {
+    other.ensureMigrated();
+    rows = other.rows;
+}
+
+void EntrySegment::setPendingMigration(std::shared_ptr<const SchemaMigration> migration) {
+    std::lock_guard<std::mutex> lock(migrationMutex);
+    pendingMigration = std::move(migration);
+    migrationPending.store(pendingMigration != nullptr, std::memory_order_release);
+}
+
+void EntrySegment::migrateRows() const {
+    std::lock_guard<std::mutex> lock(migrationMutex);
+    if (!pendingMigration) {
+        return; // Another reader finished it while we waited
+    }
+    // The segment is logically immutable: every reader sees only migrated rows, because
+    // they all pass through here before touching 'rows'
+    auto& mutableRows = const_cast<std::vector<Entry>&>(rows);
+    int64_t changedRows = 0;
+    for (Entry& entry : mutableRows) {
+        changedRows += pendingMigration->migrateEntry(entry) ? 1 : 0;
+    }
+    recordCounter("schema.rows_migrated", changedRows);
+    pendingMigration.reset();
+    migrationPending.store(false, std::memory_order_release);
+}
+
+std::shared_ptr<const EntrySnapshot> EntrySnapshot::fromEntries(std::vector<Entry>&& entries, uint64_t version,
+                                                                std::shared_ptr<const SchemaMigration> migration) {
+    auto snapshot = std::make_shared<EntrySnapshot>();
+    snapshot->version = version;
+    snapshot->totalSize = entries.size();
+
+    for (size_t start = 0; start < entries.size(); start += kSegmentCapacity) {
+        size_t end = std::min(start + kSegmentCapacity, entries.size());
+        auto segment = std::make_shared<EntrySegment>();
+        segment->rows.reserve(end - start);
+        for (size_t i = start; i < end; ++i) {
+            segment->rows.push_back(std::move(entries[i]));
+        }
+        if (migration) {
+            segment->setPendingMigration(migration);
+        }
+        snapshot->segments.push_back(std::move(segment));
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const EntrySnapshot> EntrySnapshot::fromSegments(std::vector<EntrySegmentPtr>&& segments, uint64_t version) {
+    auto snapshot = std::make_shared<EntrySnapshot>();
+    snapshot->version = version;
+    snapshot->segments = std::move(segments);
+    snapshot->totalSize = 0;
+    for (const auto& segment : snapshot->segments) {
+        snapshot->totalSize += segment->rows.size();
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const EntrySnapshot> EntrySnapshot::withAppended(const Entry& entry) const {
+    auto snapshot = std::make_shared<EntrySnapshot>(*this); // Shares every segment
+    snapshot->version = version + 1;
+    snapshot->totalSize = totalSize + 1;
+
+    if (segments.empty() || segments.back()->rows.size() >= kSegmentCapacity) {
+        auto segment = std::make_shared<EntrySegment>();
+        segment->rows.reserve(kSegmentCapacity);
+        segment->rows.push_back(entry);
+        snapshot->segments.push_back(std::move(segment));
+    } else {
+        // Only the partially filled tail segment is copied
+        auto segment = std::make_shared<EntrySegment>(*segments.back());
+        segment->rows.push_back(entry);
+        snapshot->segments.back() = std::move(segment);
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const EntrySnapshot> EntrySnapshot::withReplaced(size_t index, const Entry& entry) const {
+    auto snapshot = std::make_shared<EntrySnapshot>(*this);
+    snapshot->version = version + 1;
+
+    size_t segmentIndex = index / kSegmentCapacity;
+    auto segment = std::make_shared<EntrySegment>(*segments[segmentIndex]);
+    segment->rows[index % kSegmentCapacity] = entry;
+    snapshot->segments[segmentIndex] = std::move(segment);
+    return snapshot;
+}
+
+std::shared_ptr<const EntrySnapshot> EntrySnapshot::withReplacedRows(std::vector<std::pair<size_t, Entry>>&& rows) const {
+    auto snapshot = std::make_shared<EntrySnapshot>(*this);
+    snapshot->version = version + 1;
+
+    std::shared_ptr<EntrySegment> segment;
+    size_t segmentIndex = 0;
+    for (auto& row : rows) {
+        if (!segment || row.first / kSegmentCapacity != segmentIndex) {
+            segmentIndex = row.first / kSegmentCapacity;
+            segment = std::make_shared<EntrySegment>(*segments[segmentIndex]);
+            snapshot->segments[segmentIndex] = segment;
+        }
+        segment->rows[row.first % kSegmentCapacity] = std::move(row.second);
+    }
+    return snapshot;
+}
+
+std::shared_ptr<const EntrySnapshot> EntrySnapshot::withTailReplaced(size_t firstSegment, std::vector<Entry>&& tailRows) const {
+    auto tail = fromEntries(std::move(tailRows), version + 1);
+    auto snapshot = std::make_shared<EntrySnapshot>();
+    snapshot->version = version + 1;
+    snapshot->segments.assign(segments.begin(), segments.begin() + std::min(firstSegment, segments.size()));
+    snapshot->totalSize = snapshot->segments.size() * kSegmentCapacity + tail->totalSize;
+    snapshot->segments.insert(snapshot->segments.end(), tail->segments.begin(), tail->segments.end());
+    return snapshot;
+}
+
+const Entry& EntrySnapshot::operator[](size_t index) const {
+    const EntrySegment& segment = *segments[index / kSegmentCapacity];
+    segment.ensureMigrated();
+    return segment.rows[index % kSegmentCapacity];
+}
+
+long EntrySnapshot::findIndexByKey(int key) const {
+    // Keys are renumbered 1..n after deletions, so the direct position is almost always right
+    if (key >= 1 && (size_t)key <= totalSize && (*this)[key - 1].key == key) {
+        return key - 1;
+    }
+    for (size_t i = 0; i < totalSize; ++i) {
+        if ((*this)[i].key == key) {
+            return (long)i;
+        }
+    }
+    return -1;
+}
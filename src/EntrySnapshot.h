@@ -0,0 +1,121 @@
+#ifndef ENTRY_SNAPSHOT_H
+#define ENTRY_SNAPSHOT_H
+
+#include <vector>
+#include <memory> // For std::shared_ptr
+#include <cstdint>
+#include <iterator>
+#include <atomic>
+#include <mutex> // For std::mutex
+#include <utility> // For std::pair
+
+struct Entry;
+class SchemaMigration;
+
+// Immutable block of consecutive entries. Snapshots share unchanged segments,
+// so a write only copies the segment it touches.
+// Rows loaded under an older form schema carry a pending SchemaMigration, applied to the
+// whole segment the first time any of its rows is read.
+struct EntrySegment {
+    std::vector<Entry> rows;
+
+    EntrySegment() = default;
+    EntrySegment(const EntrySegment& other); // Copies the rows, migrated
+
+    void setPendingMigration(std::shared_ptr<const SchemaMigration> migration);
+
+    // Applies a pending migration; one atomic load once it has run
+    void ensureMigrated() const {
+        if (migrationPending.load(std::memory_order_acquire)) {
+            migrateRows();
+        }
+    }
+    bool hasPendingMigration() const { return migrationPending.load(std::memory_order_acquire); }
+
+private:
+    mutable std::atomic<bool> migrationPending{false};
+    mutable std::mutex migrationMutex;
+    mutable std::shared_ptr<const SchemaMigration> pendingMigration; // Guarded by migrationMutex
+
+    void migrateRows() const;
+};
+
+using EntrySegmentPtr = std::shared_ptr<const EntrySegment>;
+
+// Consistent, read-only view of a form's entries at one point in time.
+// Every segment except the last holds exactly kSegmentCapacity rows.
+class EntrySnapshot {
+public:
+    static const size_t kSegmentCapacity = 1024;
+
+    class const_iterator {
+    private:
+        const EntrySnapshot* snapshot;
+        size_t index;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Entry*;
+        using reference = const Entry&;
+
+        const_iterator(const EntrySnapshot* snapshot, size_t index) : snapshot(snapshot), index(index) {}
+
+        reference operator*() const { return (*snapshot)[index]; }
+        pointer operator->() const { return &(*snapshot)[index]; }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++index; return copy; }
+        const_iterator& operator--() { --index; return *this; }
+        const_iterator& operator+=(difference_type n) { index += n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(snapshot, index + n); }
+        const_iterator operator-(difference_type n) const { return const_iterator(snapshot, index - n); }
+        const_iterator& operator-=(difference_type n) { index -= n; return *this; }
+        difference_type operator-(const const_iterator& other) const { return (difference_type)index - (difference_type)other.index; }
+        reference operator[](difference_type n) const { return (*snapshot)[index + n]; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+        bool operator<(const const_iterator& other) const { return index < other.index; }
+    };
+
+    EntrySnapshot() : totalSize(0), version(0) {}
+
+    // Builds a snapshot from scratch, splitting the rows into segments; with a 'migration'
+    // every segment converts its rows on first access
+    static std::shared_ptr<const EntrySnapshot> fromEntries(std::vector<Entry>&& entries, uint64_t version,
+                                                            std::shared_ptr<const SchemaMigration> migration = nullptr);
+
+    // Assembles a snapshot from existing segments, e.g. some shared with another snapshot;
+    // every segment but the last must be full
+    static std::shared_ptr<const EntrySnapshot> fromSegments(std::vector<EntrySegmentPtr>&& segments, uint64_t version);
+
+    // Copy-on-write mutations returning a new snapshot; the receiver is left untouched
+    std::shared_ptr<const EntrySnapshot> withAppended(const Entry& entry) const;
+    std::shared_ptr<const EntrySnapshot> withReplaced(size_t index, const Entry& entry) const;
+    // Replaces many rows at once, copying each touched segment once; 'rows' must be sorted by index
+    std::shared_ptr<const EntrySnapshot> withReplacedRows(std::vector<std::pair<size_t, Entry>>&& rows) const;
+    // Keeps segments before 'firstSegment' and rebuilds the rest from 'tailRows'
+    std::shared_ptr<const EntrySnapshot> withTailReplaced(size_t firstSegment, std::vector<Entry>&& tailRows) const;
+
+    size_t size() const { return totalSize; }
+    bool empty() const { return totalSize == 0; }
+    uint64_t getVersion() const { return version; }
+
+    const Entry& operator[](size_t index) const;
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, totalSize); }
+
+    // Index of the entry with the given key, or -1 if absent
+    long findIndexByKey(int key) const;
+
+    const std::vector<EntrySegmentPtr>& getSegments() const { return segments; }
+
+private:
+    std::vector<EntrySegmentPtr> segments;
+    size_t totalSize;
+    uint64_t version; // Incremented by every write, lets caches detect staleness
+};
+
+using EntrySnapshotPtr = std::shared_ptr<const EntrySnapshot>;
+
+#endif // ENTRY_SNAPSHOT_H
@@ -0,0 +1,45 @@
+#ifndef ENTRY_VIEW_H
+#define ENTRY_VIEW_H
+
+#include <string_view>
+#include <variant>
+#include <vector>
+#include <utility> // For std::pair, std::forward
+#include "FieldValue.h" // For FieldValue, Timestamp
+
+struct Entry;
+
+// Non-owning counterpart of FieldValue: text points into storage owned by someone else
+// (an Entry, or a memory-mapped entries file). Alternatives are in FieldValue's order,
+// so the index is the FieldKind.
+using FieldValueView = std::variant<std::string_view, int, float, double, Timestamp>;
+
+static_assert(std::variant_size_v<FieldValueView> == std::variant_size_v<FieldValue>, "FieldValueView must mirror FieldValue");
+
+template <typename Visitor>
+decltype(auto) visitFieldValueView(const FieldValueView& value, Visitor&& visitor) {
+    return std::visit(std::forward<Visitor>(visitor), value);
+}
+
+// One row as the exporters read it: the key and the stored fields in name order. Valid until
+// the source that produced it moves to the next row. 'fields' keeps its capacity between rows,
+// so reading many rows into one EntryView allocates only for the widest row.
+struct EntryView {
+    int key = 0;
+    std::vector<std::pair<std::string_view, FieldValueView>> fields;
+
+    // The field's value, or null if the row does not store it
+    const FieldValueView* find(std::string_view name) const {
+        for (const auto& field : fields) {
+            if (field.first == name) {
+                return &field.second;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Points 'view' at the values of 'entry', which must outlive the view
+void makeEntryView(const Entry& entry, EntryView& view);
+
+#endif // ENTRY_VIEW_H
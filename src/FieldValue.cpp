@@ -0,0 +1,260 @@
+#include "FieldValue.h"
+#include "FormDefinition.h" // For FormField, NumberField
+#include <cstdio> // For std::snprintf
+#include <cstdlib> // For std::strtol, std::strtoll, std::strtof, std::strtod
+#include <cerrno>
+#include <climits> // For INT_MIN, INT_MAX
+
+namespace {
+
+const char* const kFieldKindNames[] = {
+    FieldKindTraits<FieldKind::String>::name,
+    FieldKindTraits<FieldKind::Int>::name,
+    FieldKindTraits<FieldKind::Float>::name,
+    FieldKindTraits<FieldKind::Double>::name,
+    FieldKindTraits<FieldKind::Timestamp>::name,
+};
+
+const int64_t kMillisPerDay = 86400000;
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil)
+int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+// Inverse of daysFromCivil
+void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = (int64_t)yearOfEra + era * 400 + (month <= 2);
+}
+
+// Reads exactly 'count' digits at 'text[position]'
+bool readDigits(const std::string& text, size_t& position, size_t count, int& out) {
+    if (position + count > text.size()) {
+        return false;
+    }
+    out = 0;
+    for (size_t i = 0; i < count; ++i) {
+        char c = text[position + i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        out = out * 10 + (c - '0');
+    }
+    position += count;
+    return true;
+}
+
+bool expect(const std::string& text, size_t& position, char c) {
+    if (position < text.size() && text[position] == c) {
+        ++position;
+        return true;
+    }
+    return false;
+}
+
+bool isEpochMillis(const std::string& text) {
+    size_t start = !text.empty() && text[0] == '-' ? 1 : 0;
+    if (start == text.size()) {
+        return false;
+    }
+    for (size_t i = start; i < text.size(); ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+const char* fieldKindName(FieldKind kind) {
+    return kFieldKindNames[static_cast<size_t>(kind)];
+}
+
+bool parseFieldKind(std::string_view name, FieldKind& kind) {
+    for (size_t i = 0; i < std::variant_size_v<FieldValue>; ++i) {
+        if (name == kFieldKindNames[i]) {
+            kind = static_cast<FieldKind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+FieldKind fieldKindFor(const FormField& field) {
+    if (field.type == "number") {
+        const std::string& numberType = static_cast<const NumberField&>(field).numberType;
+        if (numberType == "int") return FieldKind::Int;
+        if (numberType == "float") return FieldKind::Float;
+        return FieldKind::Double;
+    }
+    if (field.type == "timestamp") {
+        return FieldKind::Timestamp;
+    }
+    return FieldKind::String;
+}
+
+std::string formatFieldValue(const FieldValue& value) {
+    char buffer[32];
+    switch (fieldKindOf(value)) {
+        case FieldKind::String:
+            return std::get<std::string>(value);
+        case FieldKind::Int:
+            return std::to_string(*std::get_if<int>(&value));
+        case FieldKind::Float:
+            std::snprintf(buffer, sizeof(buffer), "%g", *std::get_if<float>(&value)); // Same digits as operator<<
+            return buffer;
+        case FieldKind::Double:
+            std::snprintf(buffer, sizeof(buffer), "%g", *std::get_if<double>(&value));
+            return buffer;
+        case FieldKind::Timestamp:
+            return formatTimestamp(*std::get_if<Timestamp>(&value));
+    }
+    return "";
+}
+
+size_t fieldValueDisplayWidth(const FieldValue& value) {
+    if (const std::string* text = std::get_if<std::string>(&value)) {
+        return text->size();
+    }
+    return formatFieldValue(value).size();
+}
+
+bool parseFieldValue(FieldKind kind, const std::string& text, FieldValue& out) {
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    errno = 0;
+    switch (kind) {
+        case FieldKind::String:
+            out = text;
+            return true;
+        case FieldKind::Int: {
+            long parsed = std::strtol(begin, &end, 10);
+            if (end == begin || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+                return false;
+            }
+            out = static_cast<int>(parsed);
+            return true;
+        }
+        case FieldKind::Float: {
+            float parsed = std::strtof(begin, &end);
+            if (end == begin) {
+                return false;
+            }
+            out = parsed;
+            return true;
+        }
+        case FieldKind::Double: {
+            double parsed = std::strtod(begin, &end);
+            if (end == begin) {
+                return false;
+            }
+            out = parsed;
+            return true;
+        }
+        case FieldKind::Timestamp: {
+            Timestamp parsed;
+            if (isEpochMillis(text)) {
+                long long millis = std::strtoll(begin, &end, 10);
+                if (errno == ERANGE) {
+                    return false;
+                }
+                parsed.millis = millis;
+            } else if (!parseTimestamp(text, parsed)) {
+                return false;
+            }
+            out = parsed;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string formatTimestamp(Timestamp time) {
+    int64_t days = time.millis / kMillisPerDay;
+    int64_t millisOfDay = time.millis % kMillisPerDay;
+    if (millisOfDay < 0) { // Before 1970: round the day down
+        millisOfDay += kMillisPerDay;
+        --days;
+    }
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    int seconds = (int)(millisOfDay / 1000);
+    char buffer[48];
+    int length = std::snprintf(buffer, sizeof(buffer), "%04lld-%02u-%02uT%02d:%02d:%02d", (long long)year, month, day,
+                               seconds / 3600, seconds / 60 % 60, seconds % 60);
+    if (millisOfDay % 1000 != 0) {
+        length += std::snprintf(buffer + length, sizeof(buffer) - length, ".%03d", (int)(millisOfDay % 1000));
+    }
+    std::snprintf(buffer + length, sizeof(buffer) - length, "Z");
+    return buffer;
+}
+
+bool parseTimestamp(const std::string& text, Timestamp& out) {
+    size_t position = 0;
+    int year, month, day, hour = 0, minute = 0, second = 0, millis = 0;
+    if (!readDigits(text, position, 4, year) || !expect(text, position, '-') || !readDigits(text, position, 2, month)
+        || !expect(text, position, '-') || !readDigits(text, position, 2, day)) {
+        return false;
+    }
+    if (expect(text, position, 'T') || expect(text, position, ' ')) {
+        if (!readDigits(text, position, 2, hour) || !expect(text, position, ':') || !readDigits(text, position, 2, minute)) {
+            return false;
+        }
+        if (expect(text, position, ':')) {
+            if (!readDigits(text, position, 2, second)) {
+                return false;
+            }
+            if (expect(text, position, '.')) {
+                int scale = 100, digit;
+                size_t digits = 0;
+                while (readDigits(text, position, 1, digit)) { // Digits past milliseconds are dropped
+                    millis += digit * scale;
+                    scale /= 10;
+                    ++digits;
+                }
+                if (digits == 0) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    int offsetMinutes = 0;
+    if (position < text.size() && (text[position] == '+' || text[position] == '-')) {
+        int sign = text[position++] == '-' ? -1 : 1;
+        int offsetHours, offsetMins;
+        if (!readDigits(text, position, 2, offsetHours) || !expect(text, position, ':') || !readDigits(text, position, 2, offsetMins)) {
+            return false;
+        }
+        offsetMinutes = sign * (offsetHours * 60 + offsetMins);
+    } else {
+        expect(text, position, 'Z');
+    }
+    if (position != text.size() || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+    int64_t days = daysFromCivil(year, (unsigned)month, (unsigned)day);
+    int64_t checkYear;
+    unsigned checkMonth, checkDay;
+    civilFromDays(days, checkYear, checkMonth, checkDay);
+    if (checkDay != (unsigned)day) {
+        return false; // E.g. February 30th
+    }
+    out.millis = days * kMillisPerDay + ((hour * 60 + minute - offsetMinutes) * 60 + second) * 1000LL + millis;
+    return true;
+}
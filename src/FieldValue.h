@@ -0,0 +1,121 @@
+#ifndef FIELD_VALUE_H
+#define FIELD_VALUE_H
+
+#include <string>
+#include <string_view>
+#include <variant>
+#include <utility> // For std::forward
+#include <type_traits> // For std::is_same_v
+#include <cstdint>
+
+struct FormField;
+
+// Point in time stored by "timestamp" fields: milliseconds since 1970-01-01T00:00:00Z.
+// Entries files hold the number; display and exports use ISO-8601 text (formatTimestamp).
+struct Timestamp {
+    int64_t millis = 0;
+
+    friend bool operator==(Timestamp a, Timestamp b) { return a.millis == b.millis; }
+    friend bool operator!=(Timestamp a, Timestamp b) { return a.millis != b.millis; }
+    friend bool operator<(Timestamp a, Timestamp b) { return a.millis < b.millis; }
+    friend bool operator<=(Timestamp a, Timestamp b) { return a.millis <= b.millis; }
+    friend bool operator>(Timestamp a, Timestamp b) { return a.millis > b.millis; }
+    friend bool operator>=(Timestamp a, Timestamp b) { return a.millis >= b.millis; }
+};
+
+// Value stored for one field of an entry. The alternatives are the types an entries
+// file can hold; the alternative index doubles as the FieldKind, so dispatch is a
+// table lookup instead of RTTI compares and never throws.
+using FieldValue = std::variant<std::string, int, float, double, Timestamp>;
+
+enum class FieldKind { String = 0, Int = 1, Float = 2, Double = 3, Timestamp = 4 };
+
+// Compile-time mapping from a FieldKind to its C++ type and its name in the entries file
+template <FieldKind Kind>
+struct FieldKindTraits;
+
+template <>
+struct FieldKindTraits<FieldKind::String> {
+    using Type = std::string;
+    static constexpr const char* name = "string";
+};
+
+template <>
+struct FieldKindTraits<FieldKind::Int> {
+    using Type = int;
+    static constexpr const char* name = "int";
+};
+
+template <>
+struct FieldKindTraits<FieldKind::Float> {
+    using Type = float;
+    static constexpr const char* name = "float";
+};
+
+template <>
+struct FieldKindTraits<FieldKind::Double> {
+    using Type = double;
+    static constexpr const char* name = "double";
+};
+
+template <>
+struct FieldKindTraits<FieldKind::Timestamp> {
+    using Type = Timestamp;
+    static constexpr const char* name = "timestamp";
+};
+
+inline FieldKind fieldKindOf(const FieldValue& value) {
+    return static_cast<FieldKind>(value.index());
+}
+
+// Name used in entries files: "string", "int", "float", "double" or "timestamp"
+const char* fieldKindName(FieldKind kind);
+inline const char* fieldValueTypeName(const FieldValue& value) {
+    return fieldKindName(fieldKindOf(value));
+}
+
+// Parses a kind name from an entries file; returns false for unknown names
+bool parseFieldKind(std::string_view name, FieldKind& kind);
+
+// Kind the schema stores a field as ("select" fields store their option text)
+FieldKind fieldKindFor(const FormField& field);
+
+// Calls 'visitor' with the typed value (FieldKindTraits<Kind>::Type) only if 'value' holds
+// 'Kind'; returns whether it did. For fields whose kind the schema already fixes.
+template <FieldKind Kind, typename Visitor>
+bool visitField(const FieldValue& value, Visitor&& visitor) {
+    using Type = typename FieldKindTraits<Kind>::Type;
+    static_assert(std::is_same_v<Type, std::variant_alternative_t<static_cast<size_t>(Kind), FieldValue>>,
+                  "FieldKind must match the FieldValue alternative index");
+    if (const Type* typed = std::get_if<static_cast<size_t>(Kind)>(&value)) {
+        std::forward<Visitor>(visitor)(*typed);
+        return true;
+    }
+    return false;
+}
+
+// Calls 'visitor' with the typed value, whichever kind it holds
+template <typename Visitor>
+decltype(auto) visitFieldValue(const FieldValue& value, Visitor&& visitor) {
+    return std::visit(std::forward<Visitor>(visitor), value);
+}
+
+// Display text of a value: strings as-is, numbers like operator<< with default precision,
+// timestamps as ISO-8601
+std::string formatFieldValue(const FieldValue& value);
+
+// Length of formatFieldValue(value) without copying strings
+size_t fieldValueDisplayWidth(const FieldValue& value);
+
+// Converts text from an entries file into a value of 'kind'; returns false if it does not parse.
+// Timestamps take epoch milliseconds (the entries file form) or ISO-8601 text.
+bool parseFieldValue(FieldKind kind, const std::string& text, FieldValue& out);
+
+// ISO-8601 in UTC: "2024-05-01T12:30:00Z", with ".mmm" before the Z when there are milliseconds
+std::string formatTimestamp(Timestamp time);
+
+// Parses "YYYY-MM-DD", optionally followed by 'T' or ' ' and "HH:MM[:SS[.fff]]" and a "Z" or
+// "+HH:MM"/"-HH:MM" offset; times without an offset are UTC
+bool parseTimestamp(const std::string& text, Timestamp& out);
+
+#endif // FIELD_VALUE_H
@@ -0,0 +1,30 @@
+#include "FileLock.h"
+#include <iostream>
+#include <cerrno>
+#include <cstring> // For std::strerror
+#include <fcntl.h>
+#include <sys/file.h> // For flock
+#include <unistd.h>
+
+FileLock::FileLock(const std::string& path, Mode mode) : fd(-1), locked(false) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Warning: Could not open lock file " << path << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    int result;
+    do {
+        result = ::flock(fd, mode == Mode::Exclusive ? LOCK_EX : LOCK_SH);
+    } while (result != 0 && errno == EINTR);
+    if (result != 0) {
+        std::cerr << "Warning: Could not lock " << path << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    locked = true;
+}
+
+FileLock::~FileLock() {
+    if (fd >= 0) {
+        ::close(fd); // Also releases the lock
+    }
+}
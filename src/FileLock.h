@@ -0,0 +1,28 @@
+#ifndef FILE_LOCK_H
+#define FILE_LOCK_H
+
+#include <string>
+
+// Advisory lock between processes that share a Forms/ directory, held on a lock file with
+// flock(). Shared holders exclude only exclusive ones. flock() locks belong to the open
+// file, so two FileLocks on one path also exclude each other within a process.
+// The lock is taken by the constructor, blocking until granted, and released on destruction.
+class FileLock {
+public:
+    enum class Mode { Shared, Exclusive };
+
+    FileLock(const std::string& path, Mode mode); // Creates the lock file if needed
+    ~FileLock();
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+    // False if the lock file could not be opened or locked; the caller proceeds unlocked
+    bool isLocked() const { return locked; }
+
+private:
+    int fd;
+    bool locked;
+};
+
+#endif // FILE_LOCK_H
@@ -0,0 +1,308 @@
+#include "FormCatalog.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm> // For std::sort
+#include <filesystem> // For listing and deleting files
+#include <sys/stat.h> // For stat
+#ifdef __linux__
+#include <sys/inotify.h> // For incremental directory watching
+#include <unistd.h> // For read, close
+#include <climits> // For NAME_MAX
+#endif
+
+namespace fs = std::filesystem;
+
+// Global catalog definition
+FormCatalog formCatalog;
+
+namespace {
+
+const char* const kIndexFileName = ".catalog.idx";
+const char* const kIndexHeader = "CATALOG:1";
+
+bool isFormFileName(const std::string& fileName) {
+    return fileName.length() > 5 && fileName.compare(fileName.length() - 5, 5, ".form") == 0;
+}
+
+std::string formNameFromFileName(const std::string& fileName) {
+    return isFormFileName(fileName) ? fileName.substr(0, fileName.length() - 5) : fileName;
+}
+
+} // namespace
+
+bool statFormFile(const std::string& path, FormFileStamp& stamp) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+#ifdef __linux__
+    stamp.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+    stamp.mtimeNs = static_cast<int64_t>(st.st_mtime) * 1000000000LL;
+#endif
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+    stamp.size = static_cast<uint64_t>(st.st_size);
+    return true;
+}
+
+FormCatalog::FormCatalog(const std::string& formsDir)
+    : formsDir(formsDir), indexFilePath(formsDir + kIndexFileName), initialized(false),
+      indexDirty(false), inotifyFd(-1), watchDescriptor(-1) {}
+
+FormCatalog::~FormCatalog() {
+    stopWatching();
+}
+
+void FormCatalog::refresh() {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    refreshLocked();
+}
+
+void FormCatalog::refreshLocked() {
+    if (!initialized) {
+        if (!fs::exists(formsDir) || !fs::is_directory(formsDir)) {
+            forms.clear();
+            return; // Try again on the next refresh, the directory may be created later
+        }
+        loadIndex();
+        startWatching(); // Watch before scanning so no change slips in between
+        fullRescan();
+        initialized = true;
+    } else if (inotifyFd < 0 || !drainWatchEvents()) {
+        fullRescan();
+    }
+
+    if (indexDirty) {
+        saveIndex();
+    }
+}
+
+std::vector<std::string> FormCatalog::listForms() {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    refreshLocked();
+    std::vector<std::string> names;
+    names.reserve(forms.size());
+    for (const auto& pair : forms) {
+        names.push_back(pair.first); // std::map keeps them sorted
+    }
+    return names;
+}
+
+std::shared_ptr<FormDefinition> FormCatalog::getForm(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    // A single stat guards against changes the watcher has not reported yet
+    refreshFile(fileName);
+
+    auto it = forms.find(fileName);
+    if (it == forms.end()) {
+        return nullptr;
+    }
+
+    CatalogEntry& entry = it->second;
+    if (!entry.definition && !entry.indexedText.empty()) {
+        std::istringstream definitionLines(entry.indexedText); // Still matches the file: refreshFile() checked the stamp
+        entry.definition = FormDefinition::loadFromStream(definitionLines, formNameFromFileName(fileName));
+        entry.indexedText.clear();
+    } else if (!entry.definition) {
+        entry.definition = FormDefinition::loadFromFile(formsDir + fileName);
+        indexDirty = true;
+    }
+
+    if (indexDirty) {
+        saveIndex();
+    }
+    return it->second.definition;
+}
+
+bool FormCatalog::removeForm(const std::string& fileName) {
+    std::lock_guard<std::mutex> lock(catalogMutex);
+    try {
+        if (!fs::remove(formsDir + fileName)) {
+            return false;
+        }
+    } catch (const fs::filesystem_error& e) {
+        std::cerr << "Error deleting form: " << e.what() << std::endl;
+        return false;
+    }
+
+    if (forms.erase(fileName)) {
+        indexDirty = true;
+        saveIndex();
+    }
+    return true;
+}
+
+void FormCatalog::refreshFile(const std::string& fileName) {
+    if (!isFormFileName(fileName)) {
+        return;
+    }
+
+    FormFileStamp stamp;
+    if (!statFormFile(formsDir + fileName, stamp)) {
+        if (forms.erase(fileName)) {
+            indexDirty = true;
+        }
+        return;
+    }
+
+    auto it = forms.find(fileName);
+    if (it == forms.end() || it->second.stamp != stamp) {
+        forms[fileName] = CatalogEntry{stamp, nullptr, std::string()}; // Reparse lazily on next getForm
+        indexDirty = true;
+    }
+}
+
+void FormCatalog::fullRescan() {
+    std::map<std::string, CatalogEntry> scanned;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(formsDir, ec)) {
+        std::string fileName = entry.path().filename().string();
+        if (!isFormFileName(fileName)) {
+            continue;
+        }
+
+        FormFileStamp stamp;
+        if (!statFormFile(entry.path().string(), stamp)) {
+            continue;
+        }
+
+        auto it = forms.find(fileName);
+        if (it != forms.end() && it->second.stamp == stamp) {
+            scanned[fileName] = std::move(it->second); // Unchanged, keep the parsed definition
+        } else {
+            scanned[fileName] = CatalogEntry{stamp, nullptr, std::string()};
+            indexDirty = true;
+        }
+    }
+
+    if (scanned.size() != forms.size()) {
+        indexDirty = true; // Some forms disappeared
+    }
+    forms = std::move(scanned);
+}
+
+void FormCatalog::startWatching() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        return;
+    }
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        return; // Fall back to stat rescans
+    }
+    watchDescriptor = inotify_add_watch(inotifyFd, formsDir.c_str(),
+        IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+        IN_DELETE_SELF | IN_MOVE_SELF);
+    if (watchDescriptor < 0) {
+        stopWatching();
+    }
+#endif
+}
+
+void FormCatalog::stopWatching() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
+    }
+#endif
+    inotifyFd = -1;
+    watchDescriptor = -1;
+}
+
+bool FormCatalog::drainWatchEvents() {
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[64 * (sizeof(struct inotify_event) + NAME_MAX + 1)];
+    while (true) {
+        ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return true; // No more pending events
+        }
+
+        for (char* ptr = buffer; ptr < buffer + length;) {
+            auto* event = reinterpret_cast<struct inotify_event*>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                return false; // Lost events, a rescan is needed
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                stopWatching();
+                initialized = false; // Directory went away, start over next time
+                return true;
+            }
+            if (event->len > 0) {
+                refreshFile(event->name);
+            }
+        }
+    }
+#else
+    return false;
+#endif
+}
+
+void FormCatalog::loadIndex() {
+    std::ifstream inFile(indexFilePath);
+    if (!inFile.is_open()) {
+        return; // No index yet, the first scan will build it
+    }
+
+    std::string line;
+    if (!std::getline(inFile, line) || line != kIndexHeader) {
+        return; // Unknown index version, rebuild from scratch
+    }
+
+    while (std::getline(inFile, line)) {
+        bool parsed = line.rfind("FORM:", 0) == 0;
+        if (!parsed && line.rfind("STAT:", 0) != 0) {
+            continue;
+        }
+
+        // FORM:<mtimeNs>:<inode>:<size>:<fileName>
+        std::stringstream ss(line.substr(5));
+        FormFileStamp stamp;
+        char colon;
+        std::string fileName;
+        ss >> stamp.mtimeNs >> colon >> stamp.inode >> colon >> stamp.size >> colon;
+        std::getline(ss, fileName);
+
+        std::string definitionLines;
+        while (std::getline(inFile, line) && line != "---") {
+            definitionLines += line + "\n";
+        }
+
+        if (ss.fail() || !isFormFileName(fileName)) {
+            continue;
+        }
+
+        // Parsing (and compiling validation rules) waits until the form is opened
+        forms[fileName] = CatalogEntry{stamp, nullptr, parsed ? std::move(definitionLines) : std::string()};
+    }
+}
+
+void FormCatalog::saveIndex() {
+    std::string tempPath = indexFilePath + ".tmp";
+    std::ofstream outFile(tempPath);
+    if (!outFile.is_open()) {
+        return; // Read-only directory, the catalog still works in memory
+    }
+
+    outFile << kIndexHeader << "\n";
+    for (const auto& pair : forms) {
+        const CatalogEntry& entry = pair.second;
+        bool hasDefinition = entry.definition || !entry.indexedText.empty();
+        outFile << (hasDefinition ? "FORM:" : "STAT:") << entry.stamp.mtimeNs << ":" << entry.stamp.inode << ":"
+                << entry.stamp.size << ":" << pair.first << "\n";
+        if (entry.definition) {
+            entry.definition->saveToStream(outFile);
+        } else {
+            outFile << entry.indexedText; // Not opened since the index was loaded
+        }
+        outFile << "---\n";
+    }
+    outFile.close();
+
+    std::error_code ec;
+    fs::rename(tempPath, indexFilePath, ec);
+    indexDirty = false;
+}
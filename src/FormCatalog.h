@@ -0,0 +1,84 @@
+#ifndef FORM_CATALOG_H
+#define FORM_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // For std::shared_ptr
+#include <mutex> // For std::mutex
+#include <cstdint>
+#include "FormDefinition.h" // For FormDefinition struct
+
+// File identity used to decide whether a cached definition is still valid
+struct FormFileStamp {
+    int64_t mtimeNs = 0;
+    uint64_t inode = 0;
+    uint64_t size = 0;
+
+    bool operator==(const FormFileStamp& other) const {
+        return mtimeNs == other.mtimeNs && inode == other.inode && size == other.size;
+    }
+    bool operator!=(const FormFileStamp& other) const { return !(*this == other); }
+};
+
+// In-process cache of the .form files in the Forms/ directory.
+// Parsed definitions are keyed by file name and validated against mtime/inode/size,
+// changes are picked up incrementally (inotify on Linux, stat rescan elsewhere),
+// and the catalog is persisted to Forms/.catalog.idx for a fast cold start: definitions
+// stored there are kept as text and parsed only when a form is first opened.
+// All public members lock the catalog, so the UI and service threads may share it.
+class FormCatalog {
+private:
+    struct CatalogEntry {
+        FormFileStamp stamp;
+        std::shared_ptr<FormDefinition> definition; // Null until parsed
+        std::string indexedText; // Definition lines read from the index, parsed by the first getForm
+    };
+
+    std::mutex catalogMutex; // Guards everything below
+    std::string formsDir;
+    std::string indexFilePath;
+    std::map<std::string, CatalogEntry> forms; // Keyed by file name, e.g. "todo.form"
+    bool initialized;
+    bool indexDirty;
+    int inotifyFd;
+    int watchDescriptor;
+
+    void refreshLocked();
+    void loadIndex();
+    void saveIndex();
+    void fullRescan();
+    bool drainWatchEvents(); // Returns false if a full rescan is required
+    void startWatching();
+    void stopWatching();
+    void refreshFile(const std::string& fileName);
+
+public:
+    FormCatalog(const std::string& formsDir = "Forms/");
+    ~FormCatalog();
+
+    FormCatalog(const FormCatalog&) = delete;
+    FormCatalog& operator=(const FormCatalog&) = delete;
+
+    // Brings the catalog up to date with the directory; cheap when nothing changed
+    void refresh();
+
+    // Sorted list of available .form file names
+    std::vector<std::string> listForms();
+
+    // Returns the parsed definition, reparsing only if the file changed
+    std::shared_ptr<FormDefinition> getForm(const std::string& fileName);
+
+    // Deletes the .form file and drops it from the catalog
+    bool removeForm(const std::string& fileName);
+
+    const std::string& getFormsDir() const { return formsDir; }
+};
+
+// Reads the identity of a file; returns false if it does not exist
+bool statFormFile(const std::string& path, FormFileStamp& stamp);
+
+// Global catalog for the Forms/ directory
+extern FormCatalog formCatalog;
+
+#endif // FORM_CATALOG_H
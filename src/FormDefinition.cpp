@@ -1,4 +1,6 @@
 #include "FormDefinition.h"
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "FormValidator.h" // For FormValidator
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -7,10 +9,10 @@
 std::shared_ptr<FormDefinition> currentSelectedForm = nullptr;
 
 std::shared_ptr<FormDefinition> FormDefinition::loadFromFile(const std::string& filename) {
-    auto formDef = std::make_shared<FormDefinition>();
-    formDef->name = filename.substr(filename.find_last_of('/') + 1); // Extract name from path
-    if (formDef->name.length() > 5 && formDef->name.substr(formDef->name.length() - 5) == ".form") {
-        formDef->name = formDef->name.substr(0, formDef->name.length() - 5);
+    TRACE_SCOPE("FormDefinition::loadFromFile");
+    std::string name = filename.substr(filename.find_last_of('/') + 1); // Extract name from path
+    if (name.length() > 5 && name.substr(name.length() - 5) == ".form") {
+        name = name.substr(0, name.length() - 5);
     }
 
     std::ifstream inFile(filename);
@@ -19,10 +21,20 @@ std::shared_ptr<FormDefinition> FormDefinition::loadFromFile(const std::string&
         return nullptr;
     }
 
+    auto formDef = loadFromStream(inFile, name);
+    inFile.close();
+    return formDef;
+}
+
+std::shared_ptr<FormDefinition> FormDefinition::loadFromStream(std::istream& in, const std::string& name) {
+    auto formDef = std::make_shared<FormDefinition>();
+    formDef->name = name;
+
     std::string line;
     std::shared_ptr<SelectField> currentSelectField = nullptr;
+    std::shared_ptr<FormField> currentField = nullptr; // Field that "  rule:" lines apply to
 
-    while (std::getline(inFile, line)) {
+    while (std::getline(in, line)) {
         std::stringstream ss(line);
         std::string type;
         std::getline(ss, type, ':');
@@ -38,6 +50,11 @@ std::shared_ptr<FormDefinition> FormDefinition::loadFromFile(const std::string&
             std::getline(ss, numType);
             formDef->fields.push_back(std::make_shared<NumberField>(name, numType));
             currentSelectField = nullptr; // Reset current select field
+        } else if (type == "timestamp") {
+            std::string name;
+            std::getline(ss, name);
+            formDef->fields.push_back(std::make_shared<TimestampField>(name));
+            currentSelectField = nullptr; // Reset current select field
         } else if (type == "select") {
             std::string name;
             std::getline(ss, name);
@@ -50,9 +67,42 @@ std::shared_ptr<FormDefinition> FormDefinition::loadFromFile(const std::string&
             ss >> num >> colon; // Read number and colon
             std::getline(ss, optionText); // Read the rest of the line as option text
             currentSelectField->options[num] = optionText;
+        } else if (type == "  rule" && currentField) {
+            std::string rule;
+            std::getline(ss, rule); // The rest of the line, so patterns may contain colons
+            currentField->rules.push_back(rule);
+        }
+        if (!formDef->fields.empty()) {
+            currentField = formDef->fields.back();
         }
     }
 
-    inFile.close();
+    std::string errors;
+    formDef->validator = FormValidator::compile(*formDef, errors);
+    if (!errors.empty()) {
+        std::cerr << "Warning: Ignoring invalid validation rules:\n" << errors;
+    }
     return formDef;
 }
+
+void FormDefinition::saveToStream(std::ostream& out) const {
+    for (const auto& field : fields) {
+        if (field->type == "string") {
+            out << "string:" << field->name << "\n";
+        } else if (field->type == "number") {
+            auto numField = std::static_pointer_cast<NumberField>(field);
+            out << "number:" << field->name << ":" << numField->numberType << "\n";
+        } else if (field->type == "timestamp") {
+            out << "timestamp:" << field->name << "\n";
+        } else if (field->type == "select") {
+            auto selectField = std::static_pointer_cast<SelectField>(field);
+            out << "select:" << field->name << "\n";
+            for (const auto& option : selectField->options) {
+                out << "  option:" << option.first << ":" << option.second << "\n";
+            }
+        }
+        for (const auto& rule : field->rules) {
+            out << "  rule:" << rule << "\n";
+        }
+    }
+}
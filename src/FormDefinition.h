@@ -5,11 +5,13 @@
 #include <vector>
 #include <map>
 #include <memory> // For std::shared_ptr
+#include <iosfwd> // For std::istream, std::ostream
 
 // Base class for form fields
 struct FormField {
     std::string name;
-    std::string type; // "string", "number", "select"
+    std::string type; // "string", "number", "select", "timestamp"
+    std::vector<std::string> rules; // Validation rules as declared, e.g. "required" or "max:100" (see FormValidator)
 
     FormField(const std::string& n, const std::string& t) : name(n), type(t) {}
     virtual ~FormField() = default;
@@ -26,19 +28,34 @@ struct NumberField : public FormField {
     NumberField(const std::string& n, const std::string& nt) : FormField(n, "number"), numberType(nt) {}
 };
 
+// Derived class for Timestamp fields, stored as epoch milliseconds
+struct TimestampField : public FormField {
+    TimestampField(const std::string& n) : FormField(n, "timestamp") {}
+};
+
 // Derived class for Select fields
 struct SelectField : public FormField {
     std::map<int, std::string> options;
     SelectField(const std::string& n) : FormField(n, "select") {}
 };
 
+class FormValidator;
+
 // Structure to hold the definition of a form
 struct FormDefinition {
     std::string name;
     std::vector<std::shared_ptr<FormField>> fields;
+    std::shared_ptr<const FormValidator> validator; // Compiled rules, set by loadFromStream; null when there are none
 
     // Function to load a form definition from a file
     static std::shared_ptr<FormDefinition> loadFromFile(const std::string& filename);
+
+    // Parses form lines ("string:name", "number:name:type", "timestamp:name", "select:name", "  option:n:text",
+    // "  rule:spec" for the field above) from a stream and compiles the rules
+    static std::shared_ptr<FormDefinition> loadFromStream(std::istream& in, const std::string& name);
+
+    // Writes the definition back out in the same line format read by loadFromStream
+    void saveToStream(std::ostream& out) const;
 };
 
 // Global variable to hold the currently selected form
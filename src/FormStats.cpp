@@ -0,0 +1,66 @@
+#include "FormStats.h"
+#include "FormDefinition.h" // For FormDefinition
+#include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For acquireSelectedManager, entryManagerPool
+#include <iostream>
+#include <iomanip> // For std::setw
+#include <sstream> // For std::ostringstream
+
+namespace {
+
+// Human readable byte count, e.g. "12.3 KiB"
+std::string formatBytes(uintmax_t bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB"};
+    double value = static_cast<double>(bytes);
+    int unit = 0;
+    while (value >= 1024.0 && unit < 3) {
+        value /= 1024.0;
+        unit++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+    return out.str();
+}
+
+} // namespace
+
+void showFormStats() {
+    std::shared_ptr<FormDefinition> selectedForm;
+    auto manager = acquireSelectedManager(selectedForm);
+    if (!manager) {
+        return;
+    }
+
+    FormStats stats = manager->computeStats();
+
+    // Formatted locally so the fixed/precision/alignment flags never leak into std::cout
+    std::ostringstream out;
+    out << "\n--- Stats for form: " << selectedForm->name << " ---\n";
+    out << "Entries:            " << stats.entryCount << "\n";
+    out << "In-memory estimate:  " << formatBytes(stats.totalBytes) << "\n";
+    out << "  Entry overhead:    " << formatBytes(stats.entryOverheadBytes) << "\n";
+    out << "  String heap:       " << formatBytes(stats.stringHeapBytes) << "\n";
+    out << "File on disk:        " << formatBytes(stats.fileBytes) << "\n";
+    out << "Last load:           " << std::fixed << std::setprecision(2) << stats.loadMillis << " ms\n";
+
+    if (!stats.columns.empty()) {
+        out << std::left << std::setw(20) << "COLUMN" << std::setw(8) << "TYPE" << std::right << std::setw(10) << "VALUES"
+            << std::setw(14) << "BYTES" << std::setw(14) << "STRING HEAP" << "\n";
+        for (const auto& column : stats.columns) {
+            out << std::left << std::setw(20) << column.name << std::setw(8) << column.type << std::right << std::setw(10)
+                << column.values << std::setw(14) << formatBytes(column.bytes) << std::setw(14)
+                << formatBytes(column.stringHeapBytes) << "\n";
+        }
+    }
+
+    out << "By type:";
+    for (const auto& pair : stats.types) {
+        out << "  " << pair.first << "=" << formatBytes(pair.second.bytes) << " (" << pair.second.values << ")";
+    }
+    out << "\nIndexes:";
+    for (const auto& pair : stats.indexBytes) {
+        out << "  " << pair.first << "=" << formatBytes(pair.second);
+    }
+    out << "\nManager pool: " << entryManagerPool.size() << " open, " << formatBytes(entryManagerPool.memoryUsage()) << " total\n";
+    std::cout << out.str();
+}
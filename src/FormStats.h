@@ -0,0 +1,38 @@
+#ifndef FORM_STATS_H
+#define FORM_STATS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+// Memory and storage statistics for one loaded form, produced by EntryManager::computeStats()
+struct FormStats {
+    struct ColumnStats {
+        std::string name;
+        std::string type; // Stored value type: "string", "int", "float" or "double"
+        size_t values = 0; // Entries that have a value for this column
+        size_t bytes = 0; // Map node plus value storage
+        size_t stringHeapBytes = 0; // Part of 'bytes' held in string buffers
+    };
+
+    struct TypeStats {
+        size_t values = 0;
+        size_t bytes = 0;
+    };
+
+    size_t entryCount = 0;
+    size_t totalBytes = 0; // Estimated heap held by all entries
+    size_t entryOverheadBytes = 0; // Entry structs and their empty maps
+    size_t stringHeapBytes = 0; // Bytes in heap-allocated string buffers
+    std::vector<ColumnStats> columns;
+    std::map<std::string, TypeStats> types; // Keyed by stored value type
+    std::map<std::string, size_t> indexBytes; // In-memory index structures, keyed by index name
+    uintmax_t fileBytes = 0; // Size of the entries file on disk
+    double loadMillis = 0.0; // Time the last full load took
+};
+
+// Menu action: prints FormStats for the currently selected form
+void showFormStats();
+
+#endif // FORM_STATS_H
@@ -0,0 +1,244 @@
+#include "FormValidator.h"
+#include "FormDefinition.h" // For FormDefinition
+#include <cstdlib> // For std::strtod, std::strtoull
+#include <sstream>
+#include <type_traits> // For std::is_arithmetic_v
+
+namespace {
+
+bool parseNumber(const std::string& text, double& out) {
+    char* end = nullptr;
+    out = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+bool parseCount(const std::string& text, size_t& out) {
+    char* end = nullptr;
+    out = std::strtoull(text.c_str(), &end, 10);
+    return !text.empty() && text[0] != '-' && *end == '\0';
+}
+
+// Characters of a UTF-8 string: every byte that does not continue a multi-byte sequence
+size_t codePointCount(const std::string& text) {
+    size_t count = 0;
+    for (unsigned char c : text) {
+        count += (c & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+double numericValue(const FieldValue& value) {
+    return visitFieldValue(value, [](const auto& typed) -> double {
+        using T = std::decay_t<decltype(typed)>;
+        if constexpr (std::is_arithmetic_v<T>) {
+            return static_cast<double>(typed);
+        } else if constexpr (std::is_same_v<T, Timestamp>) {
+            return static_cast<double>(typed.millis);
+        } else {
+            return 0;
+        }
+    });
+}
+
+std::string formatBound(double bound) {
+    std::ostringstream out;
+    out << bound;
+    return out.str();
+}
+
+} // namespace
+
+std::shared_ptr<const FormValidator> FormValidator::compile(const FormDefinition& formDef, std::string& errors) {
+    auto validator = std::make_shared<FormValidator>();
+    for (const auto& field : formDef.fields) {
+        if (field->rules.empty()) {
+            continue;
+        }
+        FieldCheck check;
+        check.field = field->name;
+        check.kind = fieldKindFor(*field);
+        bool isString = field->type == "string";
+        bool isSelect = field->type == "select";
+        bool usable = false;
+        for (const std::string& rule : field->rules) {
+            size_t colon = rule.find(':');
+            std::string name = rule.substr(0, colon);
+            std::string argument = colon == std::string::npos ? "" : rule.substr(colon + 1);
+            std::string problem;
+            if (name == "required") {
+                check.required = true;
+            } else if (name == "min" || name == "max") {
+                bool isMin = name == "min";
+                if (field->type == "number") {
+                    double bound;
+                    if (!parseNumber(argument, bound)) {
+                        problem = "expects a number";
+                    } else {
+                        (isMin ? check.min : check.max) = bound;
+                        (isMin ? check.hasMin : check.hasMax) = true;
+                    }
+                } else if (field->type == "timestamp") {
+                    Timestamp bound;
+                    if (!parseTimestamp(argument, bound)) {
+                        problem = "expects a timestamp";
+                    } else {
+                        (isMin ? check.minMillis : check.maxMillis) = bound.millis;
+                        (isMin ? check.hasMin : check.hasMax) = true;
+                    }
+                } else {
+                    problem = "applies to number and timestamp fields only";
+                }
+            } else if (name == "minlength" || name == "maxlength") {
+                size_t length;
+                if (!isString) {
+                    problem = "applies to string fields only";
+                } else if (!parseCount(argument, length)) {
+                    problem = "expects a character count";
+                } else {
+                    (name == "minlength" ? check.minLength : check.maxLength) = length;
+                }
+            } else if (name == "pattern") {
+                if (!isString) {
+                    problem = "applies to string fields only";
+                } else {
+                    // std::regex reports a malformed expression only by throwing
+                    try {
+                        check.pattern = std::regex(argument, std::regex::ECMAScript | std::regex::optimize);
+                        check.hasPattern = true;
+                        check.patternText = argument;
+                    } catch (const std::regex_error& e) {
+                        problem = std::string("is not a valid regex (") + e.what() + ")";
+                    }
+                }
+            } else if (name == "options") {
+                if (!isSelect) {
+                    problem = "applies to select fields only";
+                } else {
+                    auto selectField = std::static_pointer_cast<SelectField>(field);
+                    check.allowedOptions.assign(selectField->options.size(), false);
+                    size_t bit = 0;
+                    std::map<int, size_t> bitOf;
+                    for (const auto& option : selectField->options) {
+                        check.optionBits.emplace(option.second, bit);
+                        bitOf[option.first] = bit++;
+                    }
+                    std::stringstream numbers(argument);
+                    std::string number;
+                    while (std::getline(numbers, number, ',')) {
+                        char* end = nullptr;
+                        long optionNumber = std::strtol(number.c_str(), &end, 10);
+                        auto found = bitOf.find((int)optionNumber);
+                        if (number.empty() || *end != '\0' || found == bitOf.end()) {
+                            problem = "names an unknown option '" + number + "'";
+                            break;
+                        }
+                        check.allowedOptions[found->second] = true;
+                    }
+                    if (!problem.empty()) {
+                        check.allowedOptions.clear();
+                        check.optionBits.clear();
+                    }
+                }
+            } else {
+                problem = "is not a known rule";
+            }
+
+            if (problem.empty()) {
+                usable = true;
+            } else {
+                errors += "Form " + formDef.name + ", field '" + field->name + "': rule '" + rule + "' " + problem + "\n";
+            }
+        }
+        if (usable) {
+            validator->checkIndex[check.field] = validator->checks.size();
+            validator->checks.push_back(std::move(check));
+        }
+    }
+    return validator->checks.empty() ? nullptr : validator;
+}
+
+bool FormValidator::checkValue(const FieldCheck& check, const FieldValue* value, std::string& error) const {
+    const std::string* text = value ? std::get_if<std::string>(value) : nullptr;
+    if (!value || (text && text->empty())) {
+        if (check.required) {
+            error = "Field '" + check.field + "' is required.";
+            return false;
+        }
+        return true; // Optional and empty: the other rules do not apply
+    }
+    if (fieldKindOf(*value) != check.kind) {
+        error = "Field '" + check.field + "' expects a " + fieldKindName(check.kind) + " value.";
+        return false;
+    }
+
+    if (check.hasMin || check.hasMax) {
+        if (check.kind == FieldKind::Timestamp) {
+            int64_t millis = std::get<Timestamp>(*value).millis;
+            if ((check.hasMin && millis < check.minMillis) || (check.hasMax && millis > check.maxMillis)) {
+                error = "Field '" + check.field + "' must be between " + (check.hasMin ? formatTimestamp({check.minMillis}) : "any time")
+                    + " and " + (check.hasMax ? formatTimestamp({check.maxMillis}) : "any time") + ".";
+                return false;
+            }
+        } else {
+            double number = numericValue(*value);
+            if (check.hasMin && number < check.min) {
+                error = "Field '" + check.field + "' must be at least " + formatBound(check.min) + ".";
+                return false;
+            }
+            if (check.hasMax && number > check.max) {
+                error = "Field '" + check.field + "' must be at most " + formatBound(check.max) + ".";
+                return false;
+            }
+        }
+    }
+
+    if (text) {
+        if (check.minLength > 0 || check.maxLength > 0) {
+            size_t length = codePointCount(*text);
+            if (length < check.minLength) {
+                error = "Field '" + check.field + "' needs at least " + std::to_string(check.minLength) + " characters.";
+                return false;
+            }
+            if (check.maxLength > 0 && length > check.maxLength) {
+                error = "Field '" + check.field + "' allows at most " + std::to_string(check.maxLength) + " characters.";
+                return false;
+            }
+        }
+        if (check.hasPattern && !std::regex_match(*text, check.pattern)) {
+            error = "Field '" + check.field + "' must match the pattern " + check.patternText + ".";
+            return false;
+        }
+        if (!check.allowedOptions.empty()) {
+            auto bit = check.optionBits.find(*text);
+            if (bit == check.optionBits.end() || !check.allowedOptions[bit->second]) {
+                error = "Option '" + *text + "' is not accepted for field '" + check.field + "'.";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool FormValidator::validateRow(const std::map<std::string, FieldValue>& data, std::string& error) const {
+    for (const FieldCheck& check : checks) {
+        auto found = data.find(check.field);
+        if (!checkValue(check, found == data.end() ? nullptr : &found->second, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FormValidator::validateChanges(const std::map<std::string, FieldValue>& changes, std::string& error) const {
+    for (const auto& pair : changes) {
+        if (!validateField(pair.first, &pair.second, error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FormValidator::validateField(const std::string& fieldName, const FieldValue* value, std::string& error) const {
+    auto found = checkIndex.find(fieldName);
+    return found == checkIndex.end() || checkValue(checks[found->second], value, error);
+}
@@ -0,0 +1,64 @@
+#ifndef FORM_VALIDATOR_H
+#define FORM_VALIDATOR_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // For std::shared_ptr
+#include <regex>
+#include <unordered_map>
+#include "FieldValue.h" // For FieldValue
+
+struct FormDefinition;
+
+// Validation rules of a form, compiled once when the form is loaded. Rules are declared in the
+// .form file on indented lines after their field:
+//   rule:required            a value must be present; strings and select values must be non-empty
+//   rule:min:<n>             number fields: value >= n; timestamp fields: at or after the timestamp n
+//   rule:max:<n>             as min, value <= n
+//   rule:minlength:<n>       string fields: at least n characters (UTF-8 code points)
+//   rule:maxlength:<n>       string fields: at most n characters
+//   rule:pattern:<regex>     string fields: the whole value matches the ECMAScript regex
+//   rule:options:<n>,<n>...  select fields: only these option numbers are accepted
+// Only fields with rules are checked, each with a precompiled check, so validation costs a few
+// comparisons per ruled field.
+class FormValidator {
+private:
+    struct FieldCheck {
+        std::string field;
+        FieldKind kind = FieldKind::String;
+        bool required = false;
+        bool hasMin = false;
+        bool hasMax = false;
+        double min = 0; // Numbers; timestamps use minMillis and maxMillis
+        double max = 0;
+        int64_t minMillis = 0;
+        int64_t maxMillis = 0;
+        size_t minLength = 0;
+        size_t maxLength = 0; // 0 = no limit
+        bool hasPattern = false;
+        std::regex pattern;
+        std::string patternText; // For error messages
+        std::unordered_map<std::string, size_t> optionBits; // Select option text -> bit
+        std::vector<bool> allowedOptions; // One bit per option, empty when all are allowed
+    };
+
+    std::vector<FieldCheck> checks;
+    std::unordered_map<std::string, size_t> checkIndex; // Field name -> position in checks
+
+    bool checkValue(const FieldCheck& check, const FieldValue* value, std::string& error) const;
+
+public:
+    // Compiles the rules of every field. Invalid rules are described in 'errors', one per line,
+    // and skipped. Returns null when no field has a usable rule.
+    static std::shared_ptr<const FormValidator> compile(const FormDefinition& formDef, std::string& errors);
+
+    // Checks a complete row, including ruled fields it does not contain
+    bool validateRow(const std::map<std::string, FieldValue>& data, std::string& error) const;
+    // Checks only the given fields, for edits merged into a row that was already stored
+    bool validateChanges(const std::map<std::string, FieldValue>& changes, std::string& error) const;
+    // Checks one value as it is entered; 'value' is null when the field is left out
+    bool validateField(const std::string& fieldName, const FieldValue* value, std::string& error) const;
+};
+
+#endif // FORM_VALIDATOR_H
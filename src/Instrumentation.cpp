@@ -0,0 +1,216 @@
+#include "Instrumentation.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip> // For std::setw
+#include <mutex>
+#include <vector>
+#include <map>
+#include <algorithm> // For std::min, std::max
+#include <cstdlib> // For std::atexit
+
+std::atomic<bool> instrumentationEnabled(false);
+
+namespace {
+
+const size_t kMaxTraceEvents = 1000000; // Beyond this only the summary keeps accumulating
+
+struct TraceEvent {
+    const char* name;
+    int64_t startUs;
+    int64_t durationUs;
+    int threadId;
+};
+
+struct CounterSample {
+    const char* name;
+    int64_t timestampUs;
+    int64_t value;
+};
+
+struct TimerSummary {
+    uint64_t count = 0;
+    int64_t totalUs = 0;
+    int64_t minUs = INT64_MAX;
+    int64_t maxUs = 0;
+};
+
+struct InstrumentationState {
+    std::mutex mutex;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    bool printSummary = false;
+    std::string chromeTracePath;
+    bool flushRegistered = false;
+    std::vector<TraceEvent> events;
+    std::vector<CounterSample> counterSamples;
+    uint64_t droppedEvents = 0;
+    std::map<std::string, TimerSummary> timers;
+    std::map<std::string, int64_t> counters;
+};
+
+InstrumentationState& state() {
+    static InstrumentationState instance; // Never destroyed before the atexit flush runs
+    return instance;
+}
+
+int currentThreadId() {
+    static std::atomic<int> nextThreadId(1);
+    thread_local int threadId = nextThreadId++;
+    return threadId;
+}
+
+int64_t microsSinceOrigin(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - state().origin).count();
+}
+
+void flushAtExit() {
+    flushInstrumentation();
+}
+
+void writeChromeTrace(const std::string& path, InstrumentationState& s) {
+    std::ofstream outFile(path);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Could not write trace file " << path << std::endl;
+        return;
+    }
+
+    // Trace Event Format: complete events ("X") for timers, counter events ("C") for counters
+    outFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& event : s.events) {
+        outFile << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"todoapp\",\"ph\":\"X\",\"ts\":"
+                << event.startUs << ",\"dur\":" << event.durationUs << ",\"pid\":1,\"tid\":" << event.threadId << "}";
+        first = false;
+    }
+    for (const auto& sample : s.counterSamples) {
+        outFile << (first ? "" : ",\n") << "{\"name\":\"" << sample.name << "\",\"cat\":\"todoapp\",\"ph\":\"C\",\"ts\":"
+                << sample.timestampUs << ",\"pid\":1,\"args\":{\"value\":" << sample.value << "}}";
+        first = false;
+    }
+    outFile << "\n]}\n";
+    outFile.close();
+    std::cerr << "Trace written to " << path << std::endl;
+}
+
+} // namespace
+
+bool configureInstrumentation(const std::string& spec) {
+    InstrumentationState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    std::stringstream ss(spec);
+    std::string item;
+    bool any = false;
+    while (std::getline(ss, item, ',')) {
+        if (item == "summary") {
+            s.printSummary = true;
+            any = true;
+        } else if (item.rfind("chrome:", 0) == 0 && item.size() > 7) {
+            s.chromeTracePath = item.substr(7);
+            any = true;
+        } else if (!item.empty()) {
+            return false;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    if (!s.flushRegistered) {
+        std::atexit(flushAtExit);
+        s.flushRegistered = true;
+    }
+    instrumentationEnabled = true;
+    return true;
+}
+
+void setInstrumentationEnabled(bool enabled) {
+    instrumentationEnabled = enabled;
+}
+
+void recordCounterSlow(const char* name, int64_t delta) {
+    InstrumentationState& s = state();
+    int64_t now = microsSinceOrigin(std::chrono::steady_clock::now());
+    std::lock_guard<std::mutex> lock(s.mutex);
+    int64_t& value = s.counters[name];
+    value += delta;
+    if (s.events.size() + s.counterSamples.size() < kMaxTraceEvents) {
+        s.counterSamples.push_back({name, now, value});
+    } else {
+        ++s.droppedEvents;
+    }
+}
+
+void ScopedTimer::finish() {
+    auto end = std::chrono::steady_clock::now();
+    InstrumentationState& s = state();
+    int64_t startUs = microsSinceOrigin(start);
+    int64_t durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    int threadId = currentThreadId();
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+    TimerSummary& summary = s.timers[name];
+    summary.count++;
+    summary.totalUs += durationUs;
+    summary.minUs = std::min(summary.minUs, durationUs);
+    summary.maxUs = std::max(summary.maxUs, durationUs);
+
+    if (s.events.size() + s.counterSamples.size() < kMaxTraceEvents) {
+        s.events.push_back({name, startUs, durationUs, threadId});
+    } else {
+        ++s.droppedEvents;
+    }
+}
+
+std::string instrumentationSummary() {
+    InstrumentationState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    std::ostringstream out;
+
+    out << "\n--- Instrumentation Summary ---\n";
+    out << std::left << std::setw(36) << "OPERATION" << std::right << std::setw(10) << "COUNT" << std::setw(14) << "TOTAL ms"
+        << std::setw(12) << "AVG us" << std::setw(12) << "MIN us" << std::setw(12) << "MAX us" << "\n";
+    for (const auto& pair : s.timers) {
+        const TimerSummary& t = pair.second;
+        out << std::left << std::setw(36) << pair.first << std::right << std::setw(10) << t.count << std::setw(14)
+            << std::fixed << std::setprecision(3) << t.totalUs / 1000.0 << std::setw(12) << std::setprecision(1)
+            << (double)t.totalUs / t.count << std::setw(12) << t.minUs << std::setw(12) << t.maxUs << "\n";
+    }
+    if (!s.counters.empty()) {
+        out << std::left << std::setw(36) << "COUNTER" << std::right << std::setw(10) << "VALUE" << "\n";
+        for (const auto& pair : s.counters) {
+            out << std::left << std::setw(36) << pair.first << std::right << std::setw(10) << pair.second << "\n";
+        }
+    }
+    if (s.droppedEvents > 0) {
+        out << "(" << s.droppedEvents << " trace events dropped after reaching the buffer limit)\n";
+    }
+    return out.str();
+}
+
+void resetInstrumentation() {
+    InstrumentationState& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.printSummary = false;
+    s.chromeTracePath.clear();
+    s.events.clear();
+    s.counterSamples.clear();
+    s.droppedEvents = 0;
+    s.timers.clear();
+    s.counters.clear();
+}
+
+void flushInstrumentation() {
+    InstrumentationState& s = state();
+    bool printSummary;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        printSummary = s.printSummary;
+        if (!s.chromeTracePath.empty()) {
+            writeChromeTrace(s.chromeTracePath, s);
+        }
+    }
+    if (printSummary) {
+        std::cerr << instrumentationSummary();
+    }
+}
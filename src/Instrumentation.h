@@ -0,0 +1,72 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Lightweight operation timing and counters.
+// Disabled by default; when disabled a TRACE_SCOPE costs one relaxed atomic load.
+// Enable with the TODOAPP_TRACE environment variable or "--trace <spec>", where
+// <spec> is a comma separated list of "summary" and/or "chrome:<file.json>".
+
+extern std::atomic<bool> instrumentationEnabled;
+
+inline bool isInstrumentationEnabled() {
+    return instrumentationEnabled.load(std::memory_order_relaxed);
+}
+
+// Parses a trace spec and enables instrumentation; returns false if the spec is invalid
+bool configureInstrumentation(const std::string& spec);
+
+// Starts or stops collection at runtime without changing the configured outputs
+void setInstrumentationEnabled(bool enabled);
+
+// Writes the configured outputs (summary table to stderr and/or Chrome trace file)
+void flushInstrumentation();
+
+// Summary table of the data collected so far
+std::string instrumentationSummary();
+
+// Drops the data collected so far and the configured outputs; whether collection is enabled is unchanged
+void resetInstrumentation();
+
+// Adds 'delta' to a named counter; 'name' must be a string literal or otherwise outlive the process
+void recordCounterSlow(const char* name, int64_t delta);
+inline void recordCounter(const char* name, int64_t delta) {
+    if (isInstrumentationEnabled()) {
+        recordCounterSlow(name, delta);
+    }
+}
+
+// Times the enclosing scope; 'name' must be a string literal
+class ScopedTimer {
+private:
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    bool active;
+
+    void finish();
+
+public:
+    explicit ScopedTimer(const char* name) : name(name), active(isInstrumentationEnabled()) {
+        if (active) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedTimer() {
+        if (active) {
+            finish();
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ScopedTimer TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,265 @@
+#include "JsonValue.h"
+#include <cstdlib> // For std::strtod
+#include <cctype> // For std::isspace, std::isdigit
+
+const JsonValue* JsonValue::get(const std::string& name) const {
+    if (type != Type::Object) {
+        return nullptr;
+    }
+    auto it = object.find(name);
+    return it == object.end() ? nullptr : &it->second;
+}
+
+namespace {
+
+class JsonParser {
+private:
+    const std::string& text;
+    size_t pos;
+    std::string& error;
+
+    void skipWhitespace() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    }
+
+    bool fail(const std::string& message) {
+        if (error.empty()) {
+            error = message + " at offset " + std::to_string(pos);
+        }
+        return false;
+    }
+
+    bool consumeLiteral(const char* literal) {
+        size_t length = std::char_traits<char>::length(literal);
+        if (text.compare(pos, length, literal) != 0) {
+            return fail("Unexpected token");
+        }
+        pos += length;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, unsigned codePoint) {
+        if (codePoint < 0x80) {
+            out += static_cast<char>(codePoint);
+        } else if (codePoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codePoint >> 6));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else if (codePoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codePoint >> 12));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codePoint >> 18));
+            out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool parseHex4(unsigned& value) {
+        if (pos + 4 > text.size()) {
+            return fail("Truncated unicode escape");
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = text[pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return fail("Invalid unicode escape");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++pos; // Opening quote
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size()) {
+                break;
+            }
+            char escaped = text[pos++];
+            switch (escaped) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned codePoint;
+                    if (!parseHex4(codePoint)) {
+                        return false;
+                    }
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF && text.compare(pos, 2, "\\u") == 0) {
+                        pos += 2;
+                        unsigned low;
+                        if (!parseHex4(low)) {
+                            return false;
+                        }
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            return fail("Invalid surrogate pair");
+                        }
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, codePoint);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape sequence");
+            }
+        }
+        return fail("Unterminated string");
+    }
+
+    bool parseNumber(JsonValue& out) {
+        size_t start = pos;
+        if (text[pos] == '-') {
+            ++pos;
+        }
+        bool integer = true;
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (std::isdigit(static_cast<unsigned char>(c))) {
+                ++pos;
+            } else if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                integer = false;
+                ++pos;
+            } else {
+                break;
+            }
+        }
+        std::string literal = text.substr(start, pos - start);
+        char* end = nullptr;
+        out.number = std::strtod(literal.c_str(), &end);
+        if (literal.empty() || end != literal.c_str() + literal.size()) {
+            return fail("Invalid number");
+        }
+        out.type = JsonValue::Type::Number;
+        out.isInteger = integer;
+        return true;
+    }
+
+public:
+    JsonParser(const std::string& text, std::string& error) : text(text), pos(0), error(error) {}
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > 64) {
+            return fail("Nesting too deep");
+        }
+        skipWhitespace();
+        if (pos >= text.size()) {
+            return fail("Unexpected end of input");
+        }
+
+        char c = text[pos];
+        if (c == '{') {
+            ++pos;
+            out.type = JsonValue::Type::Object;
+            skipWhitespace();
+            if (pos < text.size() && text[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            while (true) {
+                skipWhitespace();
+                if (pos >= text.size() || text[pos] != '"') {
+                    return fail("Expected member name");
+                }
+                std::string name;
+                if (!parseString(name)) {
+                    return false;
+                }
+                skipWhitespace();
+                if (pos >= text.size() || text[pos] != ':') {
+                    return fail("Expected ':'");
+                }
+                ++pos;
+                if (!parseValue(out.object[name], depth + 1)) {
+                    return false;
+                }
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == ',') {
+                    ++pos;
+                } else if (pos < text.size() && text[pos] == '}') {
+                    ++pos;
+                    return true;
+                } else {
+                    return fail("Expected ',' or '}'");
+                }
+            }
+        } else if (c == '[') {
+            ++pos;
+            out.type = JsonValue::Type::Array;
+            skipWhitespace();
+            if (pos < text.size() && text[pos] == ']') {
+                ++pos;
+                return true;
+            }
+            while (true) {
+                out.array.emplace_back();
+                if (!parseValue(out.array.back(), depth + 1)) {
+                    return false;
+                }
+                skipWhitespace();
+                if (pos < text.size() && text[pos] == ',') {
+                    ++pos;
+                } else if (pos < text.size() && text[pos] == ']') {
+                    ++pos;
+                    return true;
+                } else {
+                    return fail("Expected ',' or ']'");
+                }
+            }
+        } else if (c == '"') {
+            out.type = JsonValue::Type::String;
+            return parseString(out.string);
+        } else if (c == 't') {
+            out.type = JsonValue::Type::Bool;
+            out.boolean = true;
+            return consumeLiteral("true");
+        } else if (c == 'f') {
+            out.type = JsonValue::Type::Bool;
+            out.boolean = false;
+            return consumeLiteral("false");
+        } else if (c == 'n') {
+            out.type = JsonValue::Type::Null;
+            return consumeLiteral("null");
+        } else if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+            return parseNumber(out);
+        }
+        return fail("Unexpected character");
+    }
+
+    bool parseDocument(JsonValue& out) {
+        if (!parseValue(out, 0)) {
+            return false;
+        }
+        skipWhitespace();
+        if (pos != text.size()) {
+            return fail("Trailing characters");
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool parseJson(const std::string& text, JsonValue& out, std::string& error) {
+    error.clear();
+    out = JsonValue();
+    JsonParser parser(text, error);
+    return parser.parseDocument(out);
+}
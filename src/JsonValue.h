@@ -0,0 +1,32 @@
+#ifndef JSON_VALUE_H
+#define JSON_VALUE_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+// Minimal JSON document model used by the service protocol
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    bool isInteger = false; // True when the number had no fraction or exponent
+    std::string string;
+    std::vector<JsonValue> array;
+    std::map<std::string, JsonValue> object;
+
+    bool isNull() const { return type == Type::Null; }
+    bool isString() const { return type == Type::String; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isObject() const { return type == Type::Object; }
+
+    // Returns the member or nullptr when absent or not an object
+    const JsonValue* get(const std::string& name) const;
+};
+
+// Parses a complete JSON text; on failure returns false and describes the problem in 'error'
+bool parseJson(const std::string& text, JsonValue& out, std::string& error);
+
+#endif // JSON_VALUE_H
@@ -0,0 +1,200 @@
+#include "MappedEntrySource.h"
+#include "FormDefinition.h" // For FormDefinition struct
+#include "PartitionStore.h" // For PartitionManifest
+#include "SchemaMigration.h" // For schemaHashOf
+#include "BlockCompression.h" // For kCompressedFileSuffix
+#include "FileLock.h" // For FileLock
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include <iostream>
+#include <filesystem>
+#include <charconv> // For std::from_chars
+#include <cstring> // For std::memchr
+#include <fcntl.h>
+#include <sys/mman.h> // For mmap, munmap, madvise
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+template <typename Number>
+bool parseNumber(std::string_view text, Number& out) {
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, out);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+bool parseFieldValueView(FieldKind kind, std::string_view text, FieldValueView& out) {
+    switch (kind) {
+        case FieldKind::String:
+            out = text;
+            return true;
+        case FieldKind::Int: {
+            int value;
+            if (!parseNumber(text, value)) {
+                return false;
+            }
+            out = value;
+            return true;
+        }
+        case FieldKind::Float: {
+            float value;
+            if (!parseNumber(text, value)) {
+                return false;
+            }
+            out = value;
+            return true;
+        }
+        case FieldKind::Double: {
+            double value;
+            if (!parseNumber(text, value)) {
+                return false;
+            }
+            out = value;
+            return true;
+        }
+        case FieldKind::Timestamp: {
+            Timestamp value;
+            if (!parseNumber(text, value.millis) && !parseTimestamp(std::string(text), value)) {
+                return false; // Entries files hold epoch milliseconds; ISO text is the rare fallback
+            }
+            out = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+MappedEntrySource::MappedEntrySource(const std::string& formName, const FormDefinition& formDef)
+    : current(0), offset(0), usable(false) {
+    TRACE_SCOPE("MappedEntrySource::map");
+    std::string directory = PartitionStore::directoryFor(formName);
+    if (!std::filesystem::is_directory(directory)) {
+        return;
+    }
+    FileLock lock(PartitionStore::lockPathFor(formName), FileLock::Mode::Shared);
+    PartitionManifest manifest;
+    if (!manifest.loadFromFile(PartitionStore::manifestPathFor(formName)) || manifest.schemaHash != schemaHashOf(formDef)) {
+        return; // Rows need converting to the current schema
+    }
+    for (const auto& part : manifest.partitions) {
+        if (endsWith(part.fileName, kCompressedFileSuffix)) {
+            unmapAll();
+            return;
+        }
+    }
+
+    for (const auto& part : manifest.partitions) {
+        std::string path = directory + "/" + part.fileName;
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat info;
+        if (fd < 0 || ::fstat(fd, &info) != 0) {
+            std::cerr << "Error: Missing partition file " << part.fileName << " for form " << formName << std::endl;
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            continue;
+        }
+        if (info.st_size > 0) {
+            void* data = ::mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                unmapAll();
+                return;
+            }
+            ::madvise(data, (size_t)info.st_size, MADV_SEQUENTIAL);
+            mappings.emplace_back(static_cast<const char*>(data), (size_t)info.st_size);
+        }
+        ::close(fd); // The mapping keeps the file contents alive
+    }
+    usable = true;
+}
+
+MappedEntrySource::~MappedEntrySource() {
+    unmapAll();
+}
+
+void MappedEntrySource::unmapAll() {
+    for (const auto& mapping : mappings) {
+        ::munmap(const_cast<char*>(mapping.data()), mapping.size());
+    }
+    mappings.clear();
+}
+
+bool MappedEntrySource::readLine(std::string_view& line) {
+    while (current < mappings.size()) {
+        std::string_view mapping = mappings[current];
+        if (offset < mapping.size()) {
+            const char* start = mapping.data() + offset;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', mapping.size() - offset));
+            size_t length = newline ? (size_t)(newline - start) : mapping.size() - offset;
+            line = std::string_view(start, length);
+            offset += length + (newline ? 1 : 0);
+            return true;
+        }
+        ++current;
+        offset = 0;
+    }
+    return false;
+}
+
+bool MappedEntrySource::nextView(EntryView& view) {
+    view.fields.clear();
+    bool inRecord = false;
+    std::string_view line;
+    while (true) {
+        size_t lineMapping = current, lineOffset = offset;
+        if (!readLine(line) || (inRecord && lineMapping != current)) {
+            if (inRecord && lineMapping != current) {
+                current = lineMapping; // The record ended with its file; the line belongs to the next one
+                offset = lineOffset;
+            }
+            return inRecord;
+        }
+        if (line.substr(0, 4) == "KEY:") {
+            if (inRecord) {
+                current = lineMapping; // Next record starts without a "---" separator
+                offset = lineOffset;
+                return true;
+            }
+            inRecord = parseNumber(line.substr(4), view.key);
+        } else if (line == "---") {
+            if (inRecord) {
+                return true;
+            }
+        } else if (inRecord) {
+            size_t nameEnd = line.find(':');
+            size_t typeEnd = nameEnd == std::string_view::npos ? nameEnd : line.find(':', nameEnd + 1);
+            FieldKind kind;
+            FieldValueView value;
+            if (typeEnd != std::string_view::npos && parseFieldKind(line.substr(nameEnd + 1, typeEnd - nameEnd - 1), kind)
+                && parseFieldValueView(kind, line.substr(typeEnd + 1), value)) {
+                view.fields.emplace_back(line.substr(0, nameEnd), value);
+            }
+        }
+    }
+}
+
+bool MappedEntrySource::next(Entry& entry) {
+    EntryView view;
+    if (!nextView(view)) {
+        return false;
+    }
+    entry.key = view.key;
+    entry.data.clear();
+    for (const auto& field : view.fields) {
+        entry.data[std::string(field.first)] = visitFieldValueView(field.second, [](const auto& typed) -> FieldValue {
+            if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, std::string_view>) {
+                return std::string(typed);
+            } else {
+                return typed;
+            }
+        });
+    }
+    return true;
+}
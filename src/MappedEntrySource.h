@@ -0,0 +1,45 @@
+#ifndef MAPPED_ENTRY_SOURCE_H
+#define MAPPED_ENTRY_SOURCE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "EntryReader.h" // For EntrySource
+#include "EntryView.h" // For EntryView
+
+struct FormDefinition;
+
+// Read-only, zero-copy source for exports. Maps every partition file of a form into memory
+// and parses records in place: string values are string_views into the mapping, so reading
+// a row allocates nothing once the EntryView has grown to the widest row.
+// All partitions are mapped up front, under the form's shared lock, so the export sees one
+// consistent version even if another process saves meanwhile (unlinked files stay mapped).
+// Only usable when every partition is stored uncompressed and already in the form's
+// current schema; otherwise isUsable() is false and callers fall back to PartitionedEntryReader.
+class MappedEntrySource : public EntrySource {
+private:
+    std::vector<std::string_view> mappings; // One per non-empty partition file, in key order
+    size_t current; // Mapping being read
+    size_t offset; // Next unread byte in mappings[current]
+    bool usable;
+
+    bool readLine(std::string_view& line);
+    void unmapAll();
+
+public:
+    MappedEntrySource(const std::string& formName, const FormDefinition& formDef);
+    ~MappedEntrySource() override;
+
+    MappedEntrySource(const MappedEntrySource&) = delete;
+    MappedEntrySource& operator=(const MappedEntrySource&) = delete;
+
+    bool isUsable() const { return usable; }
+
+    bool nextView(EntryView& view) override;
+    bool next(Entry& entry) override; // Copies the row out of the mapping
+};
+
+// Parses the value text of one "name:type:value" line without copying strings
+bool parseFieldValueView(FieldKind kind, std::string_view text, FieldValueView& out);
+
+#endif // MAPPED_ENTRY_SOURCE_H
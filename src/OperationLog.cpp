@@ -0,0 +1,76 @@
+#include "OperationLog.h"
+#include "Entry.h" // For Entry, EntryManager::entryFootprint
+#include <algorithm> // For std::max
+
+OperationLog::OperationLog() : bytes(0), maxOperations(kDefaultMaxOperations), maxBytes(kDefaultMaxBytes) {}
+
+void OperationLog::setLimits(size_t operations, size_t memoryBytes) {
+    maxOperations = operations;
+    maxBytes = memoryBytes;
+    trim();
+}
+
+size_t OperationLog::stepBytes(const OperationStep& step) {
+    size_t total = sizeof(OperationStep) + step.indices.capacity() * sizeof(size_t) + step.keys.capacity() * sizeof(int);
+    for (const Entry& entry : step.rows) {
+        total += EntryManager::entryFootprint(entry);
+    }
+    for (const Entry& entry : step.previous) {
+        total += EntryManager::entryFootprint(entry);
+    }
+    if (step.before && step.after) {
+        // Segments of the other version that the current rows do not share; a full segment is
+        // charged at the footprint of its first row
+        const auto& oldSegments = step.before->getSegments();
+        const auto& newSegments = step.after->getSegments();
+        for (size_t s = 0; s < std::max(oldSegments.size(), newSegments.size()); ++s) {
+            bool shared = s < oldSegments.size() && s < newSegments.size() && oldSegments[s] == newSegments[s];
+            if (!shared && s < oldSegments.size() && !oldSegments[s]->rows.empty()) {
+                oldSegments[s]->ensureMigrated();
+                total += oldSegments[s]->rows.size() * EntryManager::entryFootprint(oldSegments[s]->rows.front());
+            }
+        }
+    }
+    return total;
+}
+
+void OperationLog::record(LoggedOperation&& operation) {
+    for (const auto& redo : redoStack) {
+        bytes -= redo.bytes;
+    }
+    redoStack.clear();
+    operation.bytes = 0;
+    for (const auto& step : operation.steps) {
+        operation.bytes += stepBytes(step);
+    }
+    bytes += operation.bytes;
+    undoStack.push_back(std::move(operation));
+    trim();
+}
+
+void OperationLog::trim() {
+    // Always keep the newest operation, even if it alone is over the memory budget
+    while (undoStack.size() > 1 && (undoStack.size() + redoStack.size() > maxOperations || bytes > maxBytes)) {
+        bytes -= undoStack.front().bytes;
+        undoStack.pop_front();
+    }
+    if (maxOperations == 0) {
+        clear();
+    }
+}
+
+void OperationLog::markUndone() {
+    redoStack.push_back(std::move(undoStack.back()));
+    undoStack.pop_back();
+}
+
+void OperationLog::markRedone() {
+    undoStack.push_back(std::move(redoStack.back()));
+    redoStack.pop_back();
+}
+
+void OperationLog::clear() {
+    undoStack.clear();
+    redoStack.clear();
+    bytes = 0;
+}
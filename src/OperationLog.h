@@ -0,0 +1,80 @@
+#ifndef OPERATION_LOG_H
+#define OPERATION_LOG_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include "EntrySnapshot.h" // For EntrySnapshotPtr
+
+struct Entry;
+
+// One primitive change to a form's rows, recorded with what is needed to reverse it.
+// Indices are row positions in the snapshot the step applied to.
+struct OperationStep {
+    enum class Kind {
+        Append, // 'rows' were appended starting at indices[0]
+        Replace, // rows at 'indices' changed from 'previous' to 'rows'
+        Remove, // 'rows' were removed from 'indices' (ascending) and the following rows renumbered
+        Restore, // The whole form was switched from 'before' to 'after' (a named snapshot restore)
+    };
+
+    Kind kind = Kind::Append;
+    std::vector<size_t> indices;
+    std::vector<Entry> rows;
+    std::vector<Entry> previous;
+
+    // Remove: keys of the renumbered rows before the removal, starting with the first row of
+    // the segment holding indices[0]; only 'firstKey' is kept when they were consecutive
+    int firstKey = 1;
+    std::vector<int> keys;
+
+    EntrySnapshotPtr before; // Restore only; both share their unchanged segments with the form
+    EntrySnapshotPtr after;
+};
+
+// An undoable user-level operation ("add", "delete 12", ...) and the steps it made, in order
+struct LoggedOperation {
+    std::string label;
+    std::vector<OperationStep> steps;
+    size_t bytes = 0; // Estimated memory held by the steps
+};
+
+// Bounded undo and redo stacks. Recording a new operation clears the redo stack; the oldest
+// operations are dropped once either limit is exceeded.
+class OperationLog {
+private:
+    std::deque<LoggedOperation> undoStack; // Oldest first
+    std::vector<LoggedOperation> redoStack; // Next redo last
+    size_t bytes; // Held by both stacks
+    size_t maxOperations;
+    size_t maxBytes;
+
+    void trim();
+
+public:
+    static const size_t kDefaultMaxOperations = 1000;
+    static const size_t kDefaultMaxBytes = 16 * 1024 * 1024;
+
+    OperationLog();
+
+    void setLimits(size_t operations, size_t memoryBytes);
+
+    void record(LoggedOperation&& operation);
+
+    const LoggedOperation* nextUndo() const { return undoStack.empty() ? nullptr : &undoStack.back(); }
+    const LoggedOperation* nextRedo() const { return redoStack.empty() ? nullptr : &redoStack.back(); }
+    void markUndone(); // Moves the operation from nextUndo() onto the redo stack
+    void markRedone(); // Moves the operation from nextRedo() back onto the undo stack
+
+    void clear();
+
+    size_t undoDepth() const { return undoStack.size(); }
+    size_t redoDepth() const { return redoStack.size(); }
+    size_t memoryBytes() const { return bytes; }
+
+    // Estimated memory of one step's rows and keys
+    static size_t stepBytes(const OperationStep& step);
+};
+
+#endif // OPERATION_LOG_H
@@ -0,0 +1,429 @@
+#include "PartitionStore.h"
+#include "Entry.h" // For Entry
+#include "EntryReader.h" // For readEntriesFile
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "BlockCompression.h" // For Lz4FrameWriteBuf
+#include "FileLock.h" // For FileLock
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip> // For std::setw, std::setfill
+#include <set>
+#include <algorithm> // For std::min, std::max
+#include <cstdio> // For std::rename, std::remove
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <iterator> // For std::back_inserter
+#include <type_traits> // For std::is_same_v
+#include <map>
+#include <sys/stat.h> // For stat
+
+namespace {
+
+// Writes rows [begin, end) of a snapshot in the KEY:/name:type:value/--- record format
+void writeEntryRecords(std::ostream& out, const EntrySnapshot& snapshot, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        const Entry& entry = snapshot[i];
+        out << "KEY:" << entry.key << "\n";
+        for (const auto& pair : entry.data) {
+            out << pair.first << ":" << fieldValueTypeName(pair.second) << ":";
+            visitFieldValue(pair.second, [&out](const auto& value) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(value)>, Timestamp>) {
+                    out << value.millis;
+                } else {
+                    out << value;
+                }
+            });
+            out << "\n";
+        }
+        out << "---\n"; // Separator for entries
+    }
+}
+
+std::string partitionFileName(size_t index, uint64_t generation, bool compressed) {
+    std::ostringstream name;
+    name << "part-" << std::setw(6) << std::setfill('0') << index << "-g" << generation << ".dat";
+    if (compressed) {
+        name << kCompressedFileSuffix;
+    }
+    return name.str();
+}
+
+unsigned loadThreadCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores == 0 ? 1 : cores;
+}
+
+} // namespace
+
+bool PartitionManifest::loadFromFile(const std::string& path) {
+    std::ifstream inFile(path);
+    std::string line;
+    if (!inFile.is_open() || !std::getline(inFile, line) || line != "MANIFEST:1") {
+        return false;
+    }
+
+    PartitionManifest loaded;
+    while (std::getline(inFile, line)) {
+        std::stringstream ss(line);
+        std::string tag;
+        std::getline(ss, tag, ':');
+        if (tag == "GENERATION") {
+            ss >> loaded.generation;
+        } else if (tag == "ROWS") {
+            ss >> loaded.totalRows;
+        } else if (tag == "PARTITION_ROWS") {
+            ss >> loaded.rowsPerPartition;
+        } else if (tag == "SCHEMA") {
+            ss >> std::hex >> loaded.schemaHash;
+        } else if (tag == "DEDUP") {
+            std::getline(ss, loaded.dedupSpec);
+        } else if (tag == "PART") {
+            PartitionInfo part;
+            char separator;
+            if (!(ss >> part.index >> separator >> part.firstKey >> separator >> part.rowCount >> separator >> part.bytes >> separator)) {
+                return false;
+            }
+            std::getline(ss, part.fileName);
+            loaded.partitions.push_back(part);
+        }
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+bool PartitionManifest::saveToFile(const std::string& path) const {
+    std::string tempPath = path + ".tmp";
+    std::ofstream outFile(tempPath);
+    if (!outFile.is_open()) {
+        return false;
+    }
+    outFile << "MANIFEST:1\n";
+    outFile << "GENERATION:" << generation << "\n";
+    outFile << "ROWS:" << totalRows << "\n";
+    outFile << "PARTITION_ROWS:" << rowsPerPartition << "\n";
+    outFile << "SCHEMA:" << std::hex << schemaHash << std::dec << "\n";
+    if (!dedupSpec.empty()) {
+        outFile << "DEDUP:" << dedupSpec << "\n";
+    }
+    for (const auto& part : partitions) {
+        outFile << "PART:" << part.index << ":" << part.firstKey << ":" << part.rowCount << ":" << part.bytes << ":" << part.fileName << "\n";
+    }
+    outFile.close();
+    if (!outFile) {
+        return false;
+    }
+    return std::rename(tempPath.c_str(), path.c_str()) == 0; // Readers see the old or the new manifest, never half of one
+}
+
+PartitionStore::PartitionStore(const std::string& formName) : formName(formName), directory(directoryFor(formName)), schemaHash(0) {}
+
+std::string PartitionStore::directoryFor(const std::string& formName) {
+    return "Forms/" + formName + "_entries";
+}
+
+std::string PartitionStore::manifestPathFor(const std::string& formName) {
+    return directoryFor(formName) + "/manifest";
+}
+
+std::string PartitionStore::legacyFilePathFor(const std::string& formName) {
+    return "Forms/" + formName + "_entries.dat";
+}
+
+std::string PartitionStore::lockPathFor(const std::string& formName) {
+    return directoryFor(formName) + "/lock";
+}
+
+PartitionStore::ManifestStamp PartitionStore::currentStamp() const {
+    ManifestStamp stamp;
+    struct stat info;
+    if (::stat(manifestPathFor(formName).c_str(), &info) == 0) {
+        stamp.inode = info.st_ino;
+        stamp.size = info.st_size;
+        stamp.modifiedNanos = (intmax_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+    }
+    return stamp;
+}
+
+bool PartitionStore::load(std::vector<Entry>& rows, bool& needsMigration) {
+    TRACE_SCOPE("PartitionStore::load");
+    needsMigration = false;
+    std::unique_ptr<FileLock> lock;
+    if (std::filesystem::is_directory(directory)) {
+        lock = std::make_unique<FileLock>(lockPathFor(formName), FileLock::Mode::Shared);
+    }
+    ManifestStamp stamp = currentStamp();
+    PartitionManifest loaded;
+    if (!loaded.loadFromFile(manifestPathFor(formName))) {
+        // No partitioned copy yet: fall back to a pre-partition single entries file
+        if (!readEntriesFile(legacyFilePathFor(formName), rows, loadThreadCount())) {
+            return false;
+        }
+        needsMigration = true;
+        return true;
+    }
+
+    // Partitions are parsed concurrently into their own buffers, then appended in key order.
+    // With fewer partitions than cores each partition file is also split into byte ranges.
+    size_t partitionCount = loaded.partitions.size();
+    unsigned threads = loadThreadCount();
+    unsigned workerCount = (unsigned)std::min<size_t>(threads, partitionCount);
+    unsigned threadsPerPartition = workerCount == 0 ? 1 : std::max(1u, threads / workerCount);
+    std::vector<std::vector<Entry>> partitionRows(partitionCount);
+    std::vector<char> missing(partitionCount, 0);
+    std::atomic<size_t> nextPartition(0);
+    auto worker = [&]() {
+        for (size_t p = nextPartition++; p < partitionCount; p = nextPartition++) {
+            partitionRows[p].reserve(loaded.partitions[p].rowCount);
+            missing[p] = !readEntriesFile(directory + "/" + loaded.partitions[p].fileName, partitionRows[p], threadsPerPartition);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker(); // The calling thread takes part too
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    for (size_t p = 0; p < partitionCount; ++p) {
+        if (missing[p]) {
+            // Skipping it would leave a gap in the keys that the next save makes permanent
+            std::cerr << "Error: Missing or unreadable partition file " << loaded.partitions[p].fileName << " for form " << formName
+                      << "; the form is opened empty and will not be saved over." << std::endl;
+            rows.clear();
+            return false;
+        }
+    }
+    rows.reserve(rows.size() + loaded.totalRows);
+    for (size_t p = 0; p < partitionCount; ++p) {
+        std::move(partitionRows[p].begin(), partitionRows[p].end(), std::back_inserter(rows));
+        std::vector<Entry>().swap(partitionRows[p]); // Release each buffer as soon as it is merged
+    }
+    std::lock_guard<std::mutex> manifestLock(manifestMutex);
+    manifest = std::move(loaded);
+    seenStamp = stamp;
+    return true;
+}
+
+void PartitionStore::beginWrite() {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec); // The lock file lives in the directory
+    writeLock = std::make_unique<FileLock>(lockPathFor(formName), FileLock::Mode::Exclusive);
+}
+
+void PartitionStore::endWrite() {
+    writeLock.reset();
+}
+
+void PartitionStore::markPersisted(EntrySnapshotPtr snapshot) {
+    persisted = std::move(snapshot);
+}
+
+bool PartitionStore::save(const EntrySnapshotPtr& snapshot, bool rewriteAll) {
+    TRACE_SCOPE("PartitionStore::save");
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        std::cerr << "Error: Could not create entries directory " << directory << std::endl;
+        return false;
+    }
+    std::unique_ptr<FileLock> lock;
+    if (!writeLock) {
+        lock = std::make_unique<FileLock>(lockPathFor(formName), FileLock::Mode::Exclusive);
+    }
+
+    PartitionManifest next = getManifest();
+    PartitionManifest onDisk;
+    if (onDisk.loadFromFile(manifestPathFor(formName)) && onDisk.generation != next.generation) {
+        // Another process saved a version this one never read; writing over it would lose that update
+        std::cerr << "Error: Form " << formName << " was changed by another process that this one could not reload; not saved." << std::endl;
+        return false;
+    }
+    if (next.rowsPerPartition != kRowsPerPartition) {
+        rewriteAll = true; // Written with another partition size; dirty tracking does not apply
+    }
+
+    next.generation++;
+    next.totalRows = snapshot->size();
+    next.rowsPerPartition = kRowsPerPartition;
+    size_t partitionCount = (snapshot->size() + kRowsPerPartition - 1) / kRowsPerPartition;
+    const auto& segments = snapshot->getSegments();
+    const std::vector<EntrySegmentPtr>* oldSegments = persisted ? &persisted->getSegments() : nullptr;
+
+    bool compress = isCompressionEnabled(); // Unchanged partitions keep whichever format they were written in
+    std::vector<PartitionInfo> partitions;
+    partitions.reserve(partitionCount);
+    int64_t writtenPartitions = 0;
+    for (size_t p = 0; p < partitionCount; ++p) {
+        size_t begin = p * kRowsPerPartition;
+        size_t end = std::min(begin + kRowsPerPartition, snapshot->size());
+        size_t firstSegment = p * kSegmentsPerPartition;
+        size_t lastSegment = std::min(firstSegment + kSegmentsPerPartition, segments.size());
+
+        // Unchanged if it has the same rows and every segment is the very same object as in the persisted snapshot
+        bool dirty = rewriteAll || !oldSegments || p >= next.partitions.size() || next.partitions[p].rowCount != end - begin
+            || lastSegment > oldSegments->size();
+        for (size_t s = firstSegment; !dirty && s < lastSegment; ++s) {
+            dirty = segments[s] != (*oldSegments)[s];
+        }
+        if (!dirty) {
+            partitions.push_back(next.partitions[p]);
+            continue;
+        }
+
+        PartitionInfo part{p, (*snapshot)[begin].key, end - begin, 0, partitionFileName(p, next.generation, compress)};
+        std::string path = directory + "/" + part.fileName;
+        std::ofstream outFile(path + ".tmp", compress ? std::ios::out | std::ios::binary : std::ios::out);
+        if (!outFile.is_open()) {
+            std::cerr << "Error: Could not save entries to file " << path << std::endl;
+            return false;
+        }
+        bool written = true;
+        if (compress) {
+            Lz4FrameWriteBuf compressor(outFile);
+            std::ostream compressedOut(&compressor);
+            writeEntryRecords(compressedOut, *snapshot, begin, end);
+            written = compressor.finish() && !compressedOut.bad();
+        } else {
+            writeEntryRecords(outFile, *snapshot, begin, end);
+        }
+        part.bytes = (uintmax_t)outFile.tellp();
+        outFile.close();
+        if (!written || !outFile || std::rename((path + ".tmp").c_str(), path.c_str()) != 0) {
+            std::cerr << "Error: Could not write partition file " << path << std::endl;
+            return false;
+        }
+        partitions.push_back(part);
+        ++writtenPartitions;
+    }
+    if (rewriteAll || writtenPartitions == (int64_t)partitionCount) {
+        next.schemaHash = schemaHash; // Every partition now holds rows in the current schema
+    }
+    recordCounter("partitions.written", writtenPartitions);
+    recordCounter("entries.persisted", (int64_t)snapshot->size());
+
+    std::set<std::string> previousFiles;
+    for (const auto& part : next.partitions) {
+        previousFiles.insert(part.fileName);
+    }
+    next.partitions = std::move(partitions);
+    if (!next.saveToFile(manifestPathFor(formName))) {
+        std::cerr << "Error: Could not write manifest for form " << formName << std::endl;
+        return false;
+    }
+
+    // Only now are the replaced files unreferenced
+    for (const auto& part : next.partitions) {
+        previousFiles.erase(part.fileName);
+    }
+    for (const auto& fileName : previousFiles) {
+        std::remove((directory + "/" + fileName).c_str());
+    }
+
+    {
+        std::lock_guard<std::mutex> manifestLock(manifestMutex);
+        manifest = std::move(next);
+        seenStamp = currentStamp();
+    }
+    persisted = snapshot;
+    return true;
+}
+
+bool PartitionStore::hasChangedOnDisk() const {
+    ManifestStamp stamp = currentStamp();
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    return !(stamp == seenStamp);
+}
+
+EntrySnapshotPtr PartitionStore::reload(uint64_t version, std::shared_ptr<const SchemaMigration> migration) {
+    TRACE_SCOPE("PartitionStore::reload");
+    if (!std::filesystem::is_directory(directory)) {
+        return nullptr;
+    }
+    std::unique_ptr<FileLock> lock;
+    if (!writeLock) {
+        lock = std::make_unique<FileLock>(lockPathFor(formName), FileLock::Mode::Shared);
+    }
+    ManifestStamp stamp = currentStamp();
+    PartitionManifest loaded;
+    PartitionManifest current = getManifest();
+    if (!loaded.loadFromFile(manifestPathFor(formName))) {
+        return nullptr;
+    }
+    if (loaded.generation == current.generation) {
+        std::lock_guard<std::mutex> manifestLock(manifestMutex);
+        seenStamp = stamp;
+        return nullptr;
+    }
+
+    // A file name encodes the partition index and the generation that wrote it, so an
+    // unchanged name means unchanged rows
+    std::map<std::string, size_t> kept; // File name -> partition index in 'persisted'
+    if (persisted && current.rowsPerPartition == kRowsPerPartition && loaded.rowsPerPartition == kRowsPerPartition) {
+        for (const auto& part : current.partitions) {
+            kept[part.fileName] = part.index;
+        }
+    }
+
+    if (loaded.schemaHash == schemaHash) {
+        migration = nullptr; // Every partition is already in the current schema
+    }
+    std::vector<EntrySegmentPtr> segments;
+    int64_t readPartitions = 0;
+    for (const auto& part : loaded.partitions) {
+        auto same = kept.find(part.fileName);
+        size_t firstSegment = part.index * kSegmentsPerPartition;
+        if (same != kept.end() && same->second == part.index && firstSegment < persisted->getSegments().size()) {
+            const auto& oldSegments = persisted->getSegments();
+            size_t lastSegment = std::min(firstSegment + kSegmentsPerPartition, oldSegments.size());
+            segments.insert(segments.end(), oldSegments.begin() + firstSegment, oldSegments.begin() + lastSegment);
+            continue;
+        }
+        std::vector<Entry> rows;
+        rows.reserve(part.rowCount);
+        if (!readEntriesFile(directory + "/" + part.fileName, rows, loadThreadCount())) {
+            std::cerr << "Error: Missing or unreadable partition file " << part.fileName << " for form " << formName << std::endl;
+            return nullptr; // The stamp is not recorded, so the next reload tries again
+        }
+        auto partSnapshot = EntrySnapshot::fromEntries(std::move(rows), 0, migration);
+        segments.insert(segments.end(), partSnapshot->getSegments().begin(), partSnapshot->getSegments().end());
+        ++readPartitions;
+    }
+    recordCounter("partitions.reloaded", readPartitions);
+
+    auto snapshot = EntrySnapshot::fromSegments(std::move(segments), version);
+    {
+        std::lock_guard<std::mutex> manifestLock(manifestMutex);
+        manifest = std::move(loaded);
+        seenStamp = stamp;
+    }
+    persisted = snapshot;
+    return snapshot;
+}
+
+void PartitionStore::removeLegacyFile() {
+    std::remove(legacyFilePathFor(formName).c_str());
+    std::remove((legacyFilePathFor(formName) + ".widths").c_str()); // Its width stats sidecar
+}
+
+void PartitionStore::setDedupSpec(const std::string& spec) {
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    manifest.dedupSpec = spec;
+}
+
+PartitionManifest PartitionStore::getManifest() const {
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    return manifest;
+}
+
+uintmax_t PartitionStore::totalBytes() const {
+    std::lock_guard<std::mutex> lock(manifestMutex);
+    uintmax_t bytes = 0;
+    for (const auto& part : manifest.partitions) {
+        bytes += part.bytes;
+    }
+    return bytes;
+}
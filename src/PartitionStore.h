@@ -0,0 +1,127 @@
+#ifndef PARTITION_STORE_H
+#define PARTITION_STORE_H
+
+#include <string>
+#include <vector>
+#include <mutex> // For std::mutex
+#include <memory> // For std::unique_ptr
+#include <cstdint>
+#include "EntrySnapshot.h" // For EntrySnapshotPtr
+#include "FileLock.h" // For FileLock
+
+// One partition file as listed in the manifest
+struct PartitionInfo {
+    size_t index;
+    int firstKey;
+    size_t rowCount;
+    uintmax_t bytes;
+    std::string fileName; // Relative to the partition directory
+};
+
+// Forms/<form>_entries/manifest: which partition files make up the current version
+struct PartitionManifest {
+    uint64_t generation = 0; // Bumped by every save
+    size_t totalRows = 0;
+    size_t rowsPerPartition = 0;
+    uint64_t schemaHash = 0; // Form schema every partition is known to be written in, 0 if unknown or mixed
+    std::string dedupSpec; // Uniqueness mode (see DedupSettings), empty when off
+    std::vector<PartitionInfo> partitions;
+
+    bool loadFromFile(const std::string& path);
+    bool saveToFile(const std::string& path) const;
+};
+
+// Stores a form's entries as fixed-size partitions by key range, each in its own file,
+// plus a manifest. Keys are dense (1..n), so partition p holds keys
+// [p * kRowsPerPartition + 1, (p + 1) * kRowsPerPartition].
+// A partition covers a whole number of EntrySnapshot segments; a save compares segment
+// pointers with the last persisted snapshot and rewrites only partitions whose segments
+// changed. Partition files are never overwritten: each save writes new generation-tagged
+// files, switches the manifest with a rename, then deletes files it no longer lists.
+// With compression enabled, newly written partitions are LZ4 frames named "*.dat.lz4".
+//
+// Several processes may open the same form. A writer holds an exclusive FileLock on
+// "<directory>/lock" across its whole read-modify-write (beginWrite/endWrite): it reloads
+// what other processes saved, applies its change and saves, so no update is lost. Loads and
+// reloads hold the lock shared, so they never see a manifest whose files are gone.
+// A reader notices another process's save by a stat() of the manifest and reloads only
+// the partitions whose file names changed.
+class PartitionStore {
+private:
+    // Identity of the manifest file last read or written. A save replaces it by rename, so
+    // the inode changes; size and modification time cover an inode number being reused.
+    struct ManifestStamp {
+        uintmax_t inode = 0;
+        uintmax_t size = 0;
+        intmax_t modifiedNanos = 0;
+        bool operator==(const ManifestStamp& other) const {
+            return inode == other.inode && size == other.size && modifiedNanos == other.modifiedNanos;
+        }
+    };
+
+    std::string formName;
+    std::string directory;
+    PartitionManifest manifest; // Guarded by manifestMutex
+    mutable std::mutex manifestMutex;
+    EntrySnapshotPtr persisted; // Last snapshot written or loaded
+    uint64_t schemaHash; // Schema that rows are written in, recorded once all partitions hold it
+    ManifestStamp seenStamp; // Guarded by manifestMutex
+    std::unique_ptr<FileLock> writeLock; // Held between beginWrite() and endWrite()
+
+    ManifestStamp currentStamp() const;
+
+public:
+    static const size_t kSegmentsPerPartition = 64;
+    static const size_t kRowsPerPartition = kSegmentsPerPartition * EntrySnapshot::kSegmentCapacity;
+
+    explicit PartitionStore(const std::string& formName);
+
+    static std::string directoryFor(const std::string& formName); // Forms/<form>_entries
+    static std::string manifestPathFor(const std::string& formName);
+    static std::string legacyFilePathFor(const std::string& formName); // Pre-partition Forms/<form>_entries.dat
+    static std::string lockPathFor(const std::string& formName);
+
+    // Reads all partitions in key order. A legacy single-file form is read from that file
+    // and 'needsMigration' is set; the caller then saves once and calls removeLegacyFile().
+    // Returns false when nothing is stored yet, or when a listed partition file is missing or
+    // unreadable; the latter is reported, and save() then refuses to replace the stored files.
+    bool load(std::vector<Entry>& rows, bool& needsMigration);
+
+    // Takes the exclusive lock for a read-modify-write; until endWrite(), reload() and save()
+    // run under it instead of locking again. The caller serializes its own threads' writes.
+    void beginWrite();
+    void endWrite();
+
+    // Records that 'snapshot' matches what is on disk, e.g. right after load()
+    void markPersisted(EntrySnapshotPtr snapshot);
+
+    // Writes the partitions of 'snapshot' that differ from the last persisted snapshot;
+    // 'rewriteAll' writes every partition. Returns false if the manifest could not be written,
+    // or if another process saved a generation this store has not reloaded: that save is kept
+    // and this one refused, rather than overwriting it.
+    bool save(const EntrySnapshotPtr& snapshot, bool rewriteAll = false);
+
+    void removeLegacyFile();
+
+    // True if another process saved since this store last loaded or saved; one stat()
+    bool hasChangedOnDisk() const;
+
+    // Brings the persisted snapshot up to date with the manifest on disk. Partitions whose
+    // file is unchanged keep their segments; only the others are read. Returns null if the
+    // stored generation is the one already loaded, or the manifest or a partition file cannot
+    // be read; the latter is retried by the next reload. Rows read from a manifest whose schema
+    // is not the one set by setSchemaHash() get 'migration' applied lazily, as on load.
+    EntrySnapshotPtr reload(uint64_t version, std::shared_ptr<const SchemaMigration> migration = nullptr);
+
+    // Schema of the rows passed to save(); the manifest records it after a save that wrote every partition
+    void setSchemaHash(uint64_t hash) { schemaHash = hash; }
+
+    // Stored in the manifest by the next save()
+    void setDedupSpec(const std::string& spec);
+
+    PartitionManifest getManifest() const;
+    uintmax_t totalBytes() const;
+    std::string getDirectory() const { return directory; }
+};
+
+#endif // PARTITION_STORE_H
@@ -0,0 +1,475 @@
+#include "SaveAsArrow.h"
+#include "FormDefinition.h" // For FormDefinition struct
+#include "Entry.h"          // For Entry struct
+#include "EntryReader.h"    // For EntrySource
+#include "ColumnBatch.h"    // For ColumnBatch, appendLittleEndian
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "BlockCompression.h" // For OutputFile
+#include <iostream>
+#include <algorithm> // For std::stable_sort, std::max
+
+namespace {
+
+// --- Minimal FlatBuffers encoder for the Arrow metadata ---
+//
+// The reference builder fills its buffer back to front. This one lays objects out front to
+// back instead: each object is followed by the objects it references, so every offset points
+// forward as the format requires. Good enough for the handful of small tables Arrow needs.
+
+struct FlatObject;
+using FlatObjectPtr = std::shared_ptr<FlatObject>;
+
+struct FlatObject {
+    enum class Kind { Table, String, TableVector, StructVector };
+
+    struct Slot {
+        uint16_t id; // Field index in the schema definition
+        std::vector<uint8_t> scalar; // Inline little-endian value; empty for references
+        FlatObjectPtr reference;
+    };
+
+    Kind kind = Kind::Table;
+    std::vector<Slot> slots; // Table
+    std::vector<uint8_t> bytes; // String text or packed struct elements
+    size_t count = 0; // StructVector elements
+    size_t alignment = 1; // StructVector element alignment
+    std::vector<FlatObjectPtr> elements; // TableVector
+
+    template <typename T>
+    FlatObject& scalar(uint16_t id, T value) {
+        Slot slot{id, {}, nullptr};
+        appendLittleEndian(slot.scalar, value);
+        slots.push_back(std::move(slot));
+        return *this;
+    }
+
+    FlatObject& reference(uint16_t id, FlatObjectPtr object) {
+        slots.push_back(Slot{id, {}, std::move(object)});
+        return *this;
+    }
+};
+
+FlatObjectPtr flatTable() {
+    return std::make_shared<FlatObject>();
+}
+
+FlatObjectPtr flatString(const std::string& text) {
+    auto object = std::make_shared<FlatObject>();
+    object->kind = FlatObject::Kind::String;
+    object->bytes.assign(text.begin(), text.end());
+    return object;
+}
+
+FlatObjectPtr flatTableVector(std::vector<FlatObjectPtr> elements) {
+    auto object = std::make_shared<FlatObject>();
+    object->kind = FlatObject::Kind::TableVector;
+    object->elements = std::move(elements);
+    return object;
+}
+
+FlatObjectPtr flatStructVector(std::vector<uint8_t> packed, size_t count, size_t alignment) {
+    auto object = std::make_shared<FlatObject>();
+    object->kind = FlatObject::Kind::StructVector;
+    object->bytes = std::move(packed);
+    object->count = count;
+    object->alignment = alignment;
+    return object;
+}
+
+class FlatWriter {
+private:
+    std::vector<uint8_t> out;
+
+    void padTo(size_t alignment) {
+        while (out.size() % alignment != 0) {
+            out.push_back(0);
+        }
+    }
+
+    void putU32(size_t at, uint32_t value) {
+        std::vector<uint8_t> bytes;
+        appendLittleEndian(bytes, value);
+        std::copy(bytes.begin(), bytes.end(), out.begin() + at);
+    }
+
+    void putU16(uint16_t value) {
+        appendLittleEndian(out, value);
+    }
+
+    size_t writeTable(const FlatObject& table) {
+        uint16_t slotCount = 0;
+        for (const auto& slot : table.slots) {
+            slotCount = std::max<uint16_t>(slotCount, slot.id + 1);
+        }
+        const size_t vtableSize = 4 + 2 * (size_t)slotCount;
+        padTo(2);
+        if ((out.size() + vtableSize) % 4 != 0) {
+            out.insert(out.end(), 2, 0); // The table itself must start 4-aligned
+        }
+        const size_t vtablePos = out.size();
+        const size_t tablePos = vtablePos + vtableSize;
+
+        // Largest fields first; each is aligned to its size within the buffer
+        std::vector<size_t> order(table.slots.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        auto slotSize = [&table](size_t i) { return table.slots[i].reference ? (size_t)4 : table.slots[i].scalar.size(); };
+        std::stable_sort(order.begin(), order.end(), [&slotSize](size_t a, size_t b) { return slotSize(a) > slotSize(b); });
+        std::vector<size_t> positions(table.slots.size());
+        size_t cursor = tablePos + 4; // After the vtable offset
+        for (size_t i : order) {
+            size_t size = slotSize(i);
+            cursor = (cursor + size - 1) / size * size;
+            positions[i] = cursor;
+            cursor += size;
+        }
+
+        std::vector<uint16_t> fieldOffsets(slotCount, 0);
+        for (size_t i = 0; i < table.slots.size(); ++i) {
+            fieldOffsets[table.slots[i].id] = (uint16_t)(positions[i] - tablePos);
+        }
+        putU16((uint16_t)vtableSize);
+        putU16((uint16_t)(cursor - tablePos));
+        for (uint16_t offset : fieldOffsets) {
+            putU16(offset);
+        }
+        appendLittleEndian<int32_t>(out, (int32_t)(tablePos - vtablePos));
+        out.resize(cursor, 0);
+        for (size_t i = 0; i < table.slots.size(); ++i) {
+            std::copy(table.slots[i].scalar.begin(), table.slots[i].scalar.end(), out.begin() + positions[i]);
+        }
+
+        for (size_t i = 0; i < table.slots.size(); ++i) {
+            if (table.slots[i].reference) {
+                size_t target = write(*table.slots[i].reference);
+                putU32(positions[i], (uint32_t)(target - positions[i]));
+            }
+        }
+        return tablePos;
+    }
+
+public:
+    // Writes 'object' and everything it references; returns its position
+    size_t write(const FlatObject& object) {
+        switch (object.kind) {
+            case FlatObject::Kind::Table:
+                return writeTable(object);
+            case FlatObject::Kind::String: {
+                padTo(4);
+                size_t position = out.size();
+                appendLittleEndian<uint32_t>(out, (uint32_t)object.bytes.size());
+                out.insert(out.end(), object.bytes.begin(), object.bytes.end());
+                out.push_back(0); // Strings are NUL terminated
+                return position;
+            }
+            case FlatObject::Kind::StructVector: {
+                padTo(4);
+                if ((out.size() + 4) % object.alignment != 0) {
+                    out.insert(out.end(), 4, 0); // Elements follow the length and need their own alignment
+                }
+                size_t position = out.size();
+                appendLittleEndian<uint32_t>(out, (uint32_t)object.count);
+                out.insert(out.end(), object.bytes.begin(), object.bytes.end());
+                return position;
+            }
+            case FlatObject::Kind::TableVector: {
+                padTo(4);
+                size_t position = out.size();
+                appendLittleEndian<uint32_t>(out, (uint32_t)object.elements.size());
+                out.resize(out.size() + 4 * object.elements.size(), 0);
+                for (size_t i = 0; i < object.elements.size(); ++i) {
+                    size_t slot = position + 4 + 4 * i;
+                    putU32(slot, (uint32_t)(write(*object.elements[i]) - slot));
+                }
+                return position;
+            }
+        }
+        return 0;
+    }
+
+    // Encodes a buffer whose root is 'root', padded to 8 bytes
+    static std::vector<uint8_t> finish(const FlatObject& root) {
+        FlatWriter writer;
+        writer.out.resize(4, 0); // Root table offset
+        writer.putU32(0, (uint32_t)writer.write(root));
+        writer.padTo(8);
+        return std::move(writer.out);
+    }
+};
+
+// --- Arrow IPC file ---
+
+// Values from the Arrow format's Schema.fbs and Message.fbs
+const int16_t kMetadataVersionV5 = 4;
+const uint8_t kHeaderSchema = 1;
+const uint8_t kHeaderDictionaryBatch = 2;
+const uint8_t kHeaderRecordBatch = 3;
+const uint8_t kTypeInt = 2;
+const uint8_t kTypeFloatingPoint = 3;
+const uint8_t kTypeUtf8 = 5;
+const uint8_t kTypeTimestamp = 10;
+const int16_t kPrecisionSingle = 1;
+const int16_t kPrecisionDouble = 2;
+const int16_t kTimeUnitMillisecond = 1;
+const char kArrowMagic[] = "ARROW1";
+
+FlatObjectPtr intType(int32_t bitWidth) {
+    auto type = flatTable();
+    type->scalar<int32_t>(0, bitWidth).scalar<bool>(1, true);
+    return type;
+}
+
+// The Arrow Field table for a column; dictionary columns reference dictionary 'dictionaryId'
+FlatObjectPtr arrowField(const ColumnBatch::Column& column, int64_t dictionaryId) {
+    auto field = flatTable();
+    field->reference(0, flatString(column.name));
+    field->scalar<bool>(1, column.nullable);
+    switch (column.encoding) {
+        case ColumnBatch::Encoding::Int32:
+            field->scalar<uint8_t>(2, kTypeInt).reference(3, intType(32));
+            break;
+        case ColumnBatch::Encoding::Float32:
+        case ColumnBatch::Encoding::Float64: {
+            auto type = flatTable();
+            type->scalar<int16_t>(0, column.encoding == ColumnBatch::Encoding::Float32 ? kPrecisionSingle : kPrecisionDouble);
+            field->scalar<uint8_t>(2, kTypeFloatingPoint).reference(3, type);
+            break;
+        }
+        case ColumnBatch::Encoding::TimestampMillis: {
+            auto type = flatTable();
+            type->scalar<int16_t>(0, kTimeUnitMillisecond).reference(1, flatString("UTC"));
+            field->scalar<uint8_t>(2, kTypeTimestamp).reference(3, type);
+            break;
+        }
+        case ColumnBatch::Encoding::Utf8:
+        case ColumnBatch::Encoding::Dictionary:
+            field->scalar<uint8_t>(2, kTypeUtf8).reference(3, flatTable());
+            break;
+    }
+    if (column.encoding == ColumnBatch::Encoding::Dictionary) {
+        auto encoding = flatTable();
+        encoding->scalar<int64_t>(0, dictionaryId).reference(1, intType(32)).scalar<bool>(2, false);
+        field->reference(4, encoding);
+    }
+    field->reference(5, flatTableVector({})); // Readers expect the children vector even when empty
+    return field;
+}
+
+// Message body under construction: buffers padded to 8 bytes, plus their metadata
+struct ArrowBody {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> nodes; // FieldNode structs
+    std::vector<uint8_t> buffers; // Buffer structs
+    size_t nodeCount = 0;
+    size_t bufferCount = 0;
+
+    void addNode(size_t length, size_t nullCount) {
+        appendLittleEndian<int64_t>(nodes, (int64_t)length);
+        appendLittleEndian<int64_t>(nodes, (int64_t)nullCount);
+        ++nodeCount;
+    }
+
+    void addBuffer(const std::vector<uint8_t>& data) {
+        appendLittleEndian<int64_t>(buffers, (int64_t)bytes.size());
+        appendLittleEndian<int64_t>(buffers, (int64_t)data.size());
+        ++bufferCount;
+        bytes.insert(bytes.end(), data.begin(), data.end());
+        bytes.resize((bytes.size() + 7) / 8 * 8, 0);
+    }
+
+    void addOffsets(const std::vector<int32_t>& offsets) {
+        std::vector<uint8_t> data;
+        data.reserve(offsets.size() * sizeof(int32_t));
+        for (int32_t offset : offsets) {
+            appendLittleEndian(data, offset);
+        }
+        addBuffer(data);
+    }
+
+    FlatObjectPtr recordBatch(size_t length) {
+        auto batch = flatTable();
+        batch->scalar<int64_t>(0, (int64_t)length);
+        batch->reference(1, flatStructVector(std::move(nodes), nodeCount, 8));
+        batch->reference(2, flatStructVector(std::move(buffers), bufferCount, 8));
+        return batch;
+    }
+};
+
+class ArrowFileWriter {
+private:
+    std::ostream& out;
+    uint64_t position;
+    std::vector<uint8_t> dictionaryBlocks; // Block structs for the footer
+    std::vector<uint8_t> recordBatchBlocks;
+    size_t dictionaryBlockCount;
+    size_t recordBatchBlockCount;
+    std::vector<bool> dictionarySent; // Per column: initial dictionary batch written
+
+    void writeRaw(const void* data, size_t size) {
+        out.write(static_cast<const char*>(data), (std::streamsize)size);
+        position += size;
+    }
+
+    void writeRaw(const std::vector<uint8_t>& bytes) {
+        writeRaw(bytes.data(), bytes.size());
+    }
+
+    // Writes an encapsulated message and records its Block in 'blocks'
+    void writeMessage(uint8_t headerType, FlatObjectPtr header, const std::vector<uint8_t>& body,
+                      std::vector<uint8_t>* blocks, size_t* blockCount) {
+        auto message = flatTable();
+        message->scalar<int16_t>(0, kMetadataVersionV5);
+        message->scalar<uint8_t>(1, headerType).reference(2, std::move(header));
+        message->scalar<int64_t>(3, (int64_t)body.size());
+        std::vector<uint8_t> metadata = FlatWriter::finish(*message);
+
+        uint64_t start = position;
+        std::vector<uint8_t> prefix;
+        appendLittleEndian<uint32_t>(prefix, 0xFFFFFFFFu); // Continuation marker
+        appendLittleEndian<int32_t>(prefix, (int32_t)metadata.size());
+        writeRaw(prefix);
+        writeRaw(metadata);
+        writeRaw(body);
+        if (blocks) {
+            appendLittleEndian<int64_t>(*blocks, (int64_t)start);
+            appendLittleEndian<int32_t>(*blocks, (int32_t)(prefix.size() + metadata.size()));
+            appendLittleEndian<int32_t>(*blocks, 0); // Struct padding
+            appendLittleEndian<int64_t>(*blocks, (int64_t)body.size());
+            ++*blockCount;
+        }
+    }
+
+    FlatObjectPtr schema(const ColumnBatch& batch) const {
+        std::vector<FlatObjectPtr> fields;
+        const auto& columns = batch.getColumns();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            fields.push_back(arrowField(columns[i], (int64_t)i));
+        }
+        auto table = flatTable();
+        table->scalar<int16_t>(0, 0); // Little endian
+        table->reference(1, flatTableVector(std::move(fields)));
+        return table;
+    }
+
+    // Writes the dictionary entries of column 'index' that no batch has carried yet
+    void writeDictionary(ColumnBatch::Column& column, size_t index) {
+        bool delta = dictionarySent[index];
+        if (delta && column.dictionaryWritten == column.dictionary.size()) {
+            return;
+        }
+        ArrowBody body;
+        std::vector<int32_t> offsets{0};
+        std::vector<uint8_t> text;
+        for (size_t i = column.dictionaryWritten; i < column.dictionary.size(); ++i) {
+            text.insert(text.end(), column.dictionary[i].begin(), column.dictionary[i].end());
+            offsets.push_back((int32_t)text.size());
+        }
+        size_t added = column.dictionary.size() - column.dictionaryWritten;
+        body.addNode(added, 0);
+        body.addBuffer({}); // No validity bitmap: dictionary entries are never null
+        body.addOffsets(offsets);
+        body.addBuffer(text);
+
+        auto header = flatTable();
+        header->scalar<int64_t>(0, (int64_t)index).reference(1, body.recordBatch(added)).scalar<bool>(2, delta);
+        writeMessage(kHeaderDictionaryBatch, header, body.bytes, &dictionaryBlocks, &dictionaryBlockCount);
+        column.dictionaryWritten = column.dictionary.size();
+        dictionarySent[index] = true;
+    }
+
+public:
+    ArrowFileWriter(std::ostream& out, const ColumnBatch& batch)
+        : out(out), position(0), dictionaryBlockCount(0), recordBatchBlockCount(0),
+          dictionarySent(batch.getColumns().size(), false) {
+        writeRaw(kArrowMagic, 6);
+        writeRaw("\0\0", 2); // Pad to 8 bytes
+        writeMessage(kHeaderSchema, schema(batch), {}, nullptr, nullptr);
+    }
+
+    void writeBatch(ColumnBatch& batch) {
+        auto& columns = batch.getColumns();
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i].encoding == ColumnBatch::Encoding::Dictionary) {
+                writeDictionary(columns[i], i);
+            }
+        }
+        if (batch.rowCount() == 0) {
+            return;
+        }
+
+        ArrowBody body;
+        for (const auto& column : columns) {
+            body.addNode(batch.rowCount(), column.nullCount);
+            body.addBuffer(column.nullCount > 0 ? column.validity : std::vector<uint8_t>());
+            if (column.encoding == ColumnBatch::Encoding::Utf8) {
+                body.addOffsets(column.offsets);
+            }
+            body.addBuffer(column.values);
+        }
+        writeMessage(kHeaderRecordBatch, body.recordBatch(batch.rowCount()), body.bytes, &recordBatchBlocks, &recordBatchBlockCount);
+    }
+
+    void finish(ColumnBatch& batch) {
+        writeBatch(batch); // Flushes the last rows, and the dictionaries if no batch carried them yet
+
+        std::vector<uint8_t> endOfStream;
+        appendLittleEndian<uint32_t>(endOfStream, 0xFFFFFFFFu);
+        appendLittleEndian<int32_t>(endOfStream, 0);
+        writeRaw(endOfStream);
+
+        auto footer = flatTable();
+        footer->scalar<int16_t>(0, kMetadataVersionV5);
+        footer->reference(1, schema(batch));
+        footer->reference(2, flatStructVector(dictionaryBlocks, dictionaryBlockCount, 8));
+        footer->reference(3, flatStructVector(recordBatchBlocks, recordBatchBlockCount, 8));
+        std::vector<uint8_t> encoded = FlatWriter::finish(*footer);
+        writeRaw(encoded);
+        std::vector<uint8_t> footerSize;
+        appendLittleEndian<int32_t>(footerSize, (int32_t)encoded.size());
+        writeRaw(footerSize);
+        writeRaw(kArrowMagic, 6);
+    }
+};
+
+} // namespace
+
+void saveAsArrow(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries) {
+    VectorEntrySource source(entries);
+    saveAsArrow(filename, formDef, source);
+}
+
+void saveAsArrow(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries) {
+    TRACE_SCOPE("saveAsArrow");
+    if (!formDef) {
+        std::cerr << "Error: No form definition provided for Arrow export.\n";
+        return;
+    }
+
+    OutputFile output(filename); // Written as <filename>.lz4 when compression is enabled
+    if (!output.isOpen()) {
+        std::cerr << "Error: Could not open file " << output.getPath() << " for Arrow export.\n";
+        return;
+    }
+
+    ColumnBatch batch(*formDef);
+    ArrowFileWriter writer(output.stream(), batch);
+    EntryView entry;
+    int64_t exportedRows = 0;
+    while (entries.nextView(entry)) {
+        ++exportedRows;
+        batch.append(entry);
+        if (batch.rowCount() == ColumnBatch::kDefaultRowsPerBatch) {
+            writer.writeBatch(batch);
+            batch.clear();
+        }
+    }
+    writer.finish(batch);
+
+    if (!output.close()) {
+        std::cerr << "Error: Could not write file " << output.getPath() << " for Arrow export.\n";
+        return;
+    }
+    recordCounter("export.rows", exportedRows);
+    std::cout << "Entries saved to " << output.getPath() << " as Arrow IPC successfully.\n";
+}
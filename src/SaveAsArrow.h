@@ -0,0 +1,23 @@
+#ifndef SAVE_AS_ARROW_H
+#define SAVE_AS_ARROW_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+// Forward declarations to avoid circular dependencies
+struct FormDefinition;
+struct Entry;
+class EntrySource;
+
+// Writes an Apache Arrow IPC file (the ".arrow" random access format, metadata version V5).
+// Columns: KEY int32, string fields utf8, number fields int32/float32/float64, timestamp fields
+// timestamp[ms, UTC], and select fields dictionary<int32, utf8> seeded with the form's options.
+// Rows are written in record batches of ColumnBatch::kDefaultRowsPerBatch; select values that
+// are not options are added with delta dictionary batches.
+void saveAsArrow(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries);
+
+// Streaming variant: rows are pulled from the source one at a time and written in batches
+void saveAsArrow(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries);
+
+#endif // SAVE_AS_ARROW_H
@@ -1,19 +1,57 @@
 #include "SaveAsCSV.h"
 #include "FormDefinition.h" // For FormDefinition struct
 #include "Entry.h"          // For Entry struct
+#include "EntryReader.h"    // For EntrySource
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "BlockCompression.h" // For OutputFile
 #include <fstream>
 #include <iostream>
-#include <algorithm> // For std::replace
+#include <string_view>
+
+namespace {
+
+// Strings are quoted; double quotes inside are replaced with single quotes
+void writeCsvValue(std::ostream& out, std::string_view value) {
+    out << '"';
+    for (size_t start = 0; start < value.size();) {
+        size_t quote = value.find('"', start);
+        if (quote == std::string_view::npos) {
+            out << value.substr(start);
+            break;
+        }
+        out << value.substr(start, quote - start) << '\'';
+        start = quote + 1;
+    }
+    out << '"';
+}
+
+void writeCsvValue(std::ostream& out, Timestamp value) {
+    out << formatTimestamp(value);
+}
+
+template <typename Number>
+void writeCsvValue(std::ostream& out, Number value) {
+    out << value;
+}
+
+} // namespace
 
 void saveAsCSV(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries) {
+    VectorEntrySource source(entries);
+    saveAsCSV(filename, formDef, source);
+}
+
+void saveAsCSV(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries) {
+    TRACE_SCOPE("saveAsCSV");
     if (!formDef) {
         std::cerr << "Error: No form definition provided for CSV export.\n";
         return;
     }
 
-    std::ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for CSV export.\n";
+    OutputFile output(filename); // Written as <filename>.lz4 when compression is enabled
+    std::ostream& outFile = output.stream();
+    if (!output.isOpen()) {
+        std::cerr << "Error: Could not open file " << output.getPath() << " for CSV export.\n";
         return;
     }
 
@@ -25,33 +63,24 @@ void saveAsCSV(const std::string& filename, const std::shared_ptr<FormDefinition
     outFile << "\n";
 
     // Write entries
-    for (const auto& entry : entries) {
+    EntryView entry;
+    int64_t exportedRows = 0;
+    while (entries.nextView(entry)) {
+        ++exportedRows;
         outFile << entry.key;
         for (const auto& field : formDef->fields) {
             outFile << ",";
-            if (entry.data.count(field->name)) {
-                // Handle different std::any types for writing to CSV
-                if (field->type == "string") {
-                    std::string value = std::any_cast<std::string>(entry.data.at(field->name));
-                    // Escape commas and quotes for CSV
-                    std::replace(value.begin(), value.end(), '"', '\''); // Replace double quotes with single quotes
-                    outFile << "\"" << value << "\"";
-                } else if (field->type == "int") {
-                    outFile << std::any_cast<int>(entry.data.at(field->name));
-                } else if (field->type == "float") {
-                    outFile << std::any_cast<float>(entry.data.at(field->name));
-                } else if (field->type == "double") {
-                    outFile << std::any_cast<double>(entry.data.at(field->name));
-                } else if (field->type == "select") {
-                    std::string value = std::any_cast<std::string>(entry.data.at(field->name));
-                    std::replace(value.begin(), value.end(), '"', '\'');
-                    outFile << "\"" << value << "\"";
-                }
+            if (const FieldValueView* value = entry.find(field->name)) {
+                visitFieldValueView(*value, [&outFile](const auto& typed) { writeCsvValue(outFile, typed); });
             }
         }
         outFile << "\n";
     }
 
-    outFile.close();
-    std::cout << "Entries saved to " << filename << " as CSV successfully.\n";
+    if (!output.close()) {
+        std::cerr << "Error: Could not write file " << output.getPath() << " for CSV export.\n";
+        return;
+    }
+    recordCounter("export.rows", exportedRows);
+    std::cout << "Entries saved to " << output.getPath() << " as CSV successfully.\n";
 }
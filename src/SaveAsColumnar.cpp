@@ -0,0 +1,101 @@
+#include "SaveAsColumnar.h"
+#include "FormDefinition.h" // For FormDefinition struct
+#include "Entry.h"          // For Entry struct
+#include "EntryReader.h"    // For EntrySource
+#include "ColumnBatch.h"    // For ColumnBatch
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "BlockCompression.h" // For OutputFile
+#include <iostream>
+
+namespace {
+
+const char kColumnarMagic[] = "TODOCOL1";
+
+void writeBytes(std::ostream& out, const std::vector<uint8_t>& bytes) {
+    out.write(reinterpret_cast<const char*>(bytes.data()), (std::streamsize)bytes.size());
+}
+
+void writeU32(std::ostream& out, uint32_t value) {
+    std::vector<uint8_t> bytes;
+    appendLittleEndian(bytes, value);
+    writeBytes(out, bytes);
+}
+
+void writeText(std::ostream& out, const std::string& text) {
+    writeU32(out, (uint32_t)text.size());
+    out.write(text.data(), (std::streamsize)text.size());
+}
+
+void writeBatch(std::ostream& out, ColumnBatch& batch) {
+    writeU32(out, (uint32_t)batch.rowCount());
+    std::vector<uint8_t> scratch;
+    for (auto& column : batch.getColumns()) {
+        writeBytes(out, column.validity);
+        if (column.encoding == ColumnBatch::Encoding::Utf8) {
+            scratch.clear();
+            for (int32_t offset : column.offsets) {
+                appendLittleEndian<uint32_t>(scratch, (uint32_t)offset);
+            }
+            writeBytes(out, scratch);
+        } else if (column.encoding == ColumnBatch::Encoding::Dictionary) {
+            writeU32(out, (uint32_t)(column.dictionary.size() - column.dictionaryWritten));
+            for (; column.dictionaryWritten < column.dictionary.size(); ++column.dictionaryWritten) {
+                writeText(out, column.dictionary[column.dictionaryWritten]);
+            }
+        }
+        writeBytes(out, column.values);
+    }
+}
+
+} // namespace
+
+void saveAsColumnar(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries) {
+    VectorEntrySource source(entries);
+    saveAsColumnar(filename, formDef, source);
+}
+
+void saveAsColumnar(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries) {
+    TRACE_SCOPE("saveAsColumnar");
+    if (!formDef) {
+        std::cerr << "Error: No form definition provided for columnar export.\n";
+        return;
+    }
+
+    OutputFile output(filename); // Written as <filename>.lz4 when compression is enabled
+    std::ostream& outFile = output.stream();
+    if (!output.isOpen()) {
+        std::cerr << "Error: Could not open file " << output.getPath() << " for columnar export.\n";
+        return;
+    }
+
+    ColumnBatch batch(*formDef);
+    outFile.write(kColumnarMagic, sizeof(kColumnarMagic) - 1);
+    writeText(outFile, formDef->name);
+    writeU32(outFile, (uint32_t)batch.getColumns().size());
+    for (const auto& column : batch.getColumns()) {
+        outFile.put((char)column.encoding);
+        writeText(outFile, column.name);
+    }
+
+    EntryView entry;
+    int64_t exportedRows = 0;
+    while (entries.nextView(entry)) {
+        ++exportedRows;
+        batch.append(entry);
+        if (batch.rowCount() == ColumnBatch::kDefaultRowsPerBatch) {
+            writeBatch(outFile, batch);
+            batch.clear();
+        }
+    }
+    if (batch.rowCount() > 0) {
+        writeBatch(outFile, batch);
+    }
+    writeU32(outFile, 0); // End of batches
+
+    if (!output.close()) {
+        std::cerr << "Error: Could not write file " << output.getPath() << " for columnar export.\n";
+        return;
+    }
+    recordCounter("export.rows", exportedRows);
+    std::cout << "Entries saved to " << output.getPath() << " as columnar binary successfully.\n";
+}
@@ -0,0 +1,32 @@
+#ifndef SAVE_AS_COLUMNAR_H
+#define SAVE_AS_COLUMNAR_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+// Forward declarations to avoid circular dependencies
+struct FormDefinition;
+struct Entry;
+class EntrySource;
+
+// Self-describing columnar binary export. All integers are little-endian.
+//
+//   header:    "TODOCOL1", u32 form name length, form name bytes, u32 column count,
+//              then per column: u8 encoding (ColumnBatch::Encoding), u32 name length, name bytes
+//   batches:   u32 row count (0 ends the file), then per column:
+//              validity bitmap of (rows + 7) / 8 bytes, least significant bit first, then
+//                Int32/Float32:    rows * 4 bytes
+//                Float64/Timestamp: rows * 8 bytes (timestamps as int64 epoch milliseconds)
+//                Utf8:             (rows + 1) * u32 offsets, then offsets[rows] bytes of text
+//                Dictionary:       u32 count of new dictionary entries, each a u32 length and
+//                                  bytes (appended to the entries of earlier batches), then
+//                                  rows * u32 codes
+//
+// Column 0 is the entry key; null values hold zero in the value arrays.
+void saveAsColumnar(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries);
+
+// Streaming variant: rows are pulled from the source one at a time and written in batches
+void saveAsColumnar(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries);
+
+#endif // SAVE_AS_COLUMNAR_H
@@ -1,10 +1,15 @@
 #include "SaveAsJSON.h"
 #include "FormDefinition.h" // For FormDefinition struct
 #include "Entry.h"          // For Entry struct
+#include "EntryReader.h"    // For EntrySource
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "BlockCompression.h" // For OutputFile
 #include <fstream>
 #include <iostream>
 #include <sstream> // For stringstream
 #include <iomanip> // For std::setw, std::setfill
+#include <type_traits> // For std::is_same_v
+#include <cstdio> // For std::snprintf
 
 // Helper to escape string for JSON
 std::string escapeJsonString(const std::string& s) {
@@ -30,15 +35,63 @@ std::string escapeJsonString(const std::string& s) {
     return oss.str();
 }
 
+void writeJsonString(std::ostream& out, std::string_view s) {
+    out << '"';
+    size_t start = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c != '"' && c != '\\' && !iscntrl(static_cast<unsigned char>(c))) {
+            continue;
+        }
+        out << s.substr(start, i - start); // Copy the run of plain characters in one write
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\b': out << "\\b"; break;
+            case '\f': out << "\\f"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default: {
+                char code[7];
+                std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+                out << code;
+                break;
+            }
+        }
+        start = i + 1;
+    }
+    out << s.substr(start) << '"';
+}
+
+void writeJsonValue(std::ostream& out, const FieldValue& value) {
+    visitFieldValue(value, [&out](const auto& typed) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, std::string>) {
+            out << "\"" << escapeJsonString(typed) << "\"";
+        } else if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, Timestamp>) {
+            out << "\"" << formatTimestamp(typed) << "\"";
+        } else {
+            out << typed;
+        }
+    });
+}
+
 void saveAsJSON(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries) {
+    VectorEntrySource source(entries);
+    saveAsJSON(filename, formDef, source);
+}
+
+void saveAsJSON(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries) {
+    TRACE_SCOPE("saveAsJSON");
     if (!formDef) {
         std::cerr << "Error: No form definition provided for JSON export.\n";
         return;
     }
 
-    std::ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for JSON export.\n";
+    OutputFile output(filename); // Written as <filename>.lz4 when compression is enabled
+    std::ostream& outFile = output.stream();
+    if (!output.isOpen()) {
+        std::cerr << "Error: Could not open file " << output.getPath() << " for JSON export.\n";
         return;
     }
 
@@ -78,26 +131,33 @@ void saveAsJSON(const std::string& filename, const std::shared_ptr<FormDefinitio
     outFile << "  ],\n";
 
     outFile << "  \"entries\": [\n";
-    for (size_t i = 0; i < entries.size(); ++i) {
-        const auto& entry = entries[i];
+    EntryView entry;
+    bool firstEntry = true;
+    int64_t exportedRows = 0;
+    while (entries.nextView(entry)) {
+        ++exportedRows;
+        if (!firstEntry) {
+            outFile << ",\n";
+        }
+        firstEntry = false;
         outFile << "    {\n";
         outFile << "      \"key\": " << entry.key << ",\n";
         outFile << "      \"data\": {\n";
         size_t k = 0;
-        for (const auto& pair : entry.data) {
-            outFile << "        \"" << escapeJsonString(pair.first) << "\": ";
-            if (pair.second.type() == typeid(std::string)) {
-                outFile << "\"" << escapeJsonString(std::any_cast<std::string>(pair.second)) << "\"";
-            } else if (pair.second.type() == typeid(int)) {
-                outFile << std::any_cast<int>(pair.second);
-            } else if (pair.second.type() == typeid(float)) {
-                outFile << std::any_cast<float>(pair.second);
-            } else if (pair.second.type() == typeid(double)) {
-                outFile << std::any_cast<double>(pair.second);
-            } else {
-                outFile << "null"; // Handle unknown types
-            }
-            if (k < entry.data.size() - 1) {
+        for (const auto& pair : entry.fields) {
+            outFile << "        ";
+            writeJsonString(outFile, pair.first);
+            outFile << ": ";
+            visitFieldValueView(pair.second, [&outFile](const auto& typed) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, std::string_view>) {
+                    writeJsonString(outFile, typed);
+                } else if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, Timestamp>) {
+                    outFile << "\"" << formatTimestamp(typed) << "\"";
+                } else {
+                    outFile << typed;
+                }
+            });
+            if (k < entry.fields.size() - 1) {
                 outFile << ",\n";
             } else {
                 outFile << "\n";
@@ -106,15 +166,17 @@ void saveAsJSON(const std::string& filename, const std::shared_ptr<FormDefinitio
         }
         outFile << "      }\n";
         outFile << "    }";
-        if (i < entries.size() - 1) {
-            outFile << ",\n";
-        } else {
-            outFile << "\n";
-        }
+    }
+    if (!firstEntry) {
+        outFile << "\n";
     }
     outFile << "  ]\n";
     outFile << "}\n";
 
-    outFile.close();
-    std::cout << "Entries saved to " << filename << " as JSON successfully.\n";
+    if (!output.close()) {
+        std::cerr << "Error: Could not write file " << output.getPath() << " for JSON export.\n";
+        return;
+    }
+    recordCounter("export.rows", exportedRows);
+    std::cout << "Entries saved to " << output.getPath() << " as JSON successfully.\n";
 }
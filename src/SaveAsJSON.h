@@ -4,13 +4,28 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <any>
+#include <string_view>
+#include <iosfwd> // For std::ostream
+#include "FieldValue.h" // For FieldValue
 #include <memory>
 
 // Forward declarations to avoid circular dependencies
 struct FormDefinition;
 struct Entry;
+class EntrySource;
+
+// Escapes a string for embedding between JSON double quotes
+std::string escapeJsonString(const std::string& s);
+
+// Writes 's' escaped and between double quotes, without building a copy
+void writeJsonString(std::ostream& out, std::string_view s);
+
+// Writes a value as a JSON string or number
+void writeJsonValue(std::ostream& out, const FieldValue& value);
 
 void saveAsJSON(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries);
 
+// Streaming variant: rows are pulled from the source one at a time
+void saveAsJSON(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries);
+
 #endif // SAVE_AS_JSON_H
@@ -1,32 +1,51 @@
 #include "SaveAsSQL.h"
 #include "FormDefinition.h" // For FormDefinition struct
 #include "Entry.h"          // For Entry struct
+#include "EntryReader.h"    // For EntrySource
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include "BlockCompression.h" // For OutputFile
 #include <fstream>
 #include <iostream>
 #include <sstream> // For stringstream
 #include <algorithm> // For std::replace, std::remove_if
+#include <type_traits> // For std::is_same_v
+#include <string_view>
 
-// Helper to escape string for SQL
-std::string escapeSQLString(const std::string& s) {
-    std::string escaped = s;
-    // Replace single quotes with two single quotes
-    size_t pos = escaped.find('\'');
-    while (pos != std::string::npos) {
-        escaped.replace(pos, 1, "''");
-        pos = escaped.find('\'', pos + 2);
+namespace {
+
+// Writes 'value' as a quoted SQL literal, doubling single quotes, without building an escaped copy
+void writeSQLString(std::ostream& out, std::string_view value) {
+    out << '\'';
+    for (size_t start = 0; start < value.size();) {
+        size_t quote = value.find('\'', start);
+        if (quote == std::string_view::npos) {
+            out << value.substr(start);
+            break;
+        }
+        out << value.substr(start, quote + 1 - start) << '\'';
+        start = quote + 1;
     }
-    return escaped;
+    out << '\'';
 }
 
+} // namespace
+
 void saveAsSQL(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries) {
+    VectorEntrySource source(entries);
+    saveAsSQL(filename, formDef, source);
+}
+
+void saveAsSQL(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries) {
+    TRACE_SCOPE("saveAsSQL");
     if (!formDef) {
         std::cerr << "Error: No form definition provided for SQL export.\n";
         return;
     }
 
-    std::ofstream outFile(filename);
-    if (!outFile.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << " for SQL export.\n";
+    OutputFile output(filename); // Written as <filename>.lz4 when compression is enabled
+    std::ostream& outFile = output.stream();
+    if (!output.isOpen()) {
+        std::cerr << "Error: Could not open file " << output.getPath() << " for SQL export.\n";
         return;
     }
 
@@ -53,16 +72,21 @@ void saveAsSQL(const std::string& filename, const std::shared_ptr<FormDefinition
             } else if (numField->numberType == "float" || numField->numberType == "double") {
                 outFile << "REAL";
             }
+        } else if (field->type == "timestamp") {
+            outFile << "TIMESTAMP";
         }
     }
     outFile << "\n);\n\n";
 
     // Insert statements
-    for (const auto& entry : entries) {
+    EntryView entry;
+    int64_t exportedRows = 0;
+    while (entries.nextView(entry)) {
+        ++exportedRows;
         outFile << "INSERT INTO " << tableName << " (";
         bool firstField = true;
         for (const auto& field : formDef->fields) {
-            if (entry.data.count(field->name)) { // Only include fields that have data
+            if (entry.find(field->name)) { // Only include fields that have data
                 if (!firstField) outFile << ", ";
                 outFile << field->name;
                 firstField = false;
@@ -71,25 +95,27 @@ void saveAsSQL(const std::string& filename, const std::shared_ptr<FormDefinition
         outFile << ") VALUES (";
         firstField = true;
         for (const auto& field : formDef->fields) {
-            if (entry.data.count(field->name)) { // Only include fields that have data
+            if (const FieldValueView* value = entry.find(field->name)) { // Only include fields that have data
                 if (!firstField) outFile << ", ";
-                if (field->type == "string" || field->type == "select") {
-                    outFile << "'" << escapeSQLString(std::any_cast<std::string>(entry.data.at(field->name))) << "'";
-                } else if (field->type == "int") {
-                    outFile << std::any_cast<int>(entry.data.at(field->name));
-                } else if (field->type == "float") {
-                    outFile << std::any_cast<float>(entry.data.at(field->name));
-                } else if (field->type == "double") {
-                    outFile << std::any_cast<double>(entry.data.at(field->name));
-                } else {
-                    outFile << "NULL"; // Handle unknown types or missing data
-                }
+                visitFieldValueView(*value, [&outFile](const auto& typed) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, std::string_view>) {
+                        writeSQLString(outFile, typed);
+                    } else if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, Timestamp>) {
+                        outFile << "'" << formatTimestamp(typed) << "'";
+                    } else {
+                        outFile << typed;
+                    }
+                });
                 firstField = false;
             }
         }
         outFile << ");\n";
     }
 
-    outFile.close();
-    std::cout << "Entries saved to " << filename << " as SQL successfully.\n";
+    if (!output.close()) {
+        std::cerr << "Error: Could not write file " << output.getPath() << " for SQL export.\n";
+        return;
+    }
+    recordCounter("export.rows", exportedRows);
+    std::cout << "Entries saved to " << output.getPath() << " as SQL successfully.\n";
 }
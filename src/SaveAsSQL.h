@@ -4,13 +4,16 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <any>
 #include <memory>
 
 // Forward declarations to avoid circular dependencies
 struct FormDefinition;
 struct Entry;
+class EntrySource;
 
 void saveAsSQL(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, const std::vector<Entry>& entries);
 
+// Streaming variant: rows are pulled from the source one at a time
+void saveAsSQL(const std::string& filename, const std::shared_ptr<FormDefinition>& formDef, EntrySource& entries);
+
 #endif // SAVE_AS_SQL_H
@@ -0,0 +1,94 @@
+#include "SchemaMigration.h"
+#include "FormDefinition.h" // For FormDefinition struct
+#include "Entry.h" // For Entry struct
+#include <type_traits> // For std::is_arithmetic_v, std::is_same_v
+
+std::atomic<bool> backgroundSchemaRewriteEnabled(false);
+
+void setBackgroundSchemaRewrite(bool enabled) {
+    backgroundSchemaRewriteEnabled = enabled;
+}
+
+namespace {
+
+// Converts 'value' to 'kind'; returns false if it has no sensible value of that kind
+bool convertFieldValue(const FieldValue& value, FieldKind kind, FieldValue& out) {
+    if (kind == FieldKind::String) {
+        out = formatFieldValue(value);
+        return true;
+    }
+    if (const std::string* text = std::get_if<std::string>(&value)) {
+        return parseFieldValue(kind, *text, out);
+    }
+    // Number to number: cast directly rather than through %g text, which drops digits
+    double number = visitFieldValue(value, [](const auto& typed) -> double {
+        if constexpr (std::is_arithmetic_v<std::decay_t<decltype(typed)>>) {
+            return static_cast<double>(typed);
+        } else if constexpr (std::is_same_v<std::decay_t<decltype(typed)>, Timestamp>) {
+            return static_cast<double>(typed.millis);
+        } else {
+            return 0.0;
+        }
+    });
+    switch (kind) {
+        case FieldKind::Int:
+            out = static_cast<int>(number);
+            return true;
+        case FieldKind::Float:
+            out = static_cast<float>(number);
+            return true;
+        case FieldKind::Double:
+            out = number;
+            return true;
+        case FieldKind::Timestamp:
+            out = Timestamp{static_cast<int64_t>(number)}; // Numbers are taken as epoch milliseconds
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+uint64_t schemaHashOf(const FormDefinition& formDef) {
+    // FNV-1a over "name:kind;" for each field
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const std::string& text) {
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+    };
+    for (const auto& field : formDef.fields) {
+        mix(field->name + ":" + fieldKindName(fieldKindFor(*field)) + ";");
+    }
+    return hash;
+}
+
+SchemaMigration::SchemaMigration(const FormDefinition& formDef) : targetHash(schemaHashOf(formDef)) {
+    for (const auto& field : formDef.fields) {
+        targetKinds[field->name] = fieldKindFor(*field);
+    }
+}
+
+bool SchemaMigration::migrateEntry(Entry& entry) const {
+    bool changed = false;
+    for (auto it = entry.data.begin(); it != entry.data.end();) {
+        auto target = targetKinds.find(it->first);
+        if (target == targetKinds.end()) {
+            it = entry.data.erase(it); // Field was removed from the form
+            changed = true;
+            continue;
+        }
+        if (fieldKindOf(it->second) != target->second) {
+            FieldValue converted;
+            changed = true;
+            if (!convertFieldValue(it->second, target->second, converted)) {
+                it = entry.data.erase(it); // Shows as N/A rather than a value of the wrong kind
+                continue;
+            }
+            it->second = std::move(converted);
+        }
+        ++it;
+    }
+    return changed;
+}
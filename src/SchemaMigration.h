@@ -0,0 +1,44 @@
+#ifndef SCHEMA_MIGRATION_H
+#define SCHEMA_MIGRATION_H
+
+#include <string>
+#include <map>
+#include <atomic>
+#include <cstdint>
+#include "FieldValue.h" // For FieldKind
+
+struct FormDefinition;
+struct Entry;
+
+// Hash of a form's storage schema: the field names, in order, and the kind each is stored as.
+// Select options do not affect stored rows and are left out.
+uint64_t schemaHashOf(const FormDefinition& formDef);
+
+// Brings rows written under an older version of a form to its current fields: values of
+// fields that no longer exist are dropped, values whose kind changed are converted (numbers
+// are cast, other conversions go through the display text) or dropped if they do not parse.
+// Fields added to the form are simply absent from old rows and show as N/A.
+// Conversion is keyed on the target schema only, so it is idempotent and works from any
+// older schema, as entries files store each value's kind next to it.
+class SchemaMigration {
+private:
+    std::map<std::string, FieldKind> targetKinds;
+    uint64_t targetHash;
+
+public:
+    explicit SchemaMigration(const FormDefinition& formDef);
+
+    // Rewrites one row in place; returns true if anything changed
+    bool migrateEntry(Entry& entry) const;
+
+    uint64_t getTargetHash() const { return targetHash; }
+};
+
+// When enabled, a form opened with a schema change is also rewritten in the background so
+// later loads skip migration; otherwise rows are migrated lazily and partitions on disk are
+// only converted as they are rewritten. Enable with "--migrate-in-background".
+extern std::atomic<bool> backgroundSchemaRewriteEnabled;
+
+void setBackgroundSchemaRewrite(bool enabled);
+
+#endif // SCHEMA_MIGRATION_H
@@ -1,5 +1,6 @@
 #include "SelectAndUseForm.h"
 #include "FormDefinition.h" // To use FormDefinition and currentSelectedForm
+#include "FormCatalog.h"    // For formCatalog
 #include <iostream>
 #include <string>
 #include <vector>
@@ -17,14 +18,12 @@ void selectAndUseForm() {
         return;
     }
 
-    std::vector<std::string> formFiles;
+    // The catalog only rescans what changed since the last menu visit
+    std::vector<std::string> formFiles = formCatalog.listForms();
     std::cout << "Available Forms:\n";
     int i = 1;
-    for (const auto& entry : fs::directory_iterator(formsDir)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".form") {
-            formFiles.push_back(entry.path().filename().string());
-            std::cout << i++ << ". " << entry.path().filename().string() << "\n";
-        }
+    for (const auto& formFile : formFiles) {
+        std::cout << i++ << ". " << formFile << "\n";
     }
 
     if (formFiles.empty()) {
@@ -37,12 +36,12 @@ void selectAndUseForm() {
     std::cin >> choice;
 
     if (choice > 0 && choice <= formFiles.size()) {
-        std::string formPath = formsDir + formFiles[choice - 1];
-        currentSelectedForm = FormDefinition::loadFromFile(formPath);
-        if (currentSelectedForm) {
-            std::cout << "Form '" << currentSelectedForm->name << "' selected and loaded successfully.\n";
+        auto selectedForm = formCatalog.getForm(formFiles[choice - 1]);
+        std::atomic_store(&currentSelectedForm, selectedForm);
+        if (selectedForm) {
+            std::cout << "Form '" << selectedForm->name << "' selected and loaded successfully.\n";
             std::cout << "Form fields:\n";
-            for (const auto& field : currentSelectedForm->fields) {
+            for (const auto& field : selectedForm->fields) {
                 std::cout << "- " << field->name << " (" << field->type << ")\n";
                 if (field->type == "select") {
                     auto selectField = std::static_pointer_cast<SelectField>(field);
@@ -0,0 +1,835 @@
+#include "ServiceMode.h"
+#include "FormDefinition.h" // For FormDefinition struct
+#include "FormCatalog.h"    // For formCatalog
+#include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For entryManagerPool
+#include "EntryReader.h"    // For SnapshotEntrySource
+#include "SortedPageSelector.h" // For SortedPageSelector
+#include "EntryFilter.h"     // For EntryFilter
+#include "FormValidator.h"  // For FormValidator
+#include "JsonValue.h"      // For parseJson
+#include "Instrumentation.h" // For setInstrumentationEnabled
+#include "BlockCompression.h" // For isCompressionEnabled
+#include "SaveAsCSV.h"
+#include "SaveAsJSON.h"     // For saveAsJSON, escapeJsonString, writeJsonValue
+#include "SaveAsSQL.h"
+#include "SaveAsColumnar.h"
+#include "SaveAsArrow.h"
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <atomic>
+#include <algorithm> // For std::find
+#include <thread> // For std::thread
+#include <mutex> // For std::mutex
+#include <memory> // For std::unique_ptr
+#include <filesystem> // For std::filesystem::create_directories
+#include <cmath> // For std::floor, std::isfinite, std::fabs
+#include <climits> // For INT_MIN, INT_MAX
+#include <cfloat> // For FLT_MAX
+#include <iomanip> // For std::setprecision
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#endif
+
+const char* const kDefaultServiceSocketPath = "Forms/todoapp.sock";
+
+namespace {
+
+const size_t kMaxRequestBytes = 16 * 1024 * 1024; // Guards against clients that never send a newline
+const size_t kDefaultQueryLimit = 100;
+
+std::atomic<bool> stopRequested(false);
+
+// Exports run on their own thread so a large form never stalls the poll loop, and only
+// write plain file names inside this directory
+const char* const kExportDirectory = "Forms/exports";
+
+// One "export" request; "export_status" polls it and waitForServiceExports() joins it
+struct ExportJob {
+    std::thread worker;
+    std::atomic<bool> done{false};
+    std::string path;
+};
+
+std::mutex exportJobsMutex;
+std::map<int, std::unique_ptr<ExportJob>> exportJobs; // Guarded by exportJobsMutex
+int nextExportJob = 1; // Guarded by exportJobsMutex
+
+// A client supplied export name may not leave kExportDirectory
+bool isPlainFileName(const std::string& name) {
+    return !name.empty() && name[0] != '.' && name.find('/') == std::string::npos && name.find('\\') == std::string::npos;
+}
+
+void writeExport(const std::string& format, const std::string& path, const std::shared_ptr<FormDefinition>& formDef, EntrySnapshotPtr snapshot) {
+    // Exports read a snapshot of the resident entries, so writers are never blocked
+    SnapshotEntrySource source(std::move(snapshot));
+    if (format == "csv") {
+        saveAsCSV(path, formDef, source);
+    } else if (format == "json") {
+        saveAsJSON(path, formDef, source);
+    } else if (format == "sql") {
+        saveAsSQL(path, formDef, source);
+    } else if (format == "cols") {
+        saveAsColumnar(path, formDef, source);
+    } else {
+        saveAsArrow(path, formDef, source);
+    }
+}
+
+// True for a whole JSON number in [min, maxExclusive); only those may be cast to an integer
+// type, as converting anything else (fractions, infinities, out of range values) is undefined
+bool isIntegralInRange(double number, double min, double maxExclusive) {
+    return std::isfinite(number) && std::floor(number) == number && number >= min && number < maxExclusive;
+}
+
+const double kIntMin = (double)INT_MIN;
+const double kIntEnd = (double)INT_MAX + 1; // Exclusive bound, exact as a double
+const double kInt64Min = -9223372036854775808.0;
+const double kInt64End = 9223372036854775808.0;
+
+// Accumulates one response object: {"id":...,"ok":...,<members>}
+class ResponseWriter {
+private:
+    std::ostringstream out;
+
+public:
+    ResponseWriter(const JsonValue* id, bool ok) {
+        out << "{\"id\":";
+        if (id && id->isString()) {
+            out << "\"" << escapeJsonString(id->string) << "\"";
+        } else if (id && id->isNumber()) {
+            // Echoed exactly, so clients can match replies: integers in full, anything else round-trippable
+            if (id->isInteger && isIntegralInRange(id->number, kInt64Min, kInt64End)) {
+                out << static_cast<int64_t>(id->number);
+            } else {
+                out << std::setprecision(17) << id->number;
+            }
+        } else {
+            out << "null";
+        }
+        out << ",\"ok\":" << (ok ? "true" : "false");
+    }
+
+    std::ostream& member(const std::string& name) {
+        out << ",\"" << name << "\":";
+        return out;
+    }
+
+    std::string finish() {
+        out << "}";
+        return out.str();
+    }
+};
+
+std::string errorResponse(const JsonValue* id, const std::string& message) {
+    ResponseWriter response(id, false);
+    response.member("error") << "\"" << escapeJsonString(message) << "\"";
+    return response.finish();
+}
+
+void writeEntryJson(std::ostream& out, const Entry& entry) {
+    out << "{\"key\":" << entry.key << ",\"data\":{";
+    bool first = true;
+    for (const auto& pair : entry.data) {
+        if (!first) {
+            out << ",";
+        }
+        first = false;
+        out << "\"" << escapeJsonString(pair.first) << "\":";
+        writeJsonValue(out, pair.second);
+    }
+    out << "}}";
+}
+
+// Converts a JSON "data" object into typed field values according to the form schema
+bool convertData(const FormDefinition& formDef, const JsonValue& data, std::map<std::string, FieldValue>& values, std::string& error) {
+    if (!data.isObject()) {
+        error = "'data' must be an object";
+        return false;
+    }
+
+    for (const auto& member : data.object) {
+        std::shared_ptr<FormField> field;
+        for (const auto& candidate : formDef.fields) {
+            if (candidate->name == member.first) {
+                field = candidate;
+                break;
+            }
+        }
+        if (!field) {
+            error = "Unknown field '" + member.first + "'";
+            return false;
+        }
+
+        const JsonValue& value = member.second;
+        if (field->type == "string") {
+            if (!value.isString()) {
+                error = "Field '" + field->name + "' expects a string";
+                return false;
+            }
+            values[field->name] = value.string;
+        } else if (field->type == "number") {
+            if (!value.isNumber()) {
+                error = "Field '" + field->name + "' expects a number";
+                return false;
+            }
+            auto numField = std::static_pointer_cast<NumberField>(field);
+            if (numField->numberType == "int") {
+                if (!isIntegralInRange(value.number, kIntMin, kIntEnd)) {
+                    error = "Field '" + field->name + "' expects an int";
+                    return false;
+                }
+                values[field->name] = static_cast<int>(value.number);
+            } else if (numField->numberType == "float") {
+                if (!std::isfinite(value.number) || std::fabs(value.number) > FLT_MAX) {
+                    error = "Field '" + field->name + "' expects a float";
+                    return false;
+                }
+                values[field->name] = static_cast<float>(value.number);
+            } else {
+                values[field->name] = value.number;
+            }
+        } else if (field->type == "timestamp") {
+            // ISO-8601 text, or a number of epoch milliseconds
+            Timestamp time;
+            if (value.isNumber() && isIntegralInRange(value.number, kInt64Min, kInt64End)) {
+                time.millis = static_cast<int64_t>(value.number);
+            } else if (!value.isString() || !parseTimestamp(value.string, time)) {
+                error = "Field '" + field->name + "' expects an ISO-8601 timestamp or epoch milliseconds";
+                return false;
+            }
+            values[field->name] = time;
+        } else if (field->type == "select") {
+            auto selectField = std::static_pointer_cast<SelectField>(field);
+            if (value.isNumber() && isIntegralInRange(value.number, kIntMin, kIntEnd) && selectField->options.count(static_cast<int>(value.number))) {
+                values[field->name] = selectField->options.at(static_cast<int>(value.number));
+                continue;
+            }
+            bool matched = false;
+            if (value.isString()) {
+                for (const auto& option : selectField->options) {
+                    if (option.second == value.string) {
+                        matched = true;
+                        break;
+                    }
+                }
+            }
+            if (!matched) {
+                error = "Field '" + field->name + "' expects one of its select options";
+                return false;
+            }
+            values[field->name] = value.string;
+        }
+    }
+    return true;
+}
+
+bool readInt(const JsonValue& request, const char* name, int& out) {
+    const JsonValue* value = request.get(name);
+    if (!value || !value->isNumber() || !isIntegralInRange(value->number, kIntMin, kIntEnd)) {
+        return false;
+    }
+    out = static_cast<int>(value->number);
+    return true;
+}
+
+} // namespace
+
+void waitForServiceExports() {
+    std::map<int, std::unique_ptr<ExportJob>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(exportJobsMutex);
+        jobs.swap(exportJobs);
+    }
+    for (auto& pair : jobs) {
+        pair.second->worker.join();
+    }
+}
+
+std::string handleServiceRequest(const std::string& requestLine, bool& shutdownRequested) {
+    JsonValue request;
+    std::string error;
+    if (!parseJson(requestLine, request, error)) {
+        return errorResponse(nullptr, "Malformed request: " + error);
+    }
+    if (!request.isObject()) {
+        return errorResponse(nullptr, "Request must be a JSON object");
+    }
+
+    const JsonValue* id = request.get("id");
+    const JsonValue* op = request.get("op");
+    if (!op || !op->isString()) {
+        return errorResponse(id, "Missing 'op'");
+    }
+
+    if (op->string == "ping") {
+        return ResponseWriter(id, true).finish();
+    }
+    if (op->string == "shutdown") {
+        shutdownRequested = true;
+        return ResponseWriter(id, true).finish();
+    }
+    if (op->string == "trace") {
+        // {"op":"trace","action":"start"|"stop"|"summary"} toggles instrumentation at runtime
+        const JsonValue* action = request.get("action");
+        std::string actionName = action && action->isString() ? action->string : "summary";
+        if (actionName == "start" || actionName == "stop") {
+            setInstrumentationEnabled(actionName == "start");
+        } else if (actionName != "summary") {
+            return errorResponse(id, "Unknown trace action '" + actionName + "'");
+        }
+        ResponseWriter response(id, true);
+        response.member("enabled") << (isInstrumentationEnabled() ? "true" : "false");
+        response.member("summary") << "\"" << escapeJsonString(instrumentationSummary()) << "\"";
+        return response.finish();
+    }
+    if (op->string == "export_status") {
+        // {"op":"export_status","job":N} -> {"done":bool,"path":...}; a finished job is forgotten once reported
+        int jobNumber = 0;
+        if (!readInt(request, "job", jobNumber)) {
+            return errorResponse(id, "Missing or invalid 'job'");
+        }
+        std::unique_ptr<ExportJob> finished;
+        ResponseWriter response(id, true);
+        {
+            std::lock_guard<std::mutex> lock(exportJobsMutex);
+            auto it = exportJobs.find(jobNumber);
+            if (it == exportJobs.end()) {
+                return errorResponse(id, "Unknown export job " + std::to_string(jobNumber));
+            }
+            bool done = it->second->done;
+            response.member("done") << (done ? "true" : "false");
+            response.member("path") << "\"" << escapeJsonString(it->second->path) << "\"";
+            if (done) {
+                finished = std::move(it->second);
+                exportJobs.erase(it);
+            }
+        }
+        if (finished) {
+            finished->worker.join(); // Already past its last statement
+        }
+        return response.finish();
+    }
+    if (op->string == "list_forms") {
+        ResponseWriter response(id, true);
+        std::ostream& out = response.member("forms");
+        out << "[";
+        bool first = true;
+        for (const auto& fileName : formCatalog.listForms()) {
+            out << (first ? "" : ",") << "\"" << escapeJsonString(fileName.substr(0, fileName.length() - 5)) << "\"";
+            first = false;
+        }
+        out << "]";
+        return response.finish();
+    }
+
+    // Every other operation works on one form, kept resident by the catalog and the pool
+    const JsonValue* formName = request.get("form");
+    if (!formName || !formName->isString()) {
+        return errorResponse(id, "Missing 'form'");
+    }
+    auto formDef = formCatalog.getForm(formName->string + ".form");
+    if (!formDef) {
+        return errorResponse(id, "Unknown form '" + formName->string + "'");
+    }
+    auto manager = entryManagerPool.acquire(formDef->name, formDef);
+
+    if (op->string == "add") {
+        std::map<std::string, FieldValue> values;
+        const JsonValue* data = request.get("data");
+        if (!data || !convertData(*formDef, *data, values, error)) {
+            return errorResponse(id, data ? error : "Missing 'data'");
+        }
+        if (formDef->validator && !formDef->validator->validateRow(values, error)) {
+            return errorResponse(id, error);
+        }
+        bool duplicate = false;
+        int key = manager->insertEntry(values, &duplicate);
+        if (duplicate && manager->getDedupSettings().mode == DedupSettings::Mode::Reject) {
+            return errorResponse(id, "Duplicate of entry with key " + std::to_string(key));
+        }
+        ResponseWriter response(id, true);
+        response.member("key") << key;
+        if (duplicate) {
+            response.member("duplicate") << "true"; // Merged into the existing row
+        }
+        return response.finish();
+    }
+
+    if (op->string == "import") {
+        // {"op":"import","rows":[{...},...]} adds all rows in one persist, or none if any row
+        // does not convert or breaks the form's validation rules
+        const JsonValue* rows = request.get("rows");
+        if (!rows || rows->type != JsonValue::Type::Array) {
+            return errorResponse(id, "Missing 'rows'");
+        }
+        std::vector<std::map<std::string, FieldValue>> converted(rows->array.size());
+        for (size_t i = 0; i < rows->array.size(); ++i) {
+            if (!convertData(*formDef, rows->array[i], converted[i], error)
+                || (formDef->validator && !formDef->validator->validateRow(converted[i], error))) {
+                return errorResponse(id, "Row " + std::to_string(i + 1) + ": " + error);
+            }
+        }
+        size_t duplicates = 0;
+        size_t added = manager->importEntries(converted, &duplicates);
+        ResponseWriter response(id, true);
+        response.member("added") << added;
+        response.member("duplicates") << duplicates;
+        return response.finish();
+    }
+
+    if (op->string == "dedup") {
+        // {"op":"dedup","mode":"reject"|"merge"|"off","fields":"a,b"} sets the uniqueness mode
+        // (optional), then removes the duplicates already stored
+        const JsonValue* mode = request.get("mode");
+        if (mode) {
+            const JsonValue* fields = request.get("fields");
+            DedupSettings settings;
+            if (!mode->isString() || !DedupSettings::parseSpec(mode->string + ":" + (fields && fields->isString() ? fields->string : ""), settings)) {
+                return errorResponse(id, "Unknown dedup mode");
+            }
+            if (!settings.checkFields(*formDef, error)) {
+                return errorResponse(id, error);
+            }
+            manager->setDedupSettings(settings);
+        }
+        size_t removed = manager->removeDuplicates();
+        ResponseWriter response(id, true);
+        response.member("removed") << removed;
+        return response.finish();
+    }
+
+    if (op->string == "edit") {
+        int key;
+        if (!readInt(request, "key", key)) {
+            return errorResponse(id, "Missing or invalid 'key'");
+        }
+        std::map<std::string, FieldValue> values;
+        const JsonValue* data = request.get("data");
+        if (!data || !convertData(*formDef, *data, values, error)) {
+            return errorResponse(id, data ? error : "Missing 'data'");
+        }
+        if (formDef->validator && !formDef->validator->validateChanges(values, error)) {
+            return errorResponse(id, error);
+        }
+        if (!manager->updateEntry(key, values)) {
+            return errorResponse(id, "Entry with key " + std::to_string(key) + " not found");
+        }
+        return ResponseWriter(id, true).finish();
+    }
+
+    if (op->string == "delete") {
+        int key;
+        if (!readInt(request, "key", key)) {
+            return errorResponse(id, "Missing or invalid 'key'");
+        }
+        if (!manager->removeEntry(key)) {
+            return errorResponse(id, "Entry with key " + std::to_string(key) + " not found");
+        }
+        return ResponseWriter(id, true).finish();
+    }
+
+    if (op->string == "delete_where" || op->string == "update_where") {
+        // Bulk operations: "where" is an EntryFilter, e.g. "10-20" or "status = done and qty > 3"
+        const JsonValue* where = request.get("where");
+        EntryFilter filter;
+        if (!where || !where->isString() || !EntryFilter::parse(*formDef, where->string, filter, error)) {
+            return errorResponse(id, where && where->isString() ? error : "Missing 'where'");
+        }
+        auto match = [&filter](const Entry& entry) { return filter.matches(entry); };
+        size_t count;
+        if (op->string == "delete_where") {
+            count = manager->removeEntries(match);
+        } else {
+            std::map<std::string, FieldValue> values;
+            const JsonValue* data = request.get("data");
+            if (!data || !convertData(*formDef, *data, values, error)) {
+                return errorResponse(id, data ? error : "Missing 'data'");
+            }
+            if (formDef->validator && !formDef->validator->validateChanges(values, error)) {
+                return errorResponse(id, error);
+            }
+            count = manager->updateEntries(match, values);
+        }
+        ResponseWriter response(id, true);
+        response.member("count") << count;
+        return response.finish();
+    }
+
+    if (op->string == "undo" || op->string == "redo") {
+        std::string label;
+        bool done = op->string == "undo" ? manager->undo(&label) : manager->redo(&label);
+        if (!done) {
+            return errorResponse(id, "Nothing to " + op->string);
+        }
+        ResponseWriter response(id, true);
+        response.member("operation") << "\"" << escapeJsonString(label) << "\"";
+        response.member("undo_depth") << manager->getUndoDepth();
+        response.member("redo_depth") << manager->getRedoDepth();
+        return response.finish();
+    }
+
+    if (op->string == "snapshot" || op->string == "restore") {
+        // {"op":"snapshot","name":"before-cleanup"} keeps the current entries under a name for
+        // this service's lifetime; {"op":"restore","name":...} switches back to them (undoable)
+        const JsonValue* name = request.get("name");
+        if (!name || !name->isString() || name->string.empty()) {
+            return errorResponse(id, "Missing 'name'");
+        }
+        if (op->string == "snapshot") {
+            manager->saveSnapshot(name->string);
+        } else if (!manager->restoreSnapshot(name->string)) {
+            return errorResponse(id, "No snapshot named '" + name->string + "'");
+        }
+        return ResponseWriter(id, true).finish();
+    }
+
+    if (op->string == "snapshots") {
+        ResponseWriter response(id, true);
+        std::ostream& out = response.member("snapshots");
+        out << "[";
+        bool first = true;
+        for (const auto& name : manager->listSnapshots()) {
+            out << (first ? "" : ",") << "\"" << escapeJsonString(name) << "\"";
+            first = false;
+        }
+        out << "]";
+        return response.finish();
+    }
+
+    if (op->string == "get") {
+        int key;
+        if (!readInt(request, "key", key)) {
+            return errorResponse(id, "Missing or invalid 'key'");
+        }
+        auto snapshot = manager->getEntries();
+        long index = snapshot->findIndexByKey(key);
+        if (index < 0) {
+            return errorResponse(id, "Entry with key " + std::to_string(key) + " not found");
+        }
+        ResponseWriter response(id, true);
+        writeEntryJson(response.member("entry"), (*snapshot)[index]);
+        return response.finish();
+    }
+
+    if (op->string == "count" || op->string == "query") {
+        auto snapshot = manager->getEntries();
+        // Optional "where" (an EntryFilter) restricts both; a time range on a timestamp field
+        // is looked up in the field's range index instead of scanning
+        const JsonValue* where = request.get("where");
+        std::vector<size_t> matches;
+        if (where) {
+            EntryFilter filter;
+            if (!where->isString() || !EntryFilter::parse(*formDef, where->string, filter, error)) {
+                return errorResponse(id, where->isString() ? error : "'where' must be a string");
+            }
+            matches = manager->findMatchingRows(snapshot, filter);
+        }
+        size_t total = where ? matches.size() : snapshot->size();
+        ResponseWriter response(id, true);
+        response.member("total") << total;
+        if (op->string == "query") {
+            int offset = 0;
+            int limit = (int)kDefaultQueryLimit;
+            readInt(request, "offset", offset);
+            readInt(request, "limit", limit);
+            size_t start = (size_t)std::max(offset, 0);
+            size_t end = std::min(total, start + (size_t)std::max(limit, 0));
+
+            // Optional "sort":"<field>" and "desc":true select just the requested window in sorted order
+            std::vector<size_t> rows;
+            const JsonValue* sortField = request.get("sort");
+            if (sortField && sortField->isString()) {
+                const JsonValue* desc = request.get("desc");
+                SortedPageSelector selector;
+                selector.setOrder(snapshot, sortField->string, desc && desc->type == JsonValue::Type::Bool && desc->boolean,
+                                  where ? &matches : nullptr);
+                selector.selectRange(start, end, rows);
+            } else {
+                for (size_t i = start; i < end; ++i) {
+                    rows.push_back(where ? matches[i] : i);
+                }
+            }
+
+            std::ostream& out = response.member("entries");
+            out << "[";
+            for (size_t i = 0; i < rows.size(); ++i) {
+                if (i > 0) {
+                    out << ",";
+                }
+                writeEntryJson(out, (*snapshot)[rows[i]]);
+            }
+            out << "]";
+        }
+        return response.finish();
+    }
+
+    if (op->string == "stats") {
+        FormStats stats = manager->computeStats();
+        ResponseWriter response(id, true);
+        response.member("entries") << stats.entryCount;
+        response.member("bytes") << stats.totalBytes;
+        response.member("overhead_bytes") << stats.entryOverheadBytes;
+        response.member("string_heap_bytes") << stats.stringHeapBytes;
+        response.member("file_bytes") << stats.fileBytes;
+        response.member("load_ms") << stats.loadMillis;
+        std::ostream& columns = response.member("columns");
+        columns << "[";
+        for (size_t i = 0; i < stats.columns.size(); ++i) {
+            const FormStats::ColumnStats& column = stats.columns[i];
+            columns << (i ? "," : "") << "{\"name\":\"" << escapeJsonString(column.name) << "\",\"type\":\"" << column.type
+                    << "\",\"values\":" << column.values << ",\"bytes\":" << column.bytes
+                    << ",\"string_heap_bytes\":" << column.stringHeapBytes << "}";
+        }
+        columns << "]";
+        std::ostream& indexes = response.member("indexes");
+        indexes << "{";
+        bool first = true;
+        for (const auto& pair : stats.indexBytes) {
+            indexes << (first ? "" : ",") << "\"" << escapeJsonString(pair.first) << "\":" << pair.second;
+            first = false;
+        }
+        indexes << "}";
+        return response.finish();
+    }
+
+    if (op->string == "export") {
+        // Responds at once with a job number; the file is complete once "export_status" reports it done
+        const JsonValue* format = request.get("format");
+        if (!format || !format->isString()) {
+            return errorResponse(id, "Missing 'format'");
+        }
+        static const char* const kFormats[] = {"csv", "json", "sql", "cols", "arrow"};
+        if (std::find(std::begin(kFormats), std::end(kFormats), format->string) == std::end(kFormats)) {
+            return errorResponse(id, "Unknown export format '" + format->string + "'");
+        }
+        const JsonValue* nameValue = request.get("path");
+        std::string name = nameValue && nameValue->isString()
+            ? nameValue->string
+            : formDef->name + "_entries." + format->string;
+        if (!isPlainFileName(name)) {
+            return errorResponse(id, "Export 'path' must be a file name without directories");
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(kExportDirectory, ec);
+        std::string path = std::string(kExportDirectory) + "/" + name;
+        std::string writtenPath = isCompressionEnabled() ? path + kCompressedFileSuffix : path; // The exporter appends the suffix
+
+        std::lock_guard<std::mutex> lock(exportJobsMutex);
+        for (const auto& pair : exportJobs) {
+            if (!pair.second->done && pair.second->path == writtenPath) {
+                return errorResponse(id, "An export to '" + name + "' is already running");
+            }
+        }
+        int jobNumber = nextExportJob++;
+        auto job = std::make_unique<ExportJob>();
+        job->path = writtenPath;
+        ExportJob* started = job.get();
+        job->worker = std::thread([started, formatName = format->string, path, formDef, snapshot = manager->getEntries()]() {
+            writeExport(formatName, path, formDef, snapshot);
+            started->done = true;
+        });
+        exportJobs[jobNumber] = std::move(job);
+
+        ResponseWriter response(id, true);
+        response.member("job") << jobNumber;
+        response.member("path") << "\"" << escapeJsonString(writtenPath) << "\"";
+        return response.finish();
+    }
+
+    return errorResponse(id, "Unknown op '" + op->string + "'");
+}
+
+#ifdef _WIN32
+
+int runService(const std::string& socketPath) {
+    std::cerr << "Error: Service mode requires Unix domain sockets and is not available on this platform.\n";
+    return 1;
+}
+
+#else
+
+namespace {
+
+struct ClientConnection {
+    std::string inbound;
+    std::string outbound;
+    bool readClosed = false;
+};
+
+void handleStopSignal(int) {
+    stopRequested = true;
+}
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+// Writes as much pending output as the socket accepts; returns false on a fatal error
+bool flushOutbound(int fd, ClientConnection& client) {
+    while (!client.outbound.empty()) {
+        ssize_t written = write(fd, client.outbound.data(), client.outbound.size());
+        if (written > 0) {
+            client.outbound.erase(0, written);
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads everything available and answers every complete request line in one batch
+bool serviceClient(int fd, ClientConnection& client, bool& shutdownRequested) {
+    char buffer[64 * 1024];
+    while (true) {
+        ssize_t length = read(fd, buffer, sizeof(buffer));
+        if (length > 0) {
+            client.inbound.append(buffer, length);
+            if (client.inbound.size() > kMaxRequestBytes && client.inbound.find('\n') == std::string::npos) {
+                return false;
+            }
+        } else if (length == 0) {
+            client.readClosed = true;
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    size_t lineStart = 0;
+    size_t newline;
+    while ((newline = client.inbound.find('\n', lineStart)) != std::string::npos) {
+        std::string line = client.inbound.substr(lineStart, newline - lineStart);
+        lineStart = newline + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        client.outbound += handleServiceRequest(line, shutdownRequested);
+        client.outbound += '\n';
+    }
+    client.inbound.erase(0, lineStart);
+    return flushOutbound(fd, client);
+}
+
+} // namespace
+
+int runService(const std::string& socketPath) {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path " << socketPath << " is too long.\n";
+        return 1;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "Error: Could not create service socket: " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    // Remove a stale socket left behind by a previous run, but never a regular file
+    struct stat st;
+    if (lstat(socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(socketPath.c_str());
+    }
+
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 64) != 0) {
+        std::cerr << "Error: Could not listen on " << socketPath << ": " << std::strerror(errno) << "\n";
+        close(listenFd);
+        return 1;
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    std::cout << "TodoApp service listening on " << socketPath << std::endl;
+
+    std::map<int, ClientConnection> clients;
+    std::vector<pollfd> pollFds;
+    bool shutdownRequested = false;
+
+    while (!stopRequested && !shutdownRequested) {
+        pollFds.clear();
+        pollFds.push_back({listenFd, POLLIN, 0});
+        for (const auto& pair : clients) {
+            short events = pair.second.readClosed ? 0 : POLLIN;
+            if (!pair.second.outbound.empty()) {
+                events |= POLLOUT;
+            }
+            pollFds.push_back({pair.first, events, 0});
+        }
+
+        if (poll(pollFds.data(), pollFds.size(), 500) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "Error: poll failed: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        if (pollFds[0].revents & POLLIN) {
+            int clientFd;
+            while ((clientFd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                if (setNonBlocking(clientFd)) {
+                    clients[clientFd] = ClientConnection();
+                } else {
+                    close(clientFd);
+                }
+            }
+        }
+
+        for (size_t i = 1; i < pollFds.size(); ++i) {
+            int fd = pollFds[i].fd;
+            ClientConnection& client = clients[fd];
+            bool healthy = true;
+
+            if (pollFds[i].revents & (POLLIN | POLLHUP)) {
+                healthy = serviceClient(fd, client, shutdownRequested);
+            } else if (pollFds[i].revents & POLLOUT) {
+                healthy = flushOutbound(fd, client);
+            }
+            if (pollFds[i].revents & POLLERR) {
+                healthy = false;
+            }
+
+            if (!healthy || (client.readClosed && client.outbound.empty())) {
+                close(fd);
+                clients.erase(fd);
+            }
+        }
+    }
+
+    // Deliver responses that are still queued (e.g. the reply to "shutdown") before closing
+    for (auto& pair : clients) {
+        fcntl(pair.first, F_SETFL, fcntl(pair.first, F_GETFL, 0) & ~O_NONBLOCK);
+        flushOutbound(pair.first, pair.second);
+        close(pair.first);
+    }
+    close(listenFd);
+    unlink(socketPath.c_str());
+    waitForServiceExports(); // Let running exports finish their files
+    std::cout << "TodoApp service stopped." << std::endl;
+    return 0;
+}
+
+#endif
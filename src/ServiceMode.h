@@ -0,0 +1,21 @@
+#ifndef SERVICE_MODE_H
+#define SERVICE_MODE_H
+
+#include <string>
+
+// Default socket path used by "TodoApp --serve" when none is given
+extern const char* const kDefaultServiceSocketPath;
+
+// Runs TodoApp as a long-lived daemon that keeps forms and EntryManagers resident and
+// answers newline-delimited JSON requests on a Unix domain socket. Clients may pipeline
+// any number of requests; responses come back in order, one JSON object per line.
+// Returns the process exit code.
+int runService(const std::string& socketPath);
+
+// Handles a single request line and returns the response line (without the trailing newline)
+std::string handleServiceRequest(const std::string& requestLine, bool& shutdownRequested);
+
+// Blocks until every export started by an "export" request has finished writing
+void waitForServiceExports();
+
+#endif // SERVICE_MODE_H
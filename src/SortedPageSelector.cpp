@@ -0,0 +1,108 @@
+#include "SortedPageSelector.h"
+#include "Entry.h" // For Entry
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include <algorithm> // For std::nth_element, std::partial_sort
+#include <type_traits> // For std::is_same_v
+
+void SortedPageSelector::setOrder(EntrySnapshotPtr newSnapshot, const std::string& newFieldName, bool newDescending,
+                                  const std::vector<size_t>* subset) {
+    bool rebuild = newSnapshot != snapshot || newFieldName != fieldName || subset || subsetKeys;
+    snapshot = std::move(newSnapshot);
+    fieldName = newFieldName;
+    descending = newDescending;
+    if (!rebuild) {
+        return; // Only the direction changed; the existing keys are reused
+    }
+
+    TRACE_SCOPE("SortedPageSelector::buildKeys");
+    keys.clear();
+    subsetKeys = subset != nullptr;
+    if (!snapshot) {
+        return;
+    }
+    size_t count = subset ? subset->size() : snapshot->size();
+    keys.reserve(count);
+    for (size_t n = 0; n < count; ++n) {
+        size_t i = subset ? (*subset)[n] : n;
+        const Entry& entry = (*snapshot)[i];
+        SortKey key{true, false, 0.0, nullptr, i};
+        auto value = entry.data.find(fieldName);
+        if (value != entry.data.end()) {
+            key.missing = false;
+            visitFieldValue(value->second, [&key](const auto& stored) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(stored)>, std::string>) {
+                    key.isText = true;
+                    key.text = &stored;
+                } else if constexpr (std::is_same_v<std::decay_t<decltype(stored)>, Timestamp>) {
+                    key.number = static_cast<double>(stored.millis);
+                } else {
+                    key.number = stored;
+                }
+            });
+        }
+        keys.push_back(key);
+    }
+}
+
+bool SortedPageSelector::less(const SortKey& a, const SortKey& b) const {
+    if (a.missing != b.missing) {
+        return b.missing;
+    }
+    if (!a.missing) {
+        if (a.isText != b.isText) {
+            return a.isText == descending; // Numbers before text when ascending
+        }
+        if (a.isText) {
+            int order = a.text->compare(*b.text);
+            if (order != 0) {
+                return descending ? order > 0 : order < 0;
+            }
+        } else if (a.number != b.number) {
+            return descending ? a.number > b.number : a.number < b.number;
+        }
+    }
+    return a.row < b.row;
+}
+
+void SortedPageSelector::selectRange(size_t start, size_t end, std::vector<size_t>& rows) {
+    TRACE_SCOPE("SortedPageSelector::selectRange");
+    end = std::min(end, keys.size());
+    if (start >= end) {
+        return;
+    }
+    auto comparator = [this](const SortKey& a, const SortKey& b) { return less(a, b); };
+    if (start > 0) {
+        std::nth_element(keys.begin(), keys.begin() + start, keys.end(), comparator);
+    }
+    std::partial_sort(keys.begin() + start, keys.begin() + end, keys.end(), comparator);
+    for (size_t i = start; i < end; ++i) {
+        rows.push_back(keys[i].row);
+    }
+}
+
+long SortedPageSelector::positionOfKey(int key) const {
+    if (!snapshot) {
+        return -1;
+    }
+    long index = snapshot->findIndexByKey(key);
+    if (index < 0) {
+        return -1;
+    }
+    const SortKey* target = nullptr;
+    for (const auto& candidate : keys) {
+        if (candidate.row == (size_t)index) {
+            target = &candidate;
+            break;
+        }
+    }
+    if (!target) {
+        return -1;
+    }
+    long position = 0; // Number of rows that sort before the target
+    for (const auto& candidate : keys) {
+        if (less(candidate, *target)) {
+            position++;
+        }
+    }
+    return position;
+}
@@ -0,0 +1,49 @@
+#ifndef SORTED_PAGE_SELECTOR_H
+#define SORTED_PAGE_SELECTOR_H
+
+#include <string>
+#include <vector>
+#include "EntrySnapshot.h" // For EntrySnapshotPtr
+
+// Produces one page of a snapshot in sorted order without sorting the whole snapshot.
+// Sort keys are extracted once per (snapshot, field); each page is then a
+// std::nth_element to the page start followed by a std::partial_sort of the page,
+// so a page turn costs O(n + k log k) for k rows per page instead of O(n log n).
+// Ties and missing values are ordered by row position, so pages never overlap.
+class SortedPageSelector {
+private:
+    struct SortKey {
+        bool missing; // Rows without a value sort last in either direction
+        bool isText;
+        double number;
+        const std::string* text; // Points into the snapshot, which 'snapshot' keeps alive
+        size_t row;
+    };
+
+    EntrySnapshotPtr snapshot;
+    std::string fieldName;
+    bool descending;
+    bool subsetKeys; // 'keys' cover only some rows
+    std::vector<SortKey> keys; // Partially ordered by earlier page selections
+
+    bool less(const SortKey& a, const SortKey& b) const;
+
+public:
+    SortedPageSelector() : descending(false), subsetKeys(false) {}
+
+    // Sorts 'snapshot' by 'fieldName'; keys are rebuilt only when the snapshot or field changes.
+    // With 'subset', only those row indices are ordered (keys are then always rebuilt).
+    void setOrder(EntrySnapshotPtr snapshot, const std::string& fieldName, bool descending,
+                  const std::vector<size_t>* subset = nullptr);
+
+    // Appends the row indices of sorted positions [start, end) to 'rows', in order
+    void selectRange(size_t start, size_t end, std::vector<size_t>& rows);
+
+    // Sorted position of the row with 'key', or -1 if there is no such row
+    long positionOfKey(int key) const;
+
+    const std::string& getFieldName() const { return fieldName; }
+    bool isDescending() const { return descending; }
+};
+
+#endif // SORTED_PAGE_SELECTOR_H
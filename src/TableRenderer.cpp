@@ -0,0 +1,217 @@
+#include "TableRenderer.h"
+#include "Entry.h" // For Entry
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include <iostream>
+#include <algorithm> // For std::max, std::min
+
+namespace {
+
+const size_t kMaxCachedRows = 4096; // Cells of roughly this many rows are kept between pages
+const size_t kKeyColumnMinWidth = 5;
+const size_t kColumnGap = 2;
+
+const char kEllipsis[] = "...";
+const size_t kEllipsisLength = sizeof(kEllipsis) - 1;
+
+// Cells wider than the column (a layout may size it below its widest value) are cut to fit
+// and end in "...", so they never push the following columns out of line
+void appendPadded(std::string& out, const std::string& text, size_t width) {
+    size_t length = text.size();
+    if (length <= width) {
+        out += text;
+    } else if (width <= kEllipsisLength) {
+        out.append(width, '.');
+        length = width;
+    } else {
+        size_t cut = width - kEllipsisLength;
+        while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) {
+            --cut; // Do not split a UTF-8 sequence
+        }
+        out.append(text, 0, cut);
+        out += kEllipsis;
+        length = cut + kEllipsisLength;
+    }
+    out.append(width + kColumnGap - length, ' ');
+}
+
+} // namespace
+
+TableRenderer::TableRenderer(std::shared_ptr<FormDefinition> formDef)
+    : formDef(std::move(formDef)), sorted(false), sortDescending(false) {}
+
+void TableRenderer::setSnapshot(EntrySnapshotPtr newSnapshot) {
+    if (snapshot == newSnapshot) {
+        return; // Snapshots are immutable, so the same pointer means the caches are still valid
+    }
+    snapshot = std::move(newSnapshot);
+    cellCache.clear();
+    widthCache.clear();
+    pageRowsCache.clear();
+    if (sorted) {
+        sorter.setOrder(snapshot, sortField, sortDescending);
+    }
+}
+
+int TableRenderer::totalPages(int entriesPerPage) const {
+    if (!snapshot || entriesPerPage < 1) {
+        return 0;
+    }
+    return (int)((snapshot->size() + entriesPerPage - 1) / entriesPerPage);
+}
+
+int TableRenderer::pageOfKey(int key, int entriesPerPage) const {
+    if (!snapshot || entriesPerPage < 1) {
+        return 0;
+    }
+    long index = sorted ? sorter.positionOfKey(key) : snapshot->findIndexByKey(key);
+    return index < 0 ? 0 : (int)(index / entriesPerPage) + 1;
+}
+
+void TableRenderer::setSortOrder(const std::string& fieldName, bool descending) {
+    sorted = true;
+    sortField = fieldName;
+    sortDescending = descending;
+    if (snapshot) {
+        sorter.setOrder(snapshot, sortField, sortDescending);
+    }
+    pageRowsCache.clear();
+    widthCache.clear();
+}
+
+void TableRenderer::clearSortOrder() {
+    sorted = false;
+    pageRowsCache.clear();
+    widthCache.clear();
+}
+
+const std::vector<size_t>& TableRenderer::pageRows(int page, int entriesPerPage) {
+    long long cacheKey = ((long long)entriesPerPage << 32) | (unsigned int)page;
+    auto it = pageRowsCache.find(cacheKey);
+    if (it != pageRowsCache.end()) {
+        return it->second;
+    }
+
+    std::vector<size_t> rows;
+    size_t start = (size_t)(page - 1) * entriesPerPage;
+    size_t end = std::min(start + entriesPerPage, snapshot->size());
+    if (sorted) {
+        sorter.selectRange(start, end, rows); // Top-K selection of just this page
+    } else {
+        for (size_t i = start; i < end; ++i) {
+            rows.push_back(i);
+        }
+    }
+    return pageRowsCache.emplace(cacheKey, std::move(rows)).first->second;
+}
+
+const std::vector<std::string>& TableRenderer::rowCells(size_t index) {
+    auto it = cellCache.find(index);
+    if (it != cellCache.end()) {
+        return it->second;
+    }
+    if (cellCache.size() >= kMaxCachedRows) {
+        cellCache.clear(); // Cheap bound; a page is re-formatted at most once after this
+    }
+
+    const Entry& entry = (*snapshot)[index];
+    std::vector<std::string> cells;
+    cells.reserve(formDef->fields.size() + 1);
+    cells.push_back(std::to_string(entry.key));
+    for (const auto& field : formDef->fields) {
+        auto value = entry.data.find(field->name);
+        cells.push_back(value != entry.data.end() ? formatFieldValue(value->second) : "N/A");
+    }
+    return cellCache.emplace(index, std::move(cells)).first->second;
+}
+
+void TableRenderer::setColumnLayout(std::vector<size_t> widths) {
+    if (widths.size() == formDef->fields.size() + 1) {
+        layout = std::move(widths);
+    } else {
+        layout.clear();
+    }
+}
+
+const std::vector<size_t>& TableRenderer::columnWidths(int page, int entriesPerPage) {
+    if (!layout.empty()) {
+        return layout;
+    }
+    long long cacheKey = ((long long)entriesPerPage << 32) | (unsigned int)page;
+    auto it = widthCache.find(cacheKey);
+    if (it != widthCache.end()) {
+        return it->second;
+    }
+
+    std::vector<size_t> widths;
+    widths.push_back(kKeyColumnMinWidth);
+    for (const auto& field : formDef->fields) {
+        widths.push_back(field->name.length()); // Initial width is field name length
+    }
+    for (size_t row : pageRows(page, entriesPerPage)) {
+        const std::vector<std::string>& cells = rowCells(row);
+        for (size_t c = 0; c < cells.size(); ++c) {
+            widths[c] = std::max(widths[c], cells[c].size());
+        }
+    }
+    return widthCache.emplace(cacheKey, std::move(widths)).first->second;
+}
+
+void TableRenderer::renderPage(std::string& out, int page, int entriesPerPage) {
+    TRACE_SCOPE("TableRenderer::renderPage");
+    int pages = totalPages(entriesPerPage);
+    if (pages == 0) {
+        out += "No entries to display.\n";
+        return;
+    }
+    page = std::max(1, std::min(page, pages));
+
+    // Copy the widths: formatting rows below may evict the width cache
+    std::vector<size_t> widths = columnWidths(page, entriesPerPage);
+
+    out += "\n--- Viewing Entries for Form: " + formDef->name + " (Page " + std::to_string(page) + "/" + std::to_string(pages) + ")";
+    if (sorted) {
+        out += " sorted by " + sortField + (sortDescending ? " (descending)" : " (ascending)");
+    }
+    out += " ---\n";
+
+    // Header and separator
+    appendPadded(out, "KEY", widths[0]);
+    for (size_t f = 0; f < formDef->fields.size(); ++f) {
+        appendPadded(out, formDef->fields[f]->name, widths[f + 1]);
+    }
+    out += "\n";
+    for (size_t width : widths) {
+        out.append(width + kColumnGap, '-');
+    }
+    out += "\n";
+
+    std::vector<size_t> rows = pageRows(page, entriesPerPage); // Copied: rowCells below may evict caches
+    for (size_t row : rows) {
+        const std::vector<std::string>& cells = rowCells(row);
+        for (size_t c = 0; c < cells.size(); ++c) {
+            appendPadded(out, cells[c], widths[c]);
+        }
+        out += "\n";
+    }
+
+    // Page navigation, only when there is another page to go to
+    if (pages > 1) {
+        out += "\nPage Navigation: ";
+        if (page > 1) {
+            out += "< Previous ";
+        }
+        out += " (Current Page: " + std::to_string(page) + ") ";
+        if (page < pages) {
+            out += "Next >";
+        }
+        out += "\n";
+    }
+}
+
+void TableRenderer::writePage(int page, int entriesPerPage) {
+    std::string buffer;
+    renderPage(buffer, page, entriesPerPage);
+    // One write through std::cout keeps ordering with earlier output and honours redirection
+    std::cout.write(buffer.data(), (std::streamsize)buffer.size());
+    std::cout.flush();
+}
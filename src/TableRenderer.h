@@ -0,0 +1,60 @@
+#ifndef TABLE_RENDERER_H
+#define TABLE_RENDERER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory> // For std::shared_ptr
+#include "FormDefinition.h" // For FormDefinition
+#include "EntrySnapshot.h" // For EntrySnapshotPtr
+#include "SortedPageSelector.h" // For SortedPageSelector
+
+// Formats pages of entries as an aligned text table.
+// Only the rows of the requested page are formatted; formatted cells and per-page
+// column widths are cached, so paging back and forth over the same snapshot does not
+// reformat anything. A page is built into one buffer and written with a single write.
+class TableRenderer {
+private:
+    std::shared_ptr<FormDefinition> formDef;
+    EntrySnapshotPtr snapshot;
+    std::unordered_map<size_t, std::vector<std::string>> cellCache; // Row index -> KEY cell followed by one cell per field
+    std::unordered_map<long long, std::vector<size_t>> widthCache; // (page size, page) -> column widths
+    std::vector<size_t> layout; // Fixed widths for every page; empty means size columns per page
+    std::unordered_map<long long, std::vector<size_t>> pageRowsCache; // (page size, page) -> row indices shown
+    SortedPageSelector sorter;
+    bool sorted;
+    std::string sortField;
+    bool sortDescending;
+
+    const std::vector<std::string>& rowCells(size_t index);
+    const std::vector<size_t>& columnWidths(int page, int entriesPerPage);
+    const std::vector<size_t>& pageRows(int page, int entriesPerPage);
+
+public:
+    explicit TableRenderer(std::shared_ptr<FormDefinition> formDef);
+
+    // Switches to another snapshot; caches are dropped only if it is actually a different snapshot
+    void setSnapshot(EntrySnapshotPtr snapshot);
+
+    // Uses the same column widths on every page (KEY first, then one per field), e.g. from
+    // EntryManager::getColumnLayout(); an empty or mismatched vector restores per-page widths
+    void setColumnLayout(std::vector<size_t> widths);
+
+    // Shows entries ordered by a field; only the rows of each requested page are sorted
+    void setSortOrder(const std::string& fieldName, bool descending);
+    void clearSortOrder();
+    bool isSorted() const { return sorted; }
+
+    int totalPages(int entriesPerPage) const;
+
+    // Page (1-based) that contains the entry with 'key', or 0 if there is no such entry
+    int pageOfKey(int key, int entriesPerPage) const;
+
+    // Appends the formatted page to 'out'; 'page' is clamped to the valid range
+    void renderPage(std::string& out, int page, int entriesPerPage);
+
+    // Renders the page and writes it to std::cout in one write
+    void writePage(int page, int entriesPerPage);
+};
+
+#endif // TABLE_RENDERER_H
@@ -0,0 +1,81 @@
+#include "TimestampIndex.h"
+#include "Entry.h" // For Entry
+#include "Instrumentation.h" // For TRACE_SCOPE
+#include <algorithm> // For std::sort, std::is_sorted, std::lower_bound, std::upper_bound
+#include <utility> // For std::pair
+
+std::shared_ptr<const TimestampIndex> TimestampIndex::build(const EntrySnapshotPtr& snapshot, const std::string& fieldName,
+                                                            const TimestampIndex* previous) {
+    TRACE_SCOPE("TimestampIndex::build");
+    auto index = std::make_shared<TimestampIndex>();
+    index->snapshot = snapshot;
+    index->fieldName = fieldName;
+    if (!snapshot) {
+        return index;
+    }
+
+    // Identical segment pointers hold identical rows at identical positions, because every
+    // segment before the last is full
+    size_t reusedRows = 0;
+    if (previous && previous->snapshot && previous->fieldName == fieldName) {
+        const auto& oldSegments = previous->snapshot->getSegments();
+        const auto& newSegments = snapshot->getSegments();
+        size_t shared = 0;
+        while (shared < oldSegments.size() && shared < newSegments.size() && oldSegments[shared] == newSegments[shared]) {
+            ++shared;
+        }
+        reusedRows = std::min(shared * EntrySnapshot::kSegmentCapacity, previous->snapshot->size());
+    }
+
+    std::vector<std::pair<int64_t, uint32_t>> added;
+    for (size_t i = reusedRows; i < snapshot->size(); ++i) {
+        const Entry& entry = (*snapshot)[i];
+        auto value = entry.data.find(fieldName);
+        if (value == entry.data.end()) {
+            continue;
+        }
+        visitField<FieldKind::Timestamp>(value->second, [&added, i](Timestamp time) {
+            added.emplace_back(time.millis, static_cast<uint32_t>(i));
+        });
+    }
+    if (!std::is_sorted(added.begin(), added.end())) {
+        std::sort(added.begin(), added.end());
+    }
+
+    // Merge the rows kept from 'previous' with the new ones; for rows appended in time
+    // order this is a plain concatenation
+    size_t keptCount = reusedRows > 0 ? previous->times.size() : 0;
+    index->times.reserve(keptCount + added.size());
+    index->rows.reserve(keptCount + added.size());
+    size_t next = 0;
+    for (size_t i = 0; i < keptCount; ++i) {
+        if (previous->rows[i] >= reusedRows) {
+            continue; // Row was in a segment that changed
+        }
+        while (next < added.size() && added[next].first < previous->times[i]) {
+            index->times.push_back(added[next].first);
+            index->rows.push_back(added[next].second);
+            ++next;
+        }
+        index->times.push_back(previous->times[i]);
+        index->rows.push_back(previous->rows[i]);
+    }
+    for (; next < added.size(); ++next) {
+        index->times.push_back(added[next].first);
+        index->rows.push_back(added[next].second);
+    }
+    return index;
+}
+
+void TimestampIndex::rowsInRange(Timestamp from, Timestamp to, std::vector<size_t>& out) const {
+    auto first = std::lower_bound(times.begin(), times.end(), from.millis);
+    auto last = std::upper_bound(first, times.end(), to.millis);
+    for (auto it = first; it != last; ++it) {
+        out.push_back(rows[it - times.begin()]);
+    }
+}
+
+size_t TimestampIndex::countInRange(Timestamp from, Timestamp to) const {
+    auto first = std::lower_bound(times.begin(), times.end(), from.millis);
+    return std::upper_bound(first, times.end(), to.millis) - first;
+}
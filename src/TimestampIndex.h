@@ -0,0 +1,38 @@
+#ifndef TIMESTAMP_INDEX_H
+#define TIMESTAMP_INDEX_H
+
+#include <string>
+#include <vector>
+#include <memory> // For std::shared_ptr
+#include <cstdint>
+#include "FieldValue.h" // For Timestamp
+#include "EntrySnapshot.h" // For EntrySnapshotPtr
+
+// Range index over one timestamp field of a snapshot: the field's values sorted in one
+// contiguous array, with the row index of each value in a parallel array, so a time range
+// is two binary searches. Rows without the field are not indexed.
+class TimestampIndex {
+private:
+    EntrySnapshotPtr snapshot;
+    std::string fieldName;
+    std::vector<int64_t> times; // Epoch milliseconds, ascending
+    std::vector<uint32_t> rows; // Row index of each time; ties are in row order
+
+public:
+    // Indexes 'fieldName' over 'snapshot'. Leading segments shared with the snapshot
+    // 'previous' was built from are taken from it instead of being read again, so after
+    // an append only the new tail is read, and rows that arrive in time order need no sort.
+    static std::shared_ptr<const TimestampIndex> build(const EntrySnapshotPtr& snapshot, const std::string& fieldName,
+                                                       const TimestampIndex* previous = nullptr);
+
+    const EntrySnapshotPtr& getSnapshot() const { return snapshot; }
+    const std::string& getFieldName() const { return fieldName; }
+    size_t size() const { return times.size(); }
+    size_t memoryBytes() const { return times.capacity() * sizeof(int64_t) + rows.capacity() * sizeof(uint32_t); }
+
+    // Appends the rows whose time lies in [from, to], in time order
+    void rowsInRange(Timestamp from, Timestamp to, std::vector<size_t>& out) const;
+    size_t countInRange(Timestamp from, Timestamp to) const;
+};
+
+#endif // TIMESTAMP_INDEX_H
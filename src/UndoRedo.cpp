@@ -0,0 +1,72 @@
+#include "UndoRedo.h"
+#include "FormDefinition.h" // For FormDefinition
+#include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For acquireSelectedManager
+#include <iostream>
+#include <string>
+
+void undoRedoMenu() {
+    std::shared_ptr<FormDefinition> selectedForm;
+    auto manager = acquireSelectedManager(selectedForm);
+    if (!manager) {
+        return;
+    }
+
+    int choice;
+    std::cout << "\n--- Undo, Redo and Snapshots (" << manager->getUndoDepth() << " to undo, "
+              << manager->getRedoDepth() << " to redo) ---\n";
+    std::cout << "1. Undo\n";
+    std::cout << "2. Redo\n";
+    std::cout << "3. Save Snapshot\n";
+    std::cout << "4. Restore Snapshot\n";
+    std::cout << "5. List Snapshots\n";
+    std::cout << "Enter your choice: ";
+    std::cin >> choice;
+
+    std::string label;
+    std::string name;
+    switch (choice) {
+        case 1:
+            if (manager->undo(&label)) {
+                std::cout << "Undid '" << label << "'.\n";
+            } else {
+                std::cout << "Nothing to undo.\n";
+            }
+            break;
+        case 2:
+            if (manager->redo(&label)) {
+                std::cout << "Redid '" << label << "'.\n";
+            } else {
+                std::cout << "Nothing to redo.\n";
+            }
+            break;
+        case 3:
+            std::cout << "Enter a name for the snapshot: ";
+            std::getline(std::cin >> std::ws, name);
+            manager->saveSnapshot(name);
+            std::cout << "Snapshot '" << name << "' saved.\n";
+            break;
+        case 4:
+            std::cout << "Enter the name of the snapshot to restore: ";
+            std::getline(std::cin >> std::ws, name);
+            if (manager->restoreSnapshot(name)) {
+                std::cout << "Snapshot '" << name << "' restored; undo brings back the entries before it.\n";
+            } else {
+                std::cout << "No snapshot named '" << name << "'.\n";
+            }
+            break;
+        case 5: {
+            auto names = manager->listSnapshots();
+            if (names.empty()) {
+                std::cout << "No snapshots saved for this form.\n";
+            }
+            for (const auto& snapshotName : names) {
+                std::cout << "- " << snapshotName << "\n";
+            }
+            break;
+        }
+        default:
+            std::cout << "Invalid choice.\n";
+            break;
+    }
+}
@@ -0,0 +1,7 @@
+#ifndef UNDO_REDO_H
+#define UNDO_REDO_H
+
+// Undo, redo and named snapshots of the selected form's entries
+void undoRedoMenu();
+
+#endif // UNDO_REDO_H
@@ -1,58 +1,115 @@
 #include "ViewEntry.h"
-#include "FormDefinition.h" // For currentSelectedForm
-#include "Entry.h"          // For currentEntryManager
+#include "FormDefinition.h" // For FormDefinition
+#include "Entry.h"          // For EntryManager
+#include "EntryManagerPool.h" // For acquireSelectedManager
+#include "TableRenderer.h" // For TableRenderer
 #include <iostream>
 #include <limits> // For numeric_limits
-
-extern std::unique_ptr<EntryManager> currentEntryManager; // Declare extern
+#include <algorithm> // For std::max, std::min
 
 void viewEntry() {
-    if (!currentSelectedForm) {
-        std::cout << "No form is currently selected. Please select a form first (Option 3).\n";
+    std::shared_ptr<FormDefinition> selectedForm;
+    auto manager = acquireSelectedManager(selectedForm);
+    if (!manager) {
         return;
     }
 
-    if (!currentEntryManager || currentEntryManager->getFormName() != currentSelectedForm->name) {
-        currentEntryManager = std::make_unique<EntryManager>(currentSelectedForm->name);
-    }
-
-    if (currentEntryManager->getEntries().empty()) {
+    if (manager->getEntries()->empty()) {
         std::cout << "No entries to display for the current form.\n";
         return;
     }
 
+    // The renderer lives for the whole browsing session so revisited pages come from its cache
+    TableRenderer renderer(selectedForm);
+    renderer.setSnapshot(manager->getEntries());
+
     int currentPage = 1;
-    int entriesPerPage = 5;
-    int totalEntries = currentEntryManager->getEntries().size();
-    int totalPages = (totalEntries + entriesPerPage - 1) / entriesPerPage;
+    int entriesPerPage = 5; // The prompt is shown even for a single page: sorting, page size and go-to-key still apply
 
     std::string navChoice;
     do {
-        currentEntryManager->viewEntries(currentPage, entriesPerPage);
+        renderer.setSnapshot(manager->getEntries()); // Pick up writes made by other threads
+        renderer.setColumnLayout(manager->getColumnLayout(*selectedForm)); // Same widths on every page
+        int totalPages = renderer.totalPages(entriesPerPage);
+        if (totalPages == 0) {
+            std::cout << "No entries to display for the current form.\n";
+            return;
+        }
+        currentPage = std::max(1, std::min(currentPage, totalPages));
+        renderer.writePage(currentPage, entriesPerPage);
 
-        if (totalPages > 1) {
-            std::cout << "Enter 'n' for next page, 'p' for previous page, or 'q' to quit viewing: ";
-            std::cin >> navChoice;
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear buffer
+        std::cout << "Enter 'n' next, 'p' previous, 'f' first, 'l' last, 'g <page>' go to page, 'k <key>' go to key,\n"
+                  << "'s <size>' set page size, 'a <field>'/'d <field>' sort ascending/descending, 'u' unsorted,\n"
+                  << "or 'q' to quit viewing: ";
+        if (!(std::cin >> navChoice)) {
+            break;
+        }
 
-            if (navChoice == "n" || navChoice == "N") {
-                if (currentPage < totalPages) {
-                    currentPage++;
+        if (navChoice == "n" || navChoice == "N") {
+            if (currentPage < totalPages) {
+                currentPage++;
+            } else {
+                std::cout << "Already on the last page.\n";
+            }
+        } else if (navChoice == "p" || navChoice == "P") {
+            if (currentPage > 1) {
+                currentPage--;
+            } else {
+                std::cout << "Already on the first page.\n";
+            }
+        } else if (navChoice == "a" || navChoice == "A" || navChoice == "d" || navChoice == "D") {
+            std::string fieldName;
+            std::getline(std::cin, fieldName); // Rest of the line; field names may contain spaces
+            size_t first = fieldName.find_first_not_of(" \t");
+            fieldName = first == std::string::npos ? "" : fieldName.substr(first, fieldName.find_last_not_of(" \t") - first + 1);
+            bool known = false;
+            for (const auto& field : selectedForm->fields) {
+                known = known || field->name == fieldName;
+            }
+            if (!known) {
+                std::cout << "Unknown field '" << fieldName << "'.\n";
+            } else {
+                renderer.setSortOrder(fieldName, navChoice == "d" || navChoice == "D");
+                currentPage = 1;
+            }
+            continue; // The line was consumed above
+        } else if (navChoice == "u" || navChoice == "U") {
+            renderer.clearSortOrder();
+            currentPage = 1;
+        } else if (navChoice == "f" || navChoice == "F") {
+            currentPage = 1;
+        } else if (navChoice == "l" || navChoice == "L") {
+            currentPage = totalPages;
+        } else if (navChoice == "g" || navChoice == "G" || navChoice == "k" || navChoice == "K" || navChoice == "s" || navChoice == "S") {
+            int value;
+            if (!(std::cin >> value)) {
+                std::cin.clear();
+                std::cout << "Invalid number.\n";
+            } else if (navChoice == "g" || navChoice == "G") {
+                if (value < 1 || value > totalPages) {
+                    std::cout << "Page must be between 1 and " << totalPages << ".\n";
                 } else {
-                    std::cout << "Already on the last page.\n";
+                    currentPage = value;
                 }
-            } else if (navChoice == "p" || navChoice == "P") {
-                if (currentPage > 1) {
-                    currentPage--;
+            } else if (navChoice == "k" || navChoice == "K") {
+                int page = renderer.pageOfKey(value, entriesPerPage);
+                if (page == 0) {
+                    std::cout << "Entry with key " << value << " not found.\n";
                 } else {
-                    std::cout << "Already on the first page.\n";
+                    currentPage = page;
                 }
-            } else if (navChoice != "q" && navChoice != "Q") {
-                std::cout << "Invalid navigation choice.\n";
+            } else if (value < 1) {
+                std::cout << "Page size must be at least 1.\n";
+            } else {
+                // Keep the first row of the current page visible after resizing
+                int firstRow = (currentPage - 1) * entriesPerPage;
+                entriesPerPage = value;
+                currentPage = firstRow / entriesPerPage + 1;
             }
-        } else {
-            navChoice = "q"; // No navigation needed if only one page
+        } else if (navChoice != "q" && navChoice != "Q") {
+            std::cout << "Invalid navigation choice.\n";
         }
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear buffer
 
     } while (navChoice != "q" && navChoice != "Q");
 }
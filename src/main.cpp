@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <memory> // For std::unique_ptr
+#include <cstdlib> // For std::getenv
 
 #include "CreateNewForm.h"
 #include "DeleteForm.h"
@@ -10,21 +11,106 @@
 #include "EditEntry.h"
 #include "ViewEntry.h"
 #include "DeleteEntry.h"
+#include "UndoRedo.h"
 #include "SaveAsCSV.h"
 #include "SaveAsJSON.h"
 #include "SaveAsSQL.h"
+#include "SaveAsColumnar.h"
+#include "SaveAsArrow.h"
+#include "ServiceMode.h"
+#include "FormStats.h"
+#include "Instrumentation.h" // For configureInstrumentation
+#include "BlockCompression.h" // For setCompressionEnabled
+#include "SchemaMigration.h" // For SchemaMigration, setBackgroundSchemaRewrite
 #include "FormDefinition.h" // For currentSelectedForm
 #include "Entry.h"          // For EntryManager
+#include "EntryReader.h"    // For PartitionedEntryReader
+#include "MappedEntrySource.h" // For MappedEntrySource
 
 // Global variable to hold the currently selected form (declared in FormDefinition.h)
 // std::shared_ptr<FormDefinition> currentSelectedForm; // Already declared in FormDefinition.h
 
 // Global EntryManager instance, initialized when a form is selected (defined in Entry.cpp)
-extern std::unique_ptr<EntryManager> currentEntryManager;
+extern std::shared_ptr<EntryManager> currentEntryManager;
 
 void saveAs(); // Declare saveAs function prototype
 
-int main() {
+// Optionally sets the form's uniqueness mode, then removes the duplicates already stored
+int runDedupPass(const std::vector<std::string>& args) {
+    auto formDef = FormDefinition::loadFromFile("Forms/" + args[0] + ".form");
+    if (!formDef) {
+        std::cerr << "Error: Could not load form '" << args[0] << "'.\n";
+        return 1;
+    }
+    EntryManager manager(formDef->name, formDef);
+    if (args.size() > 1) {
+        DedupSettings settings;
+        std::string error;
+        if (!DedupSettings::parseSpec(args[1] + ":" + (args.size() > 2 ? args[2] : ""), settings)) {
+            std::cerr << "Error: Unknown dedup mode '" << args[1] << "' (use reject, merge or off).\n";
+            return 1;
+        }
+        if (!settings.checkFields(*formDef, error)) {
+            std::cerr << "Error: " << error << ".\n";
+            return 1;
+        }
+        manager.setDedupSettings(settings);
+    }
+    size_t removed = manager.removeDuplicates();
+    std::cout << "Removed " << removed << " duplicate entries from form '" << formDef->name << "'.\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (const char* traceSpec = std::getenv("TODOAPP_TRACE")) {
+        if (!configureInstrumentation(traceSpec)) {
+            std::cerr << "Warning: Ignoring invalid TODOAPP_TRACE value '" << traceSpec << "'.\n";
+        }
+    }
+
+    if (const char* compressSpec = std::getenv("TODOAPP_COMPRESS")) {
+        setCompressionEnabled(std::string(compressSpec) == "1");
+    }
+
+    bool serve = false;
+    std::string socketPath = kDefaultServiceSocketPath;
+    std::vector<std::string> dedupArgs; // Form name, then optional mode and identity fields
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--trace" && i + 1 < argc) {
+            if (!configureInstrumentation(argv[++i])) {
+                std::cerr << "Error: Invalid trace spec '" << argv[i] << "' (use summary and/or chrome:<file>).\n";
+                return 1;
+            }
+        } else if (arg == "--compress") {
+            setCompressionEnabled(true); // LZ4 compress partition files and saveAs outputs
+        } else if (arg == "--migrate-in-background") {
+            setBackgroundSchemaRewrite(true); // Rewrite forms opened after a schema change without blocking
+        } else if (arg == "--serve") {
+            // "TodoApp --serve [socket]" runs the long-lived service instead of the interactive menu
+            serve = true;
+            if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                socketPath = argv[++i];
+            }
+        } else if (arg == "--dedup" && i + 1 < argc) {
+            // "TodoApp --dedup <form> [reject|merge|off] [field,...]" runs the offline dedup pass and exits
+            dedupArgs.push_back(argv[++i]);
+            while (dedupArgs.size() < 3 && i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                dedupArgs.push_back(argv[++i]);
+            }
+        } else {
+            std::cerr << "Usage: TodoApp [--trace summary|chrome:<file>] [--compress] [--migrate-in-background] [--serve [socket]]\n"
+                      << "       TodoApp --dedup <form> [reject|merge|off] [field,...]\n";
+            return 1;
+        }
+    }
+    if (!dedupArgs.empty()) {
+        return runDedupPass(dedupArgs);
+    }
+    if (serve) {
+        return runService(socketPath);
+    }
+
     int choice;
     do {
         std::cout << "\n--- Todo App Menu ---\n";
@@ -37,6 +123,8 @@ int main() {
         std::cout << "7. Delete Entry\n";
         std::cout << "8. Save As\n";
         std::cout << "9. Exit\n";
+        std::cout << "10. Form Stats\n";
+        std::cout << "11. Undo, Redo and Snapshots\n";
         std::cout << "Enter your choice: ";
         std::cin >> choice;
 
@@ -68,6 +156,12 @@ int main() {
             case 9:
                 std::cout << "Exiting Todo App. Goodbye!\n";
                 break;
+            case 10:
+                showFormStats();
+                break;
+            case 11:
+                undoRedoMenu();
+                break;
             default:
                 std::cout << "Invalid choice. Please try again.\n";
         }
@@ -77,41 +171,51 @@ int main() {
 }
 
 void saveAs() {
-    if (!currentSelectedForm) {
+    // A local copy, as in acquireSelectedManager(); exports read from disk and need no pooled manager
+    auto selectedForm = std::atomic_load(&currentSelectedForm);
+    if (!selectedForm) {
         std::cout << "No form is currently selected. Please select a form first (Option 3).\n";
         return;
     }
 
-    // If the form changes, or if it's the first time, create/recreate the EntryManager
-    if (!currentEntryManager || currentEntryManager->getFormName() != currentSelectedForm->name) {
-        currentEntryManager = std::make_unique<EntryManager>(currentSelectedForm->name);
-    }
-
-    if (currentEntryManager->getEntries().empty()) {
+    // Stream rows partition by partition instead of loading them all into an EntryManager
+    PartitionedEntryReader reader(selectedForm->name, std::make_shared<SchemaMigration>(*selectedForm));
+    if (!reader.isOpen() || reader.atEnd()) {
         std::cout << "No entries to save for the current form.\n";
         return;
     }
+    // Export straight out of the mapped partition files when they need no decompression or migration
+    MappedEntrySource mapped(selectedForm->name, *selectedForm);
+    EntrySource& source = mapped.isUsable() ? static_cast<EntrySource&>(mapped) : reader;
 
     int saveChoice;
     std::cout << "\n--- Save Entries As ---\n";
     std::cout << "1. Save as CSV\n";
     std::cout << "2. Save as JSON\n";
     std::cout << "3. Save as SQL\n";
+    std::cout << "4. Save as columnar binary\n";
+    std::cout << "5. Save as Arrow IPC\n";
     std::cout << "Enter your choice: ";
     std::cin >> saveChoice;
     std::cin.ignore(); // Clear the buffer
 
-    std::string outputFilename = "Forms/" + currentSelectedForm->name + "_entries";
+    std::string outputFilename = "Forms/" + selectedForm->name + "_entries";
 
     switch (saveChoice) {
         case 1:
-            saveAsCSV(outputFilename + ".csv", currentSelectedForm, currentEntryManager->getEntries());
+            saveAsCSV(outputFilename + ".csv", selectedForm, source);
             break;
         case 2:
-            saveAsJSON(outputFilename + ".json", currentSelectedForm, currentEntryManager->getEntries());
+            saveAsJSON(outputFilename + ".json", selectedForm, source);
             break;
         case 3:
-            saveAsSQL(outputFilename + ".sql", currentSelectedForm, currentEntryManager->getEntries());
+            saveAsSQL(outputFilename + ".sql", selectedForm, source);
+            break;
+        case 4:
+            saveAsColumnar(outputFilename + ".cols", selectedForm, source);
+            break;
+        case 5:
+            saveAsArrow(outputFilename + ".arrow", selectedForm, source);
             break;
         default:
             std::cout << "Invalid choice. No entries saved.\n";
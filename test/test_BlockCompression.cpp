@@ -0,0 +1,33 @@
+#include "gtest/gtest.h"
+#include "BlockCompression.h"
+#include "EntryReader.h"
+#include <cstdio> // For std::remove
+
+TEST(BlockCompressionTest, FrameRoundTripThroughEntryReader) {
+    const std::string path = "block_compression_test.dat";
+    std::string written;
+    {
+        OutputFile output(path, true);
+        ASSERT_TRUE(output.isOpen());
+        ASSERT_EQ(output.getPath(), path + kCompressedFileSuffix);
+        // Several batches of blocks, mixing repetitive rows with some that do not compress
+        for (int key = 1; written.size() < 6 * kCompressionBlockSize; ++key) {
+            std::string record = "KEY:" + std::to_string(key) + "\nname:string:row " + std::to_string(key * 7919 % 104729) + "\n---\n";
+            output.stream() << record;
+            written += record;
+        }
+        ASSERT_TRUE(output.close());
+    }
+    ASSERT_TRUE(isCompressedFile(path + kCompressedFileSuffix));
+
+    InputFile input(path + kCompressedFileSuffix);
+    ASSERT_TRUE(input.isOpen());
+    std::string read((std::istreambuf_iterator<char>(input.stream())), std::istreambuf_iterator<char>());
+    EXPECT_EQ(read, written);
+
+    std::vector<Entry> rows;
+    ASSERT_TRUE(readEntriesFile(path + kCompressedFileSuffix, rows, 4));
+    ASSERT_FALSE(rows.empty());
+    EXPECT_EQ(rows.back().key, (int)rows.size());
+    std::remove((path + kCompressedFileSuffix).c_str());
+}
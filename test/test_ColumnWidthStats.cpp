@@ -0,0 +1,45 @@
+#include "gtest/gtest.h"
+#include "ColumnWidthStats.h"
+#include "Entry.h"
+#include <cstdio> // For std::remove
+
+namespace {
+
+Entry makeEntry(int key, const std::string& title, int qty) {
+    Entry entry(key);
+    entry.data["title"] = title;
+    entry.data["qty"] = qty;
+    return entry;
+}
+
+} // namespace
+
+TEST(ColumnWidthStatsTest, TracksMaxAcrossAddAndRemove) {
+    ColumnWidthStats stats;
+    Entry wide = makeEntry(1, "a much longer title", 12345);
+    stats.addEntry(makeEntry(2, "short", 7));
+    stats.addEntry(wide);
+
+    EXPECT_EQ(stats.maxWidth("title"), 19u);
+    EXPECT_EQ(stats.maxWidth("qty"), 5u);
+    EXPECT_EQ(stats.percentileWidth("title", 0.5), 5u);
+
+    stats.removeEntry(wide);
+    EXPECT_EQ(stats.maxWidth("title"), 5u);
+    EXPECT_EQ(stats.maxWidth("qty"), 1u);
+    EXPECT_EQ(stats.getEntryCount(), 1u);
+}
+
+TEST(ColumnWidthStatsTest, SidecarRoundTripChecksSource) {
+    ColumnWidthStats stats;
+    stats.addEntry(makeEntry(1, "title", 42));
+    const std::string path = "column_width_stats_test.widths";
+    ASSERT_TRUE(stats.saveToFile(path, 100));
+
+    ColumnWidthStats loaded;
+    EXPECT_FALSE(loaded.loadFromFile(path, 101, 1)); // Entries file changed since
+    ASSERT_TRUE(loaded.loadFromFile(path, 100, 1));
+    EXPECT_EQ(loaded.maxWidth("title"), 5u);
+    EXPECT_EQ(loaded.maxWidth("qty"), 2u);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+#include "SaveAsColumnar.h"
+#include "SaveAsArrow.h"
+#include "ColumnBatch.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <cstring> // For std::memcpy
+#include <cstdio> // For std::remove
+
+namespace {
+
+// Reads little-endian values from an exported file
+class ByteReader {
+public:
+    explicit ByteReader(const std::string& path)
+        : bytes(std::istreambuf_iterator<char>(std::ifstream(path, std::ios::binary).rdbuf()), {}), position(0) {}
+
+    template <typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, bytes.data() + position, sizeof(T));
+        position += sizeof(T);
+        return value;
+    }
+
+    std::string text(size_t length) {
+        position += length;
+        return bytes.substr(position - length, length);
+    }
+
+    std::string bytes;
+    size_t position;
+};
+
+} // namespace
+
+TEST(ColumnarExportTest, ColumnarAndArrowFilesDescribeTheirColumns) {
+    std::stringstream formText("string:name\nnumber:count:int\nselect:status\n  option:1:open\n  option:2:done\n");
+    auto formDef = FormDefinition::loadFromStream(formText, "columnar_test");
+    std::vector<Entry> entries;
+    for (int i = 0; i < 10; ++i) {
+        Entry entry(i + 1);
+        if (i != 3) {
+            entry.data["name"] = std::string("row ") + std::to_string(i);
+        }
+        entry.data["count"] = i * 2;
+        entry.data["status"] = std::string(i % 3 == 0 ? "open" : i % 3 == 1 ? "done" : "blocked");
+        entries.push_back(entry);
+    }
+
+    saveAsColumnar("columnar_test.cols", formDef, entries);
+    ByteReader cols("columnar_test.cols");
+    ASSERT_EQ(cols.text(8), "TODOCOL1");
+    EXPECT_EQ(cols.text(cols.read<uint32_t>()), "columnar_test");
+    ASSERT_EQ(cols.read<uint32_t>(), 4u); // KEY plus three fields
+    std::vector<uint8_t> encodings;
+    for (int i = 0; i < 4; ++i) {
+        encodings.push_back(cols.read<uint8_t>());
+        cols.text(cols.read<uint32_t>());
+    }
+    EXPECT_EQ(encodings, (std::vector<uint8_t>{1, 0, 1, 5}));
+    ASSERT_EQ(cols.read<uint32_t>(), 10u);
+
+    cols.text(2); // KEY validity
+    for (int key = 1; key <= 10; ++key) {
+        ASSERT_EQ(cols.read<int32_t>(), key);
+    }
+    EXPECT_EQ(cols.read<uint8_t>(), 0xF7); // name validity: row 3 is null
+    cols.text(1);
+    std::vector<uint32_t> offsets;
+    for (int i = 0; i <= 10; ++i) {
+        offsets.push_back(cols.read<uint32_t>());
+    }
+    EXPECT_EQ(cols.text(offsets.back()).substr(offsets[9]), "row 9");
+    cols.text(2 + 10 * 4); // count
+    cols.text(2); // status validity
+    ASSERT_EQ(cols.read<uint32_t>(), 3u); // The options, then values seen in the rows
+    EXPECT_EQ(cols.text(cols.read<uint32_t>()), "open");
+    EXPECT_EQ(cols.text(cols.read<uint32_t>()), "done");
+    EXPECT_EQ(cols.text(cols.read<uint32_t>()), "blocked");
+    EXPECT_EQ(cols.read<int32_t>(), 0);
+    EXPECT_EQ(cols.read<int32_t>(), 1);
+    EXPECT_EQ(cols.read<int32_t>(), 2);
+    cols.text(7 * 4);
+    EXPECT_EQ(cols.read<uint32_t>(), 0u); // End of batches
+    EXPECT_EQ(cols.position, cols.bytes.size());
+
+    saveAsArrow("columnar_test.arrow", formDef, entries);
+    ByteReader arrow("columnar_test.arrow");
+    ASSERT_GT(arrow.bytes.size(), 32u);
+    EXPECT_EQ(arrow.text(8), std::string("ARROW1\0\0", 8));
+    EXPECT_EQ(arrow.read<uint32_t>(), 0xFFFFFFFFu); // Schema message
+    EXPECT_EQ(arrow.bytes.substr(arrow.bytes.size() - 6), "ARROW1");
+    arrow.position = arrow.bytes.size() - 10;
+    int32_t footerSize = arrow.read<int32_t>();
+    ASSERT_GT(footerSize, 0);
+    ASSERT_LT((size_t)footerSize, arrow.bytes.size() - 24);
+    arrow.position = arrow.bytes.size() - 10 - footerSize - 8;
+    EXPECT_EQ(arrow.read<uint32_t>(), 0xFFFFFFFFu); // End of stream marker before the footer
+    EXPECT_EQ(arrow.read<int32_t>(), 0);
+
+    std::remove("columnar_test.cols");
+    std::remove("columnar_test.arrow");
+}
@@ -3,19 +3,17 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <filesystem>
 
-void createNewFormWithInput(const std::string& formName) {
-    // Redirect input to provide the form name
-    std::stringstream input;
-    input << formName << std::endl; // Form name
-    input << "4" << std::endl;      // Finish form creation
-
-    std::cin.rdbuf(input.rdbuf()); // Redirect std::cin to the stringstream
+void createNewFormWithInput(const std::string& input) {
+    // Redirect input to provide the menu choices
+    std::stringstream stream(input);
+    std::streambuf* original = std::cin.rdbuf(stream.rdbuf()); // Redirect std::cin to the stringstream
 
     createNewForm();
 
     // Restore std::cin
-    std::cin.rdbuf(std::cin.tie()->rdbuf());
+    std::cin.rdbuf(original);
 }
 
 TEST(CreateNewFormTest, CreateNewForm) {
@@ -24,14 +22,39 @@ TEST(CreateNewFormTest, CreateNewForm) {
     std::string formFilePath = "Forms/" + formName + ".form";
 
     // Remove the form file if it exists.
+    std::filesystem::create_directories("Forms");
     std::remove(formFilePath.c_str());
 
-    createNewFormWithInput(formName);
+    // createNewForm() first skips the newline the main menu leaves behind, so the input starts with one
+    createNewFormWithInput("\n" + formName + "\n"
+                           "4\n"); // Finish form creation
 
     // Check if the form file exists.
     std::ifstream formFile(formFilePath);
     ASSERT_TRUE(formFile.good());
 
     // Clean up: Remove the form file.
+    formFile.close();
+    std::remove(formFilePath.c_str());
+}
+
+TEST(CreateNewFormTest, AddsTimestampInput) {
+    std::string formName = "test_timestamp_form";
+    std::string formFilePath = "Forms/" + formName + ".form";
+    std::filesystem::create_directories("Forms");
+    std::remove(formFilePath.c_str());
+
+    createNewFormWithInput("\n" + formName + "\n"
+                           "1\ntitle\n" // String input
+                           "5\ndue\n"   // Timestamp input
+                           "4\n");       // Finish form creation
+
+    std::ifstream formFile(formFilePath);
+    ASSERT_TRUE(formFile.good());
+    std::stringstream contents;
+    contents << formFile.rdbuf();
+    EXPECT_EQ(contents.str(), "string:title\ntimestamp:due\n");
+
+    formFile.close();
     std::remove(formFilePath.c_str());
 }
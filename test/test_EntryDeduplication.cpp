@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+#include "EntryDeduplication.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+
+namespace {
+
+const char* kFormName = "entry_dedup_test";
+
+std::shared_ptr<FormDefinition> makeForm() {
+    auto formDef = std::make_shared<FormDefinition>();
+    formDef->name = kFormName;
+    formDef->fields.push_back(std::make_shared<FormField>("sku", "string"));
+    formDef->fields.push_back(std::make_shared<NumberField>("qty", "int"));
+    return formDef;
+}
+
+} // namespace
+
+TEST(EntryDeduplicationTest, RejectsMergesAndRemovesDuplicates) {
+    EXPECT_EQ(xxHash64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(xxHash64("abc", 3), 0x44BC2CF5AD770999ULL);
+
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    auto formDef = makeForm();
+    {
+        EntryManager manager(kFormName, formDef);
+        manager.importEntries({{{"sku", std::string("a")}, {"qty", 1}},
+                               {{"sku", std::string("b")}, {"qty", 2}},
+                               {{"sku", std::string("a")}, {"qty", 1}}});
+        EXPECT_EQ(manager.removeDuplicates(), 1u); // Whole-row identity when no mode is set
+        ASSERT_EQ(manager.getEntries()->size(), 2u);
+
+        DedupSettings settings;
+        ASSERT_TRUE(DedupSettings::parseSpec("reject:", settings));
+        manager.setDedupSettings(settings);
+        size_t duplicates = 0;
+        EXPECT_EQ(manager.importEntries({{{"sku", std::string("b")}, {"qty", 2}},
+                                         {{"sku", std::string("c")}, {"qty", 3}},
+                                         {{"sku", std::string("c")}, {"qty", 3}}}, &duplicates), 1u);
+        EXPECT_EQ(duplicates, 2u);
+        bool duplicate = false;
+        EXPECT_EQ(manager.insertEntry({{"sku", std::string("a")}, {"qty", 1}}, &duplicate), 1);
+        EXPECT_TRUE(duplicate);
+    }
+    {
+        EntryManager manager(kFormName, formDef); // Mode comes back from the manifest
+        EXPECT_EQ(manager.getDedupSettings().mode, DedupSettings::Mode::Reject);
+        ASSERT_EQ(manager.getEntries()->size(), 3u);
+
+        DedupSettings settings;
+        ASSERT_TRUE(DedupSettings::parseSpec("merge:sku", settings));
+        manager.setDedupSettings(settings);
+        bool duplicate = false;
+        EXPECT_EQ(manager.insertEntry({{"sku", std::string("b")}, {"qty", 20}}, &duplicate), 2);
+        EXPECT_TRUE(duplicate);
+        EXPECT_EQ(std::get<int>((*manager.getEntries())[1].data.at("qty")), 20);
+        EXPECT_EQ(manager.getEntries()->size(), 3u);
+    }
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
@@ -0,0 +1,52 @@
+#include "gtest/gtest.h"
+#include "EntryFilter.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+
+namespace {
+
+const char* kFormName = "entry_filter_test";
+
+std::shared_ptr<FormDefinition> makeForm() {
+    auto formDef = std::make_shared<FormDefinition>();
+    formDef->name = kFormName;
+    formDef->fields.push_back(std::make_shared<NumberField>("qty", "int"));
+    auto status = std::make_shared<SelectField>("status");
+    status->options = {{1, "open"}, {2, "done"}};
+    formDef->fields.push_back(status);
+    return formDef;
+}
+
+} // namespace
+
+TEST(EntryFilterTest, BulkDeleteAndUpdateInOnePass) {
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    auto formDef = makeForm();
+    EntryManager manager(kFormName, formDef);
+    std::vector<std::map<std::string, FieldValue>> rows;
+    for (int i = 1; i <= 5000; ++i) {
+        rows.push_back({{"qty", i}, {"status", std::string(i % 2 ? "open" : "done")}});
+    }
+    manager.importEntries(rows);
+
+    EntryFilter filter;
+    std::string error;
+    ASSERT_FALSE(EntryFilter::parse(*formDef, "missing = 1", filter, error));
+    ASSERT_TRUE(EntryFilter::parse(*formDef, "2001-4000 and status = 2", filter, error)) << error;
+    EXPECT_EQ(manager.removeEntries([&filter](const Entry& entry) { return filter.matches(entry); }), 1000u);
+
+    auto snapshot = manager.getEntries();
+    ASSERT_EQ(snapshot->size(), 4000u);
+    EXPECT_EQ((*snapshot)[3999].key, 4000); // Renumbered
+    EXPECT_EQ(std::get<int>((*snapshot)[2000].data.at("qty")), 2001);
+    EXPECT_EQ(std::get<int>((*snapshot)[2001].data.at("qty")), 2003);
+
+    ASSERT_TRUE(EntryFilter::parse(*formDef, "qty >= 4990", filter, error)) << error;
+    size_t updated = manager.updateEntries([&filter](const Entry& entry) { return filter.matches(entry); },
+                                           {{"status", std::string("done")}});
+    EXPECT_EQ(updated, 11u);
+    EXPECT_EQ(manager.getEntries()->getSegments()[0], snapshot->getSegments()[0]); // Untouched segments are shared
+    EXPECT_EQ(std::get<std::string>((*manager.getEntries())[3999].data.at("status")), "done");
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+#include "EntryManagerPool.h"
+#include "FormDefinition.h"
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+const char* const kFormNames[] = {"pool_test_a", "pool_test_b", "pool_test_c"};
+
+void removeStoredEntries() {
+    for (const char* formName : kFormNames) {
+        std::filesystem::remove_all(EntryManager::entriesDirectoryFor(formName));
+    }
+}
+
+} // namespace
+
+TEST(EntryManagerPoolTest, SharesOneManagerPerForm) {
+    removeStoredEntries();
+    EntryManagerPool pool;
+    auto first = pool.acquire(kFormNames[0]);
+    EXPECT_EQ(pool.acquire(kFormNames[0]), first);
+    EXPECT_NE(pool.acquire(kFormNames[1]), first);
+    EXPECT_EQ(pool.size(), 2u);
+
+    std::vector<std::shared_ptr<EntryManager>> seen(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([&pool, &seen, i]() { seen[i] = pool.acquire(kFormNames[2]); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& manager : seen) {
+        EXPECT_EQ(manager, seen[0]);
+    }
+    EXPECT_EQ(pool.size(), 3u);
+
+    // A hit picks up what another process saved since the manager was loaded
+    EntryManager other(kFormNames[0]);
+    ASSERT_EQ(other.insertEntry({{"value", 1}}), 1);
+    EXPECT_EQ(pool.acquire(kFormNames[0]), first);
+    EXPECT_EQ(first->getEntries()->size(), 1u);
+    removeStoredEntries();
+}
+
+TEST(EntryManagerPoolTest, EvictsLeastRecentlyUsedManagers) {
+    removeStoredEntries();
+    EntryManagerPool pool(2);
+    auto a = pool.acquire(kFormNames[0]);
+    auto b = pool.acquire(kFormNames[1]);
+    EXPECT_EQ(pool.acquire(kFormNames[0]), a); // Now more recently used than b
+    pool.acquire(kFormNames[2]);
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.acquire(kFormNames[0]), a);
+    EXPECT_NE(pool.acquire(kFormNames[1]), b); // b was evicted and is opened again
+    EXPECT_EQ(b.use_count(), 1); // The caller's reference keeps an evicted manager alive
+
+    // Over the memory budget everything but the most recently used manager goes
+    ASSERT_GT(pool.acquire(kFormNames[0])->insertEntry({{"value", 1}}), 0);
+    pool.setLimits(8, 1);
+    EXPECT_EQ(pool.size(), 1u);
+    EXPECT_EQ(pool.acquire(kFormNames[0]), a);
+
+    pool.evict(kFormNames[0]);
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_NE(pool.acquire(kFormNames[0]), a);
+    removeStoredEntries();
+}
+
+TEST(EntryManagerPoolTest, ReplacesManagerWhenTheSchemaChanges) {
+    removeStoredEntries();
+    std::istringstream originalText("string:title\n");
+    std::istringstream changedText("string:title\nnumber:qty:int\n");
+    auto original = FormDefinition::loadFromStream(originalText, kFormNames[0]);
+    auto changed = FormDefinition::loadFromStream(changedText, kFormNames[0]);
+    EntryManagerPool pool;
+    auto manager = pool.acquire(kFormNames[0], original);
+    EXPECT_EQ(pool.acquire(kFormNames[0], original), manager);
+    EXPECT_EQ(pool.acquire(kFormNames[0]), manager); // No definition given: whatever is resident
+    auto replaced = pool.acquire(kFormNames[0], changed);
+    EXPECT_NE(replaced, manager);
+    EXPECT_EQ(pool.size(), 1u);
+    removeStoredEntries();
+}
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+#include "EntryReader.h"
+#include "MappedEntrySource.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+#include <sstream>
+#include <fstream>
+#include <cstdio> // For std::remove
+
+TEST(EntryReaderTest, ParallelReadMatchesSequential) {
+    const std::string path = "entry_reader_test.dat";
+    {
+        std::ofstream outFile(path);
+        for (int key = 1; outFile.tellp() < (std::streamoff)(3 * kParallelReadMinBytes); ++key) {
+            outFile << "KEY:" << key << "\nname:string:row " << key << "\nvalue:int:" << key * 3 << "\n---\n";
+        }
+    }
+
+    std::vector<Entry> sequential;
+    std::vector<Entry> parallel;
+    ASSERT_TRUE(readEntriesFile(path, sequential, 1));
+    ASSERT_TRUE(readEntriesFile(path, parallel, 7)); // Range boundaries land mid-record
+    ASSERT_EQ(parallel.size(), sequential.size());
+    for (size_t i = 0; i < sequential.size(); ++i) {
+        ASSERT_EQ(parallel[i].key, (int)i + 1);
+        ASSERT_EQ(parallel[i].data, sequential[i].data);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(EntryReaderTest, MalformedKeyFailsTheReadInsteadOfThrowing) {
+    const std::string path = "entry_reader_malformed_test.dat";
+    {
+        std::ofstream outFile(path);
+        for (int key = 1; outFile.tellp() < (std::streamoff)(3 * kParallelReadMinBytes); ++key) {
+            outFile << "KEY:" << (key == 20000 ? std::string("2x") : std::to_string(key)) << "\nvalue:int:" << key << "\n---\n";
+        }
+        outFile << "KEY:99999999999\n---\n"; // Out of int range
+    }
+
+    std::vector<Entry> rows;
+    EXPECT_FALSE(readEntriesFile(path, rows, 1));
+    rows.clear();
+    EXPECT_FALSE(readEntriesFile(path, rows, 7)); // Reported from a worker thread
+
+    EntryFileReader reader(path);
+    Entry entry(0);
+    size_t count = 0;
+    while (reader.next(entry)) {
+        ++count;
+    }
+    EXPECT_EQ(count, 19999u); // Stops at the corrupt record
+    EXPECT_TRUE(reader.hasMalformedKey());
+    std::remove(path.c_str());
+}
+
+TEST(EntryReaderTest, MappedSourceMatchesPartitionedReader) {
+    const char* formName = "mapped_source_test";
+    std::stringstream formText("string:name\nnumber:int:count\ntimestamp:at\n");
+    auto formDef = FormDefinition::loadFromStream(formText, formName);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(formName));
+    {
+        EntryManager manager(formName, formDef);
+        std::vector<std::map<std::string, FieldValue>> rows;
+        for (int i = 0; i < 2500; ++i) {
+            rows.push_back({{"name", std::string("row \"") + std::to_string(i) + "\""}, {"count", i * 7}});
+            if (i % 2) {
+                rows.back()["at"] = Timestamp{1700000000000LL + i};
+            }
+        }
+        manager.importEntries(rows);
+    }
+
+    MappedEntrySource mapped(formName, *formDef);
+    ASSERT_TRUE(mapped.isUsable());
+    PartitionedEntryReader reader(formName);
+    Entry expected(0);
+    EntryView view;
+    size_t count = 0;
+    while (reader.next(expected)) {
+        ASSERT_TRUE(mapped.nextView(view));
+        ASSERT_EQ(view.key, expected.key);
+        ASSERT_EQ(view.fields.size(), expected.data.size());
+        EXPECT_EQ(std::get<std::string_view>(*view.find("name")), std::get<std::string>(expected.data.at("name")));
+        EXPECT_EQ(std::get<int>(*view.find("count")), std::get<int>(expected.data.at("count")));
+        EXPECT_EQ(view.find("at") != nullptr, expected.data.count("at") == 1);
+        ++count;
+    }
+    EXPECT_FALSE(mapped.nextView(view));
+    EXPECT_EQ(count, 2500u);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(formName));
+}
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+#include "Entry.h"
+#include "EntrySnapshot.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+
+namespace {
+
+EntrySnapshotPtr makeSnapshot(int count) {
+    std::vector<Entry> rows;
+    for (int i = 1; i <= count; ++i) {
+        rows.emplace_back(i);
+        rows.back().data["value"] = i;
+    }
+    return EntrySnapshot::fromEntries(std::move(rows), 0);
+}
+
+} // namespace
+
+TEST(EntrySnapshotTest, AppendSharesFullSegments) {
+    auto base = makeSnapshot(EntrySnapshot::kSegmentCapacity + 10);
+    Entry extra(base->size() + 1);
+    auto next = base->withAppended(extra);
+
+    ASSERT_EQ(next->size(), base->size() + 1);
+    EXPECT_EQ(base->size(), EntrySnapshot::kSegmentCapacity + 10); // Old snapshot unchanged
+    EXPECT_EQ(next->getSegments()[0], base->getSegments()[0]);     // Full segment shared
+    EXPECT_NE(next->getSegments()[1], base->getSegments()[1]);     // Tail segment copied
+    EXPECT_EQ(next->getVersion(), base->getVersion() + 1);
+}
+
+TEST(EntrySnapshotTest, ReplaceLeavesReadersUntouched) {
+    auto base = makeSnapshot(20);
+    Entry changed = (*base)[4];
+    changed.data["value"] = 500;
+    auto next = base->withReplaced(4, changed);
+
+    EXPECT_EQ(std::get<int>((*base)[4].data.at("value")), 5);
+    EXPECT_EQ(std::get<int>((*next)[4].data.at("value")), 500);
+}
+
+TEST(EntrySnapshotTest, TailReplacementKeepsPrefixSegments) {
+    auto base = makeSnapshot(3 * EntrySnapshot::kSegmentCapacity);
+    std::vector<Entry> tail(base->begin() + 2 * EntrySnapshot::kSegmentCapacity, base->end() - 1);
+    auto next = base->withTailReplaced(2, std::move(tail));
+
+    EXPECT_EQ(next->size(), base->size() - 1);
+    EXPECT_EQ(next->getSegments()[1], base->getSegments()[1]);
+    EXPECT_EQ(next->findIndexByKey(5), 4);
+    EXPECT_EQ(next->findIndexByKey((int)base->size()), -1);
+}
+
+TEST(EntrySnapshotTest, ReadersSeeConsistentSnapshotsWhileWriting) {
+    const char* formName = "entry_snapshot_concurrency_test";
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(formName));
+    EntryManager manager(formName);
+    std::atomic<bool> writing(true);
+
+    // Appends ever larger values and deletes the oldest row, so every snapshot must hold dense
+    // keys 1..n with strictly increasing values
+    std::thread writer([&]() {
+        for (int value = 1; value <= 300; ++value) {
+            manager.insertEntry({{"value", value}});
+            if (value % 3 == 0) {
+                manager.removeEntry(1);
+            }
+        }
+        writing = false;
+    });
+
+    size_t snapshotsChecked = 0;
+    uint64_t lastVersion = 0;
+    bool consistent = true;
+    while (writing || snapshotsChecked == 0) {
+        auto snapshot = manager.getEntries();
+        consistent = consistent && snapshot->getVersion() >= lastVersion;
+        lastVersion = snapshot->getVersion();
+        int previous = 0;
+        for (size_t i = 0; i < snapshot->size(); ++i) {
+            const Entry& entry = (*snapshot)[i];
+            int value = std::get<int>(entry.data.at("value"));
+            consistent = consistent && entry.key == (int)i + 1 && value > previous;
+            previous = value;
+        }
+        ++snapshotsChecked;
+    }
+    writer.join();
+
+    EXPECT_TRUE(consistent);
+    EXPECT_GT(snapshotsChecked, 1u);
+    auto last = manager.getEntries();
+    ASSERT_EQ(last->size(), 200u);
+    EXPECT_EQ(std::get<int>((*last)[0].data.at("value")), 101);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(formName));
+}
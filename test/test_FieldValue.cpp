@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include "FieldValue.h"
+#include <string>
+#include <type_traits> // For std::is_same_v
+
+namespace {
+
+// Value 'visitField<Kind>' handed to its visitor, or 'fallback' when it did not call it
+template <FieldKind Kind>
+typename FieldKindTraits<Kind>::Type visited(const FieldValue& value, typename FieldKindTraits<Kind>::Type fallback) {
+    typename FieldKindTraits<Kind>::Type seen = fallback;
+    bool called = false;
+    bool returned = visitField<Kind>(value, [&seen, &called](const auto& typed) {
+        static_assert(std::is_same_v<std::decay_t<decltype(typed)>, typename FieldKindTraits<Kind>::Type>,
+                      "visitField passes the traits type");
+        seen = typed;
+        called = true;
+    });
+    EXPECT_EQ(returned, called);
+    return seen;
+}
+
+} // namespace
+
+TEST(FieldValueTest, VisitFieldString) {
+    EXPECT_EQ(visited<FieldKind::String>(FieldValue(std::string("caf\xC3\xA9")), ""), "caf\xC3\xA9");
+    EXPECT_EQ(visited<FieldKind::String>(FieldValue(7), "none"), "none");
+    EXPECT_FALSE(visitField<FieldKind::String>(FieldValue(7), [](const std::string&) {}));
+}
+
+TEST(FieldValueTest, VisitFieldInt) {
+    EXPECT_EQ(visited<FieldKind::Int>(FieldValue(-42), 0), -42);
+    EXPECT_EQ(visited<FieldKind::Int>(FieldValue(3.5), 0), 0); // A double is not widened or narrowed
+    EXPECT_FALSE(visitField<FieldKind::Int>(FieldValue(std::string("42")), [](int) {}));
+}
+
+TEST(FieldValueTest, VisitFieldFloat) {
+    EXPECT_EQ(visited<FieldKind::Float>(FieldValue(1.25f), 0.0f), 1.25f);
+    EXPECT_EQ(visited<FieldKind::Float>(FieldValue(1.25), 0.0f), 0.0f);
+    EXPECT_FALSE(visitField<FieldKind::Float>(FieldValue(1), [](float) {}));
+}
+
+TEST(FieldValueTest, VisitFieldDouble) {
+    EXPECT_EQ(visited<FieldKind::Double>(FieldValue(0.1), 0.0), 0.1);
+    EXPECT_EQ(visited<FieldKind::Double>(FieldValue(0.5f), 0.0), 0.0);
+    EXPECT_FALSE(visitField<FieldKind::Double>(FieldValue(Timestamp{5}), [](double) {}));
+}
+
+TEST(FieldValueTest, VisitFieldTimestamp) {
+    EXPECT_EQ(visited<FieldKind::Timestamp>(FieldValue(Timestamp{1700000000000}), Timestamp{}), Timestamp{1700000000000});
+    EXPECT_EQ(visited<FieldKind::Timestamp>(FieldValue(1700000000), Timestamp{-1}), Timestamp{-1}); // Raw numbers are not times
+    EXPECT_FALSE(visitField<FieldKind::Timestamp>(FieldValue(std::string("2023-11-14")), [](Timestamp) {}));
+}
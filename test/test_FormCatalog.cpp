@@ -0,0 +1,96 @@
+#include "gtest/gtest.h"
+#include "FormCatalog.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+const std::string kFormsDir = "form_catalog_test/";
+
+void writeForm(const std::string& fileName, const std::string& text) {
+    std::ofstream(kFormsDir + fileName) << text;
+}
+
+} // namespace
+
+TEST(FormCatalogTest, IndexDefersParsingUntilAFormIsOpened) {
+    std::filesystem::remove_all(kFormsDir);
+    std::filesystem::create_directories(kFormsDir);
+    writeForm("rules.form", "string:code\n  rule:bogus\n");
+    writeForm("plain.form", "string:title\nnumber:qty:int\n");
+    {
+        FormCatalog catalog(kFormsDir);
+        ASSERT_EQ(catalog.listForms(), (std::vector<std::string>{"plain.form", "rules.form"}));
+        testing::internal::CaptureStderr();
+        ASSERT_TRUE(catalog.getForm("rules.form"));
+        EXPECT_FALSE(testing::internal::GetCapturedStderr().empty()); // The unknown rule is reported
+        ASSERT_TRUE(catalog.getForm("plain.form"));
+    }
+    ASSERT_TRUE(std::filesystem::exists(kFormsDir + ".catalog.idx"));
+
+    // A cold start reads the index without parsing, so rule warnings wait until the form is opened
+    FormCatalog catalog(kFormsDir);
+    testing::internal::CaptureStderr();
+    EXPECT_EQ(catalog.listForms().size(), 2u);
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+    auto plain = catalog.getForm("plain.form");
+    ASSERT_TRUE(plain);
+    ASSERT_EQ(plain->fields.size(), 2u);
+    EXPECT_EQ(plain->fields[1]->name, "qty");
+    EXPECT_EQ(catalog.getForm("plain.form"), plain); // Parsed once, then shared
+    EXPECT_EQ(catalog.getForm("missing.form"), nullptr);
+    std::filesystem::remove_all(kFormsDir);
+}
+
+TEST(FormCatalogTest, ChangesOnDiskInvalidateCachedDefinitions) {
+    std::filesystem::remove_all(kFormsDir);
+    std::filesystem::create_directories(kFormsDir);
+    writeForm("a.form", "string:title\n");
+    writeForm("b.form", "string:title\n");
+    FormCatalog catalog(kFormsDir);
+    ASSERT_EQ(catalog.listForms().size(), 2u);
+    auto before = catalog.getForm("a.form");
+    ASSERT_EQ(before->fields.size(), 1u);
+
+    // Picked up from the watcher's events (or a rescan where there is no inotify)
+    writeForm("a.form", "string:title\nstring:note\n");
+    writeForm("c.form", "string:title\n");
+    std::filesystem::remove(kFormsDir + "b.form");
+    EXPECT_EQ(catalog.listForms(), (std::vector<std::string>{"a.form", "c.form"}));
+    auto after = catalog.getForm("a.form");
+    ASSERT_TRUE(after);
+    EXPECT_NE(after, before);
+    EXPECT_EQ(after->fields.size(), 2u);
+    EXPECT_EQ(catalog.getForm("b.form"), nullptr);
+
+    EXPECT_TRUE(catalog.removeForm("c.form"));
+    EXPECT_FALSE(std::filesystem::exists(kFormsDir + "c.form"));
+    EXPECT_EQ(catalog.listForms(), (std::vector<std::string>{"a.form"}));
+    std::filesystem::remove_all(kFormsDir);
+}
+
+TEST(FormCatalogTest, ConcurrentLookupsShareOneDefinition) {
+    std::filesystem::remove_all(kFormsDir);
+    std::filesystem::create_directories(kFormsDir);
+    writeForm("shared.form", "string:title\n");
+    FormCatalog catalog(kFormsDir);
+    std::vector<std::shared_ptr<FormDefinition>> seen(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([&catalog, &seen, i]() {
+            for (int round = 0; round < 50; ++round) {
+                catalog.listForms();
+                seen[i] = catalog.getForm("shared.form");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& definition : seen) {
+        ASSERT_TRUE(definition);
+        EXPECT_EQ(definition, seen[0]);
+    }
+    std::filesystem::remove_all(kFormsDir);
+}
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+#include "FormStats.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+const char* kFormName = "form_stats_test";
+
+const FormStats::ColumnStats* findColumn(const FormStats& stats, const std::string& name) {
+    for (const auto& column : stats.columns) {
+        if (column.name == name) {
+            return &column;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(FormStatsTest, CountsColumnsTypesAndIndexes) {
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    EntryManager manager(kFormName);
+    const std::string longText(100, 'x'); // Past the small string buffer, so it is heap allocated
+    manager.insertEntry({{"title", std::string("a")}, {"qty", 1}, {"price", 1.5}, {"due", Timestamp{1000}}});
+    manager.insertEntry({{"title", longText}, {"qty", 2}, {"price", 2.5}, {"due", Timestamp{2000}}, {"note", std::string("n")}});
+    manager.insertEntry({{"title", std::string("c")}, {"qty", 3}, {"price", 3.5}, {"due", Timestamp{3000}}, {"note", std::string("m")}});
+    auto snapshot = manager.getEntries();
+    ASSERT_TRUE(manager.getTimestampIndex(snapshot, "due"));
+
+    FormStats stats = manager.computeStats();
+    EXPECT_EQ(stats.entryCount, 3u);
+    ASSERT_EQ(stats.columns.size(), 5u);
+    const FormStats::ColumnStats* title = findColumn(stats, "title");
+    const FormStats::ColumnStats* qty = findColumn(stats, "qty");
+    const FormStats::ColumnStats* note = findColumn(stats, "note");
+    ASSERT_TRUE(title && qty && note && findColumn(stats, "price") && findColumn(stats, "due"));
+    EXPECT_EQ(title->type, "string");
+    EXPECT_EQ(qty->type, "int");
+    EXPECT_EQ(findColumn(stats, "price")->type, "double");
+    EXPECT_EQ(findColumn(stats, "due")->type, "timestamp");
+    EXPECT_EQ(title->values, 3u);
+    EXPECT_EQ(note->values, 2u); // Only rows that have the field
+    EXPECT_GE(title->stringHeapBytes, longText.size());
+    EXPECT_EQ(qty->stringHeapBytes, 0u);
+    EXPECT_EQ(stats.stringHeapBytes, title->stringHeapBytes);
+
+    EXPECT_EQ(stats.types.at("string").values, 5u);
+    EXPECT_EQ(stats.types.at("int").values, 3u);
+    EXPECT_EQ(stats.types.at("double").values, 3u);
+    EXPECT_EQ(stats.types.at("timestamp").values, 3u);
+    EXPECT_EQ(stats.types.at("int").bytes, qty->bytes);
+    size_t columnBytes = 0;
+    for (const auto& column : stats.columns) {
+        columnBytes += column.bytes;
+    }
+    EXPECT_EQ(stats.totalBytes, stats.entryOverheadBytes + columnBytes);
+    EXPECT_EQ(stats.entryOverheadBytes, 3 * sizeof(Entry));
+
+    EXPECT_GT(stats.indexBytes.at("snapshot segments"), 0u);
+    EXPECT_EQ(stats.indexBytes.at("partition manifest"), sizeof(PartitionInfo));
+    EXPECT_EQ(stats.indexBytes.at("timestamp index (due)"), manager.getTimestampIndex(snapshot, "due")->memoryBytes());
+    EXPECT_EQ(stats.indexBytes.count("dedup hash set"), 0u); // Uniqueness is off
+    EXPECT_GT(stats.fileBytes, 0u);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
+
+TEST(FormStatsTest, ShowFormStatsLeavesStdCoutFormattingAlone) {
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    std::istringstream formText("string:title\nnumber:price:double\n");
+    auto formDef = FormDefinition::loadFromStream(formText, kFormName);
+    auto previousForm = std::atomic_load(&currentSelectedForm);
+    std::atomic_store(&currentSelectedForm, formDef);
+
+    std::ostringstream captured;
+    std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+    std::ios_base::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    showFormStats();
+    std::cout << 0.125;
+    std::cout.rdbuf(original);
+    std::atomic_store(&currentSelectedForm, previousForm);
+
+    EXPECT_NE(captured.str().find("Last load:"), std::string::npos);
+    EXPECT_EQ(std::cout.flags(), flags);
+    EXPECT_EQ(std::cout.precision(), precision);
+    EXPECT_EQ(captured.str().substr(captured.str().size() - 5), "0.125"); // Not "0.13"
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+#include "Instrumentation.h"
+#include "JsonValue.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstdio> // For std::remove
+
+namespace {
+
+struct SummaryRow {
+    uint64_t count = 0;
+    double totalMs = 0.0;
+};
+
+// Reads the COUNT and TOTAL ms columns of an operation, or the VALUE of a counter, from instrumentationSummary()
+bool findSummaryRow(const std::string& summary, const std::string& name, SummaryRow& row) {
+    std::istringstream lines(summary);
+    std::string line;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        std::string first;
+        if (fields >> first && first == name) {
+            if (!(fields >> row.count)) {
+                return false;
+            }
+            fields >> row.totalMs; // Counter rows have no total
+            return true;
+        }
+    }
+    return false;
+}
+
+void sleepBriefly() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+} // namespace
+
+TEST(InstrumentationTest, NestedScopesReachSummaryAndChromeTrace) {
+    const std::string tracePath = "instrumentation_test_trace.json";
+    resetInstrumentation();
+    ASSERT_FALSE(configureInstrumentation("bogus"));
+    ASSERT_TRUE(configureInstrumentation("chrome:" + tracePath));
+    for (int i = 0; i < 3; ++i) {
+        TRACE_SCOPE("test.outer");
+        sleepBriefly(); // Keeps each inner scope strictly inside its outer one at microsecond resolution
+        for (int j = 0; j < 2; ++j) {
+            TRACE_SCOPE("test.inner");
+        }
+        sleepBriefly();
+    }
+    recordCounter("test.counter", 2);
+    recordCounter("test.counter", 3);
+    setInstrumentationEnabled(false);
+    {
+        TRACE_SCOPE("test.disabled");
+    }
+    recordCounter("test.counter", 100);
+
+    std::string summary = instrumentationSummary();
+    SummaryRow outer, inner, counter;
+    ASSERT_TRUE(findSummaryRow(summary, "test.outer", outer)) << summary;
+    ASSERT_TRUE(findSummaryRow(summary, "test.inner", inner)) << summary;
+    EXPECT_EQ(outer.count, 3u);
+    EXPECT_EQ(inner.count, 6u);
+    EXPECT_GE(outer.totalMs, 6.0); // Two pauses per outer scope
+    EXPECT_GE(outer.totalMs, inner.totalMs);
+    EXPECT_FALSE(findSummaryRow(summary, "test.disabled", counter));
+    ASSERT_TRUE(findSummaryRow(summary, "test.counter", counter));
+    EXPECT_EQ(counter.count, 5u); // The VALUE column
+
+    testing::internal::CaptureStderr();
+    flushInstrumentation();
+    testing::internal::GetCapturedStderr();
+    std::ifstream traceFile(tracePath);
+    std::stringstream text;
+    text << traceFile.rdbuf();
+    JsonValue trace;
+    std::string error;
+    ASSERT_TRUE(parseJson(text.str(), trace, error)) << error;
+    const JsonValue* events = trace.get("traceEvents");
+    ASSERT_TRUE(events && events->type == JsonValue::Type::Array);
+
+    std::vector<const JsonValue*> outers, inners;
+    std::vector<double> counterValues;
+    for (const JsonValue& event : events->array) {
+        const std::string& name = event.get("name")->string;
+        const std::string& phase = event.get("ph")->string;
+        if (phase == "X") {
+            ASSERT_GE(event.get("dur")->number, 0);
+            (name == "test.outer" ? outers : inners).push_back(&event);
+        } else if (phase == "C") {
+            counterValues.push_back(event.get("args")->get("value")->number);
+        }
+    }
+    ASSERT_EQ(outers.size(), 3u);
+    ASSERT_EQ(inners.size(), 6u);
+    EXPECT_EQ(counterValues, (std::vector<double>{2, 5}));
+
+    // Every inner event begins and ends inside exactly one outer event on the same thread
+    for (const JsonValue* innerEvent : inners) {
+        double start = innerEvent->get("ts")->number;
+        double end = start + innerEvent->get("dur")->number;
+        int enclosing = 0;
+        for (const JsonValue* outerEvent : outers) {
+            double outerStart = outerEvent->get("ts")->number;
+            double outerEnd = outerStart + outerEvent->get("dur")->number;
+            if (outerStart <= start && end <= outerEnd && outerEvent->get("tid")->number == innerEvent->get("tid")->number) {
+                ++enclosing;
+            }
+        }
+        EXPECT_EQ(enclosing, 1);
+    }
+
+    resetInstrumentation(); // Nothing left for the exit-time flush to write
+    traceFile.close();
+    std::remove(tracePath.c_str());
+}
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+#include "JsonValue.h"
+
+TEST(JsonValueTest, ParsesNestedDocuments) {
+    JsonValue value;
+    std::string error;
+    ASSERT_TRUE(parseJson(" {\"op\":\"add\",\"data\":{\"qty\":3,\"price\":-2.5e1,\"tags\":[true,false,null,[]]},\"empty\":{}} ", value, error)) << error;
+    ASSERT_TRUE(value.isObject());
+    EXPECT_EQ(value.get("op")->string, "add");
+    EXPECT_EQ(value.get("missing"), nullptr);
+
+    const JsonValue* data = value.get("data");
+    ASSERT_TRUE(data && data->isObject());
+    EXPECT_EQ(data->get("qty")->number, 3);
+    EXPECT_TRUE(data->get("qty")->isInteger);
+    EXPECT_EQ(data->get("price")->number, -25);
+    EXPECT_FALSE(data->get("price")->isInteger);
+
+    const JsonValue* tags = data->get("tags");
+    ASSERT_EQ(tags->type, JsonValue::Type::Array);
+    ASSERT_EQ(tags->array.size(), 4u);
+    EXPECT_TRUE(tags->array[0].boolean);
+    EXPECT_FALSE(tags->array[1].boolean);
+    EXPECT_TRUE(tags->array[2].isNull());
+    EXPECT_TRUE(tags->array[3].array.empty());
+    EXPECT_TRUE(value.get("empty")->object.empty());
+}
+
+TEST(JsonValueTest, DecodesEscapes) {
+    JsonValue value;
+    std::string error;
+    ASSERT_TRUE(parseJson("\"a\\\"b\\\\c\\/d\\n\\t\\u00e9\\u20AC\\ud83d\\ude00\"", value, error)) << error;
+    EXPECT_EQ(value.string, "a\"b\\c/d\n\t\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+}
+
+TEST(JsonValueTest, RejectsMalformedInput) {
+    const char* malformed[] = {
+        "", "{", "{\"a\":1,}", "{\"a\" 1}", "{a:1}", "[1 2]", "[1,", "\"open", "\"bad\\q\"",
+        "\"\\u12\"", "\"\\uZZZZ\"", "\"\\ud83d\\u0041\"", "tru", "nul", "-", "1.2.3", "{} {}", "[]x",
+    };
+    for (const char* text : malformed) {
+        JsonValue value;
+        std::string error;
+        EXPECT_FALSE(parseJson(text, value, error)) << text;
+        EXPECT_FALSE(error.empty()) << text;
+    }
+
+    std::string deep(100, '[');
+    JsonValue value;
+    std::string error;
+    EXPECT_FALSE(parseJson(deep + std::string(100, ']'), value, error));
+    EXPECT_NE(error.find("Nesting too deep"), std::string::npos);
+}
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+
+namespace {
+
+const char* kFormName = "operation_log_test";
+
+std::vector<std::pair<int, int>> keysAndValues(const EntrySnapshot& snapshot) {
+    std::vector<std::pair<int, int>> rows;
+    for (const Entry& entry : snapshot) {
+        rows.emplace_back(entry.key, std::get<int>(entry.data.at("n")));
+    }
+    return rows;
+}
+
+} // namespace
+
+TEST(OperationLogTest, UndoRedoAndSnapshotRestore) {
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    auto formDef = std::make_shared<FormDefinition>();
+    formDef->name = kFormName;
+    formDef->fields.push_back(std::make_shared<NumberField>("n", "int"));
+    {
+        EntryManager manager(kFormName, formDef);
+        std::vector<std::map<std::string, FieldValue>> rows;
+        for (int i = 1; i <= 3000; ++i) {
+            rows.push_back({{"n", i}});
+        }
+        manager.importEntries(rows);
+        auto original = manager.getEntries();
+        manager.saveSnapshot("imported");
+
+        manager.insertEntry({{"n", 9001}});
+        manager.updateEntry(10, {{"n", -10}});
+        manager.removeEntries([](const Entry& entry) { return std::get<int>(entry.data.at("n")) % 7 == 0; });
+        ASSERT_TRUE(manager.removeEntry(5));
+        auto edited = manager.getEntries();
+        EXPECT_EQ(manager.getUndoDepth(), 5u);
+
+        // Back past every write to the imported rows with their original keys
+        std::string label;
+        ASSERT_TRUE(manager.undo(&label));
+        EXPECT_EQ(label, "delete 5");
+        while (manager.getUndoDepth() > 1) {
+            ASSERT_TRUE(manager.undo());
+        }
+        EXPECT_EQ(keysAndValues(*manager.getEntries()), keysAndValues(*original));
+        ASSERT_TRUE(manager.undo(&label));
+        EXPECT_EQ(label, "import 3000 entries");
+        EXPECT_TRUE(manager.getEntries()->empty());
+        EXPECT_FALSE(manager.undo());
+
+        while (manager.redo()) {
+        }
+        EXPECT_EQ(keysAndValues(*manager.getEntries()), keysAndValues(*edited));
+
+        // A restore shares the snapshot's segments instead of copying rows, and can itself be undone
+        ASSERT_TRUE(manager.restoreSnapshot("imported"));
+        EXPECT_EQ(manager.getEntries()->getSegments(), original->getSegments());
+        EXPECT_FALSE(manager.restoreSnapshot("missing"));
+        ASSERT_TRUE(manager.undo(&label));
+        EXPECT_EQ(label, "restore imported");
+        EXPECT_EQ(keysAndValues(*manager.getEntries()), keysAndValues(*edited));
+        EXPECT_EQ(manager.getApproximateMemoryUsage(), EntryManager(kFormName, formDef).getApproximateMemoryUsage());
+
+        // A new write drops the redo stack; the memory bound keeps only the newest operation
+        ASSERT_TRUE(manager.redo());
+        manager.insertEntry({{"n", 1}});
+        EXPECT_EQ(manager.getRedoDepth(), 0u);
+        manager.setUndoLimits(100, 1);
+        EXPECT_EQ(manager.getUndoDepth(), 1u);
+    }
+    // Undo and restore persisted their results
+    EntryManager reloaded(kFormName, formDef);
+    EXPECT_EQ(reloaded.getEntries()->size(), 3001u);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
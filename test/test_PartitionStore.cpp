@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+#include "PartitionStore.h"
+#include "Entry.h"
+#include <filesystem>
+#include <vector>
+
+namespace {
+
+const char* kFormName = "partition_store_test";
+
+EntrySnapshotPtr makeSnapshot(size_t count) {
+    std::vector<Entry> rows;
+    for (size_t i = 1; i <= count; ++i) {
+        rows.emplace_back((int)i);
+        rows.back().data["value"] = (int)i;
+    }
+    return EntrySnapshot::fromEntries(std::move(rows), 0);
+}
+
+} // namespace
+
+TEST(PartitionStoreTest, RewritesOnlyChangedPartitions) {
+    std::filesystem::remove_all(PartitionStore::directoryFor(kFormName));
+    PartitionStore store(kFormName);
+    auto snapshot = makeSnapshot(PartitionStore::kRowsPerPartition * 2 + 10);
+    ASSERT_TRUE(store.save(snapshot));
+    PartitionManifest first = store.getManifest();
+    ASSERT_EQ(first.partitions.size(), 3u);
+
+    Entry changed = (*snapshot)[PartitionStore::kRowsPerPartition + 5];
+    changed.data["value"] = -1;
+    ASSERT_TRUE(store.save(snapshot->withReplaced(PartitionStore::kRowsPerPartition + 5, changed)));
+    PartitionManifest second = store.getManifest();
+    EXPECT_EQ(second.partitions[0].fileName, first.partitions[0].fileName);
+    EXPECT_NE(second.partitions[1].fileName, first.partitions[1].fileName);
+    EXPECT_EQ(second.partitions[2].fileName, first.partitions[2].fileName);
+    EXPECT_FALSE(std::filesystem::exists(store.getDirectory() + "/" + first.partitions[1].fileName));
+
+    PartitionStore reopened(kFormName);
+    std::vector<Entry> rows;
+    bool needsMigration = true;
+    ASSERT_TRUE(reopened.load(rows, needsMigration));
+    EXPECT_FALSE(needsMigration);
+    ASSERT_EQ(rows.size(), snapshot->size());
+    EXPECT_EQ(std::get<int>(rows[PartitionStore::kRowsPerPartition + 5].data.at("value")), -1);
+    std::filesystem::remove_all(PartitionStore::directoryFor(kFormName));
+}
+
+TEST(PartitionStoreTest, ReaderReloadsOnlyChangedPartitions) {
+    std::filesystem::remove_all(PartitionStore::directoryFor(kFormName));
+    std::vector<std::map<std::string, FieldValue>> rows(PartitionStore::kRowsPerPartition * 2 + 10);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        rows[i]["value"] = (int)i;
+    }
+    EntryManager writer(kFormName);
+    writer.importEntries(rows);
+
+    // A second manager on the same directory stands in for another process
+    EntryManager reader(kFormName);
+    auto before = reader.getEntries();
+    EXPECT_FALSE(reader.reloadIfChanged());
+    ASSERT_TRUE(writer.updateEntry(PartitionStore::kRowsPerPartition + 5, {{"value", -1}}));
+    ASSERT_TRUE(writer.insertEntry({{"value", 7}}) > 0);
+
+    ASSERT_TRUE(reader.reloadIfChanged());
+    auto after = reader.getEntries();
+    ASSERT_EQ(after->size(), rows.size() + 1);
+    EXPECT_EQ(after->getSegments()[0], before->getSegments()[0]); // First partition was not read again
+    EXPECT_NE(after->getSegments()[PartitionStore::kSegmentsPerPartition], before->getSegments()[PartitionStore::kSegmentsPerPartition]);
+    EXPECT_EQ(std::get<int>((*after)[PartitionStore::kRowsPerPartition + 4].data.at("value")), -1);
+    EXPECT_EQ(reader.insertEntry({{"value", 8}}), (int)rows.size() + 2); // Keys continue after the other process's rows
+    std::filesystem::remove_all(PartitionStore::directoryFor(kFormName));
+}
+
+TEST(PartitionStoreTest, ConcurrentWritersDoNotLoseUpdates) {
+    std::filesystem::remove_all(PartitionStore::directoryFor(kFormName));
+    EntryManager first(kFormName);
+    EntryManager second(kFormName); // Stands in for another process that opened the form too
+    ASSERT_EQ(first.insertEntry({{"value", 1}}), 1);
+    ASSERT_EQ(second.insertEntry({{"value", 2}}), 2); // Picks up the first save before writing its own
+    ASSERT_TRUE(first.updateEntry(2, {{"value", 20}}));
+
+    // A store that saves over a generation it never read is refused instead of overwriting it
+    PartitionStore stale(kFormName);
+    EXPECT_FALSE(stale.save(makeSnapshot(1)));
+
+    EntryManager reopened(kFormName);
+    auto rows = reopened.getEntries();
+    ASSERT_EQ(rows->size(), 2u);
+    EXPECT_EQ(std::get<int>((*rows)[1].data.at("value")), 20);
+
+    // A missing partition fails the load rather than leaving a gap in the keys
+    PartitionManifest manifest;
+    ASSERT_TRUE(manifest.loadFromFile(PartitionStore::manifestPathFor(kFormName)));
+    std::filesystem::remove(PartitionStore::directoryFor(kFormName) + "/" + manifest.partitions[0].fileName);
+    PartitionStore broken(kFormName);
+    std::vector<Entry> loaded;
+    bool needsMigration = false;
+    EXPECT_FALSE(broken.load(loaded, needsMigration));
+    EXPECT_TRUE(loaded.empty());
+    EXPECT_FALSE(broken.save(makeSnapshot(1))); // Nor is the form then saved over
+    std::filesystem::remove_all(PartitionStore::directoryFor(kFormName));
+}
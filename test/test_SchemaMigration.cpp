@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include "SchemaMigration.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+
+namespace {
+
+const char* kFormName = "schema_migration_test";
+
+std::shared_ptr<FormDefinition> makeForm(const std::string& qtyType, bool withNote) {
+    auto formDef = std::make_shared<FormDefinition>();
+    formDef->name = kFormName;
+    formDef->fields.push_back(std::make_shared<StringField>("title"));
+    formDef->fields.push_back(std::make_shared<NumberField>("qty", qtyType));
+    if (withNote) {
+        formDef->fields.push_back(std::make_shared<StringField>("note"));
+    }
+    return formDef;
+}
+
+} // namespace
+
+TEST(SchemaMigrationTest, RowsFollowRetypedAndRemovedFields) {
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    auto original = makeForm("double", true);
+    {
+        EntryManager manager(kFormName, original);
+        std::vector<std::map<std::string, FieldValue>> rows;
+        for (int i = 1; i <= 3000; ++i) { // Several snapshot segments
+            rows.push_back({{"title", std::string("row")}, {"qty", i + 0.75}, {"note", std::string("x")}});
+        }
+        manager.importEntries(rows);
+    }
+
+    // "qty" becomes an int and "note" is dropped
+    auto changed = makeForm("int", false);
+    ASSERT_NE(schemaHashOf(*changed), schemaHashOf(*original));
+    EntryManager manager(kFormName, changed);
+    auto snapshot = manager.getEntries();
+    ASSERT_EQ(snapshot->size(), 3000u);
+    EXPECT_TRUE(snapshot->getSegments().back()->hasPendingMigration()); // Nothing converted until read
+    const Entry& last = (*snapshot)[2999];
+    EXPECT_EQ(std::get<int>(last.data.at("qty")), 3000);
+    EXPECT_EQ(last.data.count("note"), 0u);
+    EXPECT_FALSE(snapshot->getSegments().back()->hasPendingMigration());
+    EXPECT_TRUE(snapshot->getSegments().front()->hasPendingMigration());
+
+    manager.persist(true);
+    PartitionManifest manifest;
+    ASSERT_TRUE(manifest.loadFromFile(PartitionStore::manifestPathFor(kFormName)));
+    EXPECT_EQ(manifest.schemaHash, schemaHashOf(*changed));
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
+
+TEST(SchemaMigrationTest, ReloadMigratesAnotherProcessRows) {
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    auto original = makeForm("double", true);
+    auto changed = makeForm("int", false);
+    EntryManager oldWriter(kFormName, original); // Another process still on the old schema
+    EntryManager reader(kFormName, changed);
+    oldWriter.insertEntry({{"title", std::string("row")}, {"qty", 2.5}, {"note", std::string("x")}});
+
+    ASSERT_TRUE(reader.reloadIfChanged());
+    const Entry& row = (*reader.getEntries())[0];
+    EXPECT_EQ(std::get<int>(row.data.at("qty")), 2);
+    EXPECT_EQ(row.data.count("note"), 0u);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+#include "ServiceMode.h"
+#include "JsonValue.h"
+#include "Entry.h"
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+const char* kFormName = "service_mode_test";
+
+// Sends one request line and parses the response
+JsonValue request(const std::string& line) {
+    bool shutdownRequested = false;
+    JsonValue response;
+    std::string error;
+    EXPECT_TRUE(parseJson(handleServiceRequest(line, shutdownRequested), response, error)) << error;
+    EXPECT_FALSE(shutdownRequested);
+    return response;
+}
+
+bool succeeded(const JsonValue& response) {
+    const JsonValue* ok = response.get("ok");
+    return ok && ok->type == JsonValue::Type::Bool && ok->boolean;
+}
+
+} // namespace
+
+TEST(ServiceModeTest, RequestsRoundTripThroughTheForm) {
+    std::filesystem::create_directories("Forms");
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    {
+        std::ofstream formFile(std::string("Forms/") + kFormName + ".form");
+        formFile << "string:title\nnumber:qty:int\ntimestamp:due\nselect:status\n  option:1:open\n  option:2:done\n";
+    }
+    const std::string form = std::string("\"form\":\"") + kFormName + "\"";
+
+    JsonValue added = request("{\"id\":7,\"op\":\"add\"," + form + ",\"data\":{\"title\":\"caf\\u00e9\",\"qty\":3,\"due\":1700000000000,\"status\":2}}");
+    ASSERT_TRUE(succeeded(added)) << added.get("error")->string;
+    EXPECT_EQ(added.get("id")->number, 7);
+    EXPECT_EQ(added.get("key")->number, 1);
+
+    // Integer ids come back in full rather than in exponent notation
+    bool shutdownRequested = false;
+    EXPECT_EQ(handleServiceRequest("{\"id\":12345678,\"op\":\"ping\"}", shutdownRequested), "{\"id\":12345678,\"ok\":true}");
+    EXPECT_EQ(handleServiceRequest("{\"id\":9007199254740993,\"op\":\"ping\"}", shutdownRequested), "{\"id\":9007199254740992,\"ok\":true}"); // Nearest double
+    EXPECT_EQ(request("{\"id\":0.1,\"op\":\"ping\"}").get("id")->number, 0.1);
+
+    ASSERT_TRUE(succeeded(request("{\"op\":\"edit\"," + form + ",\"key\":1,\"data\":{\"qty\":4}}")));
+    JsonValue fetched = request("{\"op\":\"get\"," + form + ",\"key\":1}");
+    ASSERT_TRUE(succeeded(fetched));
+    const JsonValue* entry = fetched.get("entry");
+    ASSERT_TRUE(entry && entry->isObject());
+    EXPECT_EQ(request("{\"op\":\"count\"," + form + "}").get("total")->number, 1);
+
+    // Numbers that do not fit the field or key are rejected, never cast
+    EXPECT_FALSE(succeeded(request("{\"op\":\"get\"," + form + ",\"key\":-5e12}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"get\"," + form + ",\"key\":1.5}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"get\"," + form + ",\"key\":1e999}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"add\"," + form + ",\"data\":{\"qty\":3e9}}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"add\"," + form + ",\"data\":{\"due\":1e30}}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"add\"," + form + ",\"data\":{\"status\":4294967298}}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"add\",")));
+    EXPECT_EQ(request("{\"op\":\"count\"," + form + "}").get("total")->number, 1);
+
+    // Exports stay inside the export directory and finish in the background
+    EXPECT_FALSE(succeeded(request("{\"op\":\"export\"," + form + ",\"format\":\"csv\",\"path\":\"../escape.csv\"}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"export\"," + form + ",\"format\":\"csv\",\"path\":\"/tmp/escape.csv\"}")));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"export\"," + form + ",\"format\":\"xls\"}")));
+    JsonValue started = request("{\"op\":\"export\"," + form + ",\"format\":\"json\",\"path\":\"service_mode_test.json\"}");
+    ASSERT_TRUE(succeeded(started));
+    std::string path = started.get("path")->string;
+    EXPECT_EQ(path.rfind("Forms/exports/service_mode_test.json", 0), 0u);
+    waitForServiceExports();
+    EXPECT_TRUE(std::filesystem::exists(path));
+    EXPECT_FALSE(succeeded(request("{\"op\":\"export_status\",\"job\":" + std::to_string((int)started.get("job")->number) + "}"))); // Already joined
+
+    JsonValue job = request("{\"op\":\"export\"," + form + ",\"format\":\"csv\",\"path\":\"service_mode_test.csv\"}");
+    ASSERT_TRUE(succeeded(job));
+    std::string status = "{\"op\":\"export_status\",\"job\":" + std::to_string((int)job.get("job")->number) + "}";
+    JsonValue polled;
+    do {
+        polled = request(status);
+        ASSERT_TRUE(succeeded(polled));
+    } while (!polled.get("done")->boolean);
+    EXPECT_TRUE(std::filesystem::exists(polled.get("path")->string));
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(polled.get("path")->string);
+    std::filesystem::remove(std::string("Forms/") + kFormName + ".form");
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}
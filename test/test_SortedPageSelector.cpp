@@ -0,0 +1,32 @@
+#include "gtest/gtest.h"
+#include "SortedPageSelector.h"
+#include "Entry.h"
+#include <vector>
+
+TEST(SortedPageSelectorTest, PagesMatchFullSort) {
+    std::vector<Entry> rows;
+    std::vector<int> values = {5, 3, 9, 1, 3, 7, 2, 8, 6, 4, 0};
+    for (size_t i = 0; i < values.size(); ++i) {
+        rows.emplace_back((int)i + 1);
+        rows.back().data["value"] = values[i];
+    }
+    rows.emplace_back((int)values.size() + 1); // No value, sorts last
+    auto snapshot = EntrySnapshot::fromEntries(std::move(rows), 0);
+
+    SortedPageSelector selector;
+    selector.setOrder(snapshot, "value", true);
+    std::vector<size_t> order;
+    for (size_t start : {8, 4, 0}) { // Pages out of order reuse the partially ordered keys
+        selector.selectRange(start, start + 4, order);
+    }
+
+    std::vector<int> keys;
+    for (size_t row : order) {
+        keys.push_back((*snapshot)[row].key);
+    }
+    // Descending by value, ties (the two 3s) by position, missing value last; pages 3, 2, 1
+    std::vector<int> expected = {7, 4, 11, 12, 1, 10, 2, 5, 3, 8, 6, 9};
+    EXPECT_EQ(keys, expected);
+    EXPECT_EQ(selector.positionOfKey(3), 0);
+    EXPECT_EQ(selector.positionOfKey(12), 11);
+}
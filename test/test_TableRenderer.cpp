@@ -0,0 +1,112 @@
+#include "gtest/gtest.h"
+#include "TableRenderer.h"
+#include "Entry.h"
+#include <sstream>
+#include <iostream>
+#include <cctype> // For std::isdigit
+
+namespace {
+
+std::shared_ptr<FormDefinition> makeForm() {
+    std::istringstream formText("string:title\nnumber:qty:int\n");
+    return FormDefinition::loadFromStream(formText, "table_renderer_test");
+}
+
+EntrySnapshotPtr makeSnapshot(int count) {
+    std::vector<Entry> rows;
+    for (int key = 1; key <= count; ++key) {
+        rows.emplace_back(key);
+        rows.back().data["title"] = std::string("row ") + std::to_string(key);
+        rows.back().data["qty"] = key * 10;
+    }
+    return EntrySnapshot::fromEntries(std::move(rows), 0);
+}
+
+// Table lines of a rendered page: header, separator and one line per row
+std::vector<std::string> tableLines(const std::string& page) {
+    std::vector<std::string> lines;
+    std::istringstream in(page);
+    std::string line;
+    while (std::getline(in, line)) {
+        bool separator = !line.empty() && line.find_first_not_of('-') == std::string::npos;
+        if (line.rfind("KEY", 0) == 0 || separator || (!line.empty() && std::isdigit(static_cast<unsigned char>(line[0])))) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(TableRendererTest, PagesRowsAndShowsNavigationOnlyWithSeveralPages) {
+    TableRenderer renderer(makeForm());
+    renderer.setSnapshot(makeSnapshot(7));
+    EXPECT_EQ(renderer.totalPages(5), 2);
+    EXPECT_EQ(renderer.pageOfKey(6, 5), 2);
+    EXPECT_EQ(renderer.pageOfKey(8, 5), 0);
+
+    std::string first;
+    renderer.renderPage(first, 1, 5);
+    EXPECT_NE(first.find("(Page 1/2)"), std::string::npos);
+    EXPECT_NE(first.find("Next >"), std::string::npos);
+    EXPECT_EQ(first.find("< Previous"), std::string::npos);
+    std::vector<std::string> lines = tableLines(first);
+    ASSERT_EQ(lines.size(), 7u); // Header, separator and five rows
+    for (const auto& line : lines) {
+        EXPECT_EQ(line.size(), lines[0].size()) << line; // Every column is padded to the same width
+    }
+
+    std::string last;
+    renderer.renderPage(last, 9, 5); // Clamped to the last page
+    EXPECT_NE(last.find("(Page 2/2)"), std::string::npos);
+    EXPECT_NE(last.find("< Previous"), std::string::npos);
+    EXPECT_EQ(tableLines(last).size(), 4u);
+
+    std::string single;
+    renderer.renderPage(single, 1, 10);
+    EXPECT_NE(single.find("(Page 1/1)"), std::string::npos);
+    EXPECT_EQ(single.find("Page Navigation"), std::string::npos);
+
+    renderer.setSortOrder("qty", true);
+    std::string sorted;
+    renderer.renderPage(sorted, 1, 5);
+    EXPECT_NE(sorted.find("sorted by qty (descending)"), std::string::npos);
+    EXPECT_EQ(tableLines(sorted)[2].rfind("7 ", 0), 0u);
+}
+
+TEST(TableRendererTest, LayoutTruncatesWiderCellsWithAnEllipsis) {
+    const char* titles[] = {"short", "a title far wider than its column", "\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9\xC3\xA9"};
+    std::vector<Entry> rows;
+    for (int key = 1; key <= 3; ++key) {
+        rows.emplace_back(key);
+        rows.back().data["title"] = std::string(titles[key - 1]);
+    }
+    TableRenderer renderer(makeForm());
+    renderer.setSnapshot(EntrySnapshot::fromEntries(std::move(rows), 0));
+    renderer.setColumnLayout({5, 10, 3});
+
+    std::string page;
+    renderer.renderPage(page, 1, 5);
+    std::vector<std::string> lines = tableLines(page);
+    ASSERT_EQ(lines.size(), 5u);
+    for (const auto& line : lines) {
+        EXPECT_EQ(line.size(), lines[0].size()) << line;
+    }
+    EXPECT_NE(lines[2].find("short "), std::string::npos);
+    EXPECT_NE(lines[3].find("a title..."), std::string::npos);
+    EXPECT_NE(lines[4].find("\xC3\xA9\xC3\xA9\xC3\xA9... "), std::string::npos); // Cut on a character boundary
+}
+
+TEST(TableRendererTest, WritePageGoesThroughStdCout) {
+    TableRenderer renderer(makeForm());
+    renderer.setSnapshot(makeSnapshot(3));
+    std::string expected;
+    renderer.renderPage(expected, 1, 5);
+
+    std::ostringstream captured;
+    std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+    std::cout << "before\n";
+    renderer.writePage(1, 5);
+    std::cout.rdbuf(original);
+    EXPECT_EQ(captured.str(), "before\n" + expected); // Redirection works and earlier output stays first
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+#include "TimestampIndex.h"
+#include "EntryFilter.h"
+#include "Entry.h"
+#include "FormDefinition.h"
+#include <filesystem>
+#include <sstream>
+
+namespace {
+
+const char* kFormName = "timestamp_index_test";
+const int64_t kHour = 3600 * 1000;
+
+} // namespace
+
+TEST(TimestampIndexTest, IsoTextAndRangeQueries) {
+    Timestamp time;
+    ASSERT_TRUE(parseTimestamp("2024-02-29T12:30:05.250Z", time));
+    EXPECT_EQ(time.millis, 1709209805250LL);
+    EXPECT_EQ(formatTimestamp(time), "2024-02-29T12:30:05.250Z");
+    ASSERT_TRUE(parseTimestamp("2024-02-29 14:30:05.25+02:00", time));
+    EXPECT_EQ(time.millis, 1709209805250LL);
+    EXPECT_EQ(formatTimestamp(Timestamp{-1000}), "1969-12-31T23:59:59Z");
+    EXPECT_FALSE(parseTimestamp("2023-02-29", time));
+    FieldValue stored;
+    ASSERT_TRUE(parseFieldValue(FieldKind::Timestamp, "1709209805250", stored)); // Entries file form
+    EXPECT_EQ(std::get<Timestamp>(stored).millis, 1709209805250LL);
+
+    std::stringstream formText("timestamp:at\nstring:msg\n");
+    auto formDef = FormDefinition::loadFromStream(formText, kFormName);
+    ASSERT_EQ(fieldKindFor(*formDef->fields[0]), FieldKind::Timestamp);
+
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+    EntryManager manager(kFormName, formDef);
+    Timestamp start;
+    ASSERT_TRUE(parseTimestamp("2024-01-01", start));
+    std::vector<std::map<std::string, FieldValue>> rows;
+    for (int i = 0; i < 3000; ++i) {
+        rows.push_back({{"at", Timestamp{start.millis + i * kHour}}, {"msg", std::string(i % 3 ? "info" : "error")}});
+    }
+    manager.importEntries(rows);
+    auto first = manager.getTimestampIndex(manager.getEntries(), "at");
+    EXPECT_EQ(first->size(), 3000u);
+
+    // Out of order rows after an append extend the index without losing the ordering
+    manager.importEntries({{{"at", Timestamp{start.millis + 5 * kHour}}, {"msg", std::string("late")}}});
+    auto second = manager.getTimestampIndex(manager.getEntries(), "at");
+    EXPECT_EQ(second->size(), 3001u);
+    std::vector<size_t> found;
+    second->rowsInRange(Timestamp{start.millis + 5 * kHour}, Timestamp{start.millis + 6 * kHour}, found);
+    EXPECT_EQ(found, (std::vector<size_t>{5, 3000, 6}));
+
+    EntryFilter filter;
+    std::string error;
+    ASSERT_TRUE(EntryFilter::parse(*formDef, "at >= 2024-01-02 and at < 2024-01-03 and msg = error", filter, error)) << error;
+    std::vector<size_t> matches = manager.findMatchingRows(manager.getEntries(), filter);
+    ASSERT_EQ(matches.size(), 8u);
+    EXPECT_EQ(matches.front(), 24u);
+    EXPECT_EQ(matches.back(), 45u);
+
+    EntryManager reopened(kFormName, formDef); // Stored as epoch milliseconds and read back
+    EXPECT_EQ(std::get<Timestamp>((*reopened.getEntries())[3000].data.at("at")).millis, start.millis + 5 * kHour);
+    std::filesystem::remove_all(EntryManager::entriesDirectoryFor(kFormName));
+}